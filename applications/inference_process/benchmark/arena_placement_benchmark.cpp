@@ -0,0 +1,272 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2023 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Simulate the latency of a network with its tensor arena split across a fast and a slow memory region.
+ *
+ * The network is a chain of operators with random activation sizes, skip connections and scratch buffers. Every
+ * operator reads its inputs and scratch buffer a number of times, writes its output once, and takes its compute
+ * cycles plus the cycles to transfer these bytes at the bandwidth of the region holding each buffer.
+ *
+ * The single region baseline places the whole arena in the slow region, which is where an arena that does not fit
+ * in the fast region has to go. The ACCESS_FREQUENCY placement uses the operator cycles of the SIZE placement as
+ * profile, like InferenceProcess does between two jobs.
+ */
+
+#include "arena_placement.hpp"
+
+#include <algorithm>
+#include <random>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace InferenceProcess;
+
+namespace {
+
+struct Config {
+    size_t operators     = 24;
+    size_t minActivation = 4 * 1024;
+    size_t maxActivation = 96 * 1024;
+    size_t fastSize      = 128 * 1024;
+    double fastBw        = 8.0;
+    double slowBw        = 1.0;
+    unsigned int seed    = 1;
+};
+
+struct Access {
+    size_t buffer;
+    int count;
+};
+
+struct Operator {
+    double compute;
+    vector<Access> accesses;
+};
+
+struct Network {
+    vector<int> sizes;
+    vector<pair<int, int>> lifetimes;
+    vector<Operator> ops;
+};
+
+Network createNetwork(const Config &cfg) {
+    mt19937 rng(cfg.seed);
+    uniform_int_distribution<size_t> activationDist(cfg.minActivation / 16, cfg.maxActivation / 16);
+    uniform_int_distribution<size_t> scratchDist(1024 / 16, 32 * 1024 / 16);
+    uniform_int_distribution<int> reuseDist(1, 9);
+    uniform_real_distribution<double> computeDist(10000, 100000);
+    uniform_int_distribution<int> chance(0, 3);
+
+    Network net;
+    size_t skip = 0;
+
+    auto addBuffer = [&net](size_t size, int first) {
+        net.sizes.push_back(size * 16);
+        net.lifetimes.push_back({first, first});
+        return net.sizes.size() - 1;
+    };
+
+    // The network input is produced before the first operator
+    size_t input = addBuffer(activationDist(rng), 0);
+
+    for (size_t i = 0; i < cfg.operators; i++) {
+        Operator op;
+        op.compute = computeDist(rng);
+
+        // Read the previous activation, filters re-read their input
+        op.accesses.push_back({input, reuseDist(rng)});
+        net.lifetimes[input].second = i;
+
+        // Residual connection to the start of the block
+        if (i % 4 == 3) {
+            op.accesses.push_back({skip, 1});
+            net.lifetimes[skip].second = i;
+        }
+
+        // Scratch buffer streamed by the kernel
+        if (chance(rng) == 0) {
+            size_t scratch = addBuffer(scratchDist(rng), i);
+            op.accesses.push_back({scratch, reuseDist(rng)});
+        }
+
+        size_t output = addBuffer(activationDist(rng), i);
+        op.accesses.push_back({output, 1});
+
+        if (i % 4 == 0) {
+            skip = output;
+        }
+
+        input = output;
+        net.ops.push_back(op);
+    }
+
+    return net;
+}
+
+// Cycles per operator for a placement. fast holds the region of every buffer.
+vector<uint32_t> simulate(const Config &cfg, const Network &net, const vector<bool> &fast) {
+    vector<uint32_t> ticks;
+
+    for (auto &op : net.ops) {
+        double cycles = op.compute;
+
+        for (auto &access : op.accesses) {
+            cycles += static_cast<double>(net.sizes[access.buffer]) * access.count /
+                      (fast[access.buffer] ? cfg.fastBw : cfg.slowBw);
+        }
+
+        ticks.push_back(static_cast<uint32_t>(cycles));
+    }
+
+    return ticks;
+}
+
+uint64_t total(const vector<uint32_t> &ticks) {
+    uint64_t sum = 0;
+
+    for (auto t : ticks) {
+        sum += t;
+    }
+
+    return sum;
+}
+
+bool place(const Network &net, ArenaPlacement &placement, vector<bool> &fast) {
+    for (size_t i = 0; i < net.sizes.size(); i++) {
+        placement.addBuffer(net.sizes[i], net.lifetimes[i].first, net.lifetimes[i].second);
+    }
+
+    if (placement.place()) {
+        return true;
+    }
+
+    fast.clear();
+    for (auto &buffer : placement.getBuffers()) {
+        fast.push_back(buffer.fast);
+    }
+
+    return false;
+}
+
+void report(const char *name, const ArenaPlacement &placement, uint64_t cycles, uint64_t baseline) {
+    printf("%-18s fast=%7zu, slow=%7zu, spilled=%3zu/%zu, cycles=%9llu, speedup=%.2fx\n",
+           name,
+           placement.getFastUsedBytes(),
+           placement.getSlowUsedBytes(),
+           placement.getSpilledCount(),
+           placement.getBuffers().size(),
+           static_cast<unsigned long long>(cycles),
+           static_cast<double>(baseline) / cycles);
+}
+
+void usage(const char *name) {
+    printf("Usage: %s [options]\n"
+           "  --operators N        Number of operators\n"
+           "  --activation MIN MAX Activation bytes per operator\n"
+           "  --fast BYTES         Size of the fast region\n"
+           "  --fast-bw B          Fast region bandwidth in bytes per cycle\n"
+           "  --slow-bw B          Slow region bandwidth in bytes per cycle\n"
+           "  --seed N             Random seed\n",
+           name);
+}
+
+bool parse(int argc, char *argv[], Config &cfg) {
+    for (int i = 1; i < argc; i++) {
+        const string arg  = argv[i];
+        const int missing = arg == "--activation" ? 2 : 1;
+
+        if (arg == "--help" || i + missing >= argc) {
+            return true;
+        }
+
+        if (arg == "--operators") {
+            cfg.operators = strtoul(argv[++i], nullptr, 0);
+        } else if (arg == "--activation") {
+            cfg.minActivation = strtoul(argv[++i], nullptr, 0);
+            cfg.maxActivation = strtoul(argv[++i], nullptr, 0);
+        } else if (arg == "--fast") {
+            cfg.fastSize = strtoul(argv[++i], nullptr, 0);
+        } else if (arg == "--fast-bw") {
+            cfg.fastBw = strtod(argv[++i], nullptr);
+        } else if (arg == "--slow-bw") {
+            cfg.slowBw = strtod(argv[++i], nullptr);
+        } else if (arg == "--seed") {
+            cfg.seed = strtoul(argv[++i], nullptr, 0);
+        } else {
+            return true;
+        }
+    }
+
+    return cfg.operators == 0 || cfg.minActivation < 16 || cfg.minActivation > cfg.maxActivation ||
+           cfg.fastBw <= 0 || cfg.slowBw <= 0;
+}
+} // namespace
+
+int main(int argc, char *argv[]) {
+    Config cfg;
+    if (parse(argc, argv, cfg)) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    const Network net = createNetwork(cfg);
+
+    // Single region, the whole arena in the slow region
+    ArenaPlacement single(0);
+    vector<bool> fast;
+    if (place(net, single, fast)) {
+        printf("Failed to place single region arena\n");
+        return 1;
+    }
+
+    const uint64_t baseline = total(simulate(cfg, net, fast));
+
+    // Tiered by size
+    ArenaPlacement bySize(cfg.fastSize, ArenaPlacement::SIZE);
+    if (place(net, bySize, fast)) {
+        printf("Failed to place arena by size\n");
+        return 1;
+    }
+
+    const vector<uint32_t> profile = simulate(cfg, net, fast);
+
+    // Tiered by access frequency, profiled with the placement by size
+    ArenaPlacement byAccess(cfg.fastSize, ArenaPlacement::ACCESS_FREQUENCY, profile.data(), profile.size());
+    if (place(net, byAccess, fast)) {
+        printf("Failed to place arena by access frequency\n");
+        return 1;
+    }
+
+    const uint64_t accessCycles = total(simulate(cfg, net, fast));
+
+    printf("Network: operators=%zu, buffers=%zu, fast region=%zu bytes, bandwidth fast=%.1f slow=%.1f bytes/cycle\n",
+           cfg.operators,
+           net.sizes.size(),
+           cfg.fastSize,
+           cfg.fastBw,
+           cfg.slowBw);
+    report("Single region", single, baseline, baseline);
+    report("Size", bySize, total(profile), baseline);
+    report("Access frequency", byAccess, accessCycles, baseline);
+
+    return 0;
+}
@@ -0,0 +1,347 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2023 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Stress test and latency benchmark of the job queues between a producer, standing in for an interrupt handler, and
+ * the inference task, with one thread each.
+ *
+ * The stress test pushes a sequence through a small SpscQueue in random bursts, and checks that the consumer pops it
+ * in order, without loss or duplicates.
+ *
+ * The latency benchmark posts jobs at a fixed interval and measures the time from posting a job until the consumer
+ * would call runJob(). The copy queue is the approach of callers posting InferenceJob objects by value to a mutex
+ * protected queue, and waiting on a condition variable. The ring posts job handles to an SpscQueue and wakes the
+ * consumer with a counting notification, emulating the task notification of InferenceTask.
+ */
+
+#include "job_queue.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <random>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+using namespace InferenceProcess;
+
+namespace {
+
+using Clock = chrono::steady_clock;
+
+struct Config {
+    size_t jobs         = 20000;
+    size_t stress       = 10000000;
+    uint32_t intervalUs = 50;
+    uint32_t workUs     = 10;
+    size_t inputs       = 1;
+    size_t outputs      = 2;
+    unsigned int seed   = 1;
+};
+
+// Same members as InferenceJob, which is what the copy queue copies
+struct DataPtr {
+    void *data;
+    size_t size;
+};
+
+struct Job {
+    string name;
+    DataPtr networkModel;
+    vector<DataPtr> input;
+    vector<DataPtr> output;
+    vector<DataPtr> expectedOutput;
+    uint64_t cpuCycles;
+    size_t numBytesToPrint;
+    void *externalContext;
+    Clock::time_point posted;
+};
+
+// Counting notification like xTaskNotifyGive() and ulTaskNotifyTake(pdTRUE, portMAX_DELAY)
+class Notification {
+public:
+    void give() {
+        {
+            lock_guard<mutex> lock(mtx);
+            count++;
+        }
+
+        cv.notify_one();
+    }
+
+    void take() {
+        unique_lock<mutex> lock(mtx);
+        cv.wait(lock, [this] { return count > 0; });
+        count = 0;
+    }
+
+private:
+    mutex mtx;
+    condition_variable cv;
+    uint32_t count = 0;
+};
+
+class CopyQueue {
+public:
+    void post(const Job &job) {
+        {
+            lock_guard<mutex> lock(mtx);
+            jobs.push_back(job);
+        }
+
+        cv.notify_one();
+    }
+
+    Job receive() {
+        unique_lock<mutex> lock(mtx);
+        cv.wait(lock, [this] { return !jobs.empty(); });
+
+        Job job = jobs.front();
+        jobs.pop_front();
+
+        return job;
+    }
+
+private:
+    mutex mtx;
+    condition_variable cv;
+    deque<Job> jobs;
+};
+
+class RingQueue {
+public:
+    bool post(Job *job) {
+        if (ring.push(job)) {
+            return true;
+        }
+
+        notification.give();
+
+        return false;
+    }
+
+    Job *receive() {
+        Job *job;
+
+        while (ring.pop(job)) {
+            notification.take();
+        }
+
+        return job;
+    }
+
+private:
+    SpscQueue<Job *, 64> ring;
+    Notification notification;
+};
+
+void spin(uint32_t us) {
+    const auto end = Clock::now() + chrono::microseconds(us);
+    while (Clock::now() < end) {}
+}
+
+Job createJob(const Config &cfg, size_t index) {
+    static uint8_t buffer[64];
+
+    Job job;
+    job.name            = "job_" + to_string(index) + "_with_a_typical_name";
+    job.networkModel    = {buffer, sizeof(buffer)};
+    job.input           = vector<DataPtr>(cfg.inputs, DataPtr{buffer, sizeof(buffer)});
+    job.output          = vector<DataPtr>(cfg.outputs, DataPtr{buffer, sizeof(buffer)});
+    job.cpuCycles       = 0;
+    job.numBytesToPrint = 0;
+    job.externalContext = nullptr;
+
+    return job;
+}
+
+bool stress(const Config &cfg) {
+    SpscQueue<uint32_t, 8> ring;
+    atomic<bool> failed(false);
+    uint64_t full = 0;
+
+    thread consumer([&] {
+        uint32_t expected = 0;
+
+        while (expected < cfg.stress && !failed) {
+            uint32_t value;
+
+            // Let the producer run on hosts with a single core
+            if (ring.pop(value)) {
+                this_thread::yield();
+                continue;
+            }
+
+            if (value != expected || ring.size() > ring.capacity()) {
+                printf("Stress test failed: expected=%u, popped=%u\n", expected, value);
+                failed = true;
+            }
+
+            expected++;
+        }
+    });
+
+    mt19937 rng(cfg.seed);
+    uniform_int_distribution<uint32_t> burst(1, 16);
+    uint32_t value = 0;
+
+    while (value < cfg.stress && !failed) {
+        for (uint32_t n = burst(rng); n > 0 && value < cfg.stress; n--) {
+            while (ring.push(value) && !failed) {
+                full++;
+                this_thread::yield();
+            }
+
+            value++;
+        }
+    }
+
+    consumer.join();
+
+    printf("Stress test %s: values=%zu, capacity=%zu, full=%llu\n",
+           failed ? "failed" : "passed",
+           cfg.stress,
+           ring.capacity(),
+           static_cast<unsigned long long>(full));
+
+    return failed;
+}
+
+void report(const char *name, vector<double> &latency) {
+    sort(latency.begin(), latency.end());
+
+    auto percentile = [&](double p) { return latency[min(latency.size() - 1, size_t(p * latency.size()))]; };
+
+    printf("%-12s p50=%8.2f us, p90=%8.2f us, p99=%8.2f us, max=%8.2f us\n",
+           name,
+           percentile(0.5),
+           percentile(0.9),
+           percentile(0.99),
+           latency.back());
+}
+
+template <typename Post, typename Receive>
+vector<double> measure(const Config &cfg, vector<Job> &jobs, Post post, Receive receive) {
+    vector<double> latency(cfg.jobs);
+
+    thread consumer([&] {
+        for (size_t i = 0; i < cfg.jobs; i++) {
+            const Clock::time_point posted = receive();
+            latency[i] = chrono::duration<double, micro>(Clock::now() - posted).count();
+
+            // Run the job
+            spin(cfg.workUs);
+        }
+    });
+
+    for (size_t i = 0; i < cfg.jobs; i++) {
+        spin(cfg.intervalUs);
+
+        jobs[i].posted = Clock::now();
+        post(jobs[i]);
+    }
+
+    consumer.join();
+
+    return latency;
+}
+
+void usage(const char *name) {
+    printf("Usage: %s [options]\n"
+           "  --jobs N          Number of jobs posted by the latency benchmark\n"
+           "  --stress N        Number of values pushed by the stress test\n"
+           "  --interval US     Time between two jobs\n"
+           "  --work US         Time to run a job\n"
+           "  --tensors IN OUT  Number of input and output tensors of a job\n"
+           "  --seed N          Random seed\n",
+           name);
+}
+
+bool parse(int argc, char *argv[], Config &cfg) {
+    for (int i = 1; i < argc; i++) {
+        const string arg  = argv[i];
+        const int missing = arg == "--tensors" ? 2 : 1;
+
+        if (arg == "--help" || i + missing >= argc) {
+            return true;
+        }
+
+        if (arg == "--jobs") {
+            cfg.jobs = strtoul(argv[++i], nullptr, 0);
+        } else if (arg == "--stress") {
+            cfg.stress = strtoul(argv[++i], nullptr, 0);
+        } else if (arg == "--interval") {
+            cfg.intervalUs = strtoul(argv[++i], nullptr, 0);
+        } else if (arg == "--work") {
+            cfg.workUs = strtoul(argv[++i], nullptr, 0);
+        } else if (arg == "--tensors") {
+            cfg.inputs  = strtoul(argv[++i], nullptr, 0);
+            cfg.outputs = strtoul(argv[++i], nullptr, 0);
+        } else if (arg == "--seed") {
+            cfg.seed = strtoul(argv[++i], nullptr, 0);
+        } else {
+            return true;
+        }
+    }
+
+    return cfg.jobs == 0;
+}
+} // namespace
+
+int main(int argc, char *argv[]) {
+    Config cfg;
+    if (parse(argc, argv, cfg)) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    if (stress(cfg)) {
+        return 1;
+    }
+
+    vector<Job> jobs;
+    for (size_t i = 0; i < cfg.jobs; i++) {
+        jobs.push_back(createJob(cfg, i));
+    }
+
+    printf("Latency from post to runJob: jobs=%zu, interval=%u us, work=%u us\n", cfg.jobs, cfg.intervalUs, cfg.workUs);
+
+    CopyQueue copyQueue;
+    vector<double> copyLatency = measure(
+        cfg, jobs, [&](Job &job) { copyQueue.post(job); }, [&] { return copyQueue.receive().posted; });
+    report("Copy queue", copyLatency);
+
+    RingQueue ringQueue;
+    vector<double> ringLatency = measure(
+        cfg,
+        jobs,
+        [&](Job &job) {
+            while (ringQueue.post(&job)) {}
+        },
+        [&] { return ringQueue.receive()->posted; });
+    report("SPSC ring", ringLatency);
+
+    return 0;
+}
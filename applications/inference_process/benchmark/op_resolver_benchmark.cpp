@@ -0,0 +1,288 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2023 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Measure the time spent resolving the operators of a model when an interpreter is initialized.
+ *
+ * The baseline is the all operators resolver, a MicroMutableOpResolver that get_resolver() creates for every job.
+ * Registering the operators scans the operators already registered for duplicates, and every operator of the model
+ * is then found by a linear search of the registrations. The hashed resolver is built once and resolves every
+ * operator with a table lookup or a perfect hash.
+ *
+ * LinearOpResolver mirrors the registration and lookup of MicroMutableOpResolver, without the kernels.
+ */
+
+#include "hashed_op_resolver.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace InferenceProcess;
+
+namespace {
+
+constexpr size_t NumBuiltins = 94;
+
+constexpr const char *customOperators[] = {"ethos-u", "CIRCULAR_BUFFER", "TFLite_Detection_PostProcess"};
+constexpr size_t NumCustom              = sizeof(customOperators) / sizeof(customOperators[0]);
+constexpr CustomOpHash<NumCustom> customOperatorHash(customOperators);
+
+constexpr size_t NumOperators = NumBuiltins + NumCustom;
+
+struct Config {
+    size_t operators  = 300;
+    double custom     = 0.05;
+    size_t iterations = 1000;
+    unsigned int seed = 1;
+};
+
+int parseNothing(const void *, void *, void **) {
+    return 0;
+}
+
+template <size_t N>
+class LinearOpResolver : public tflite::MicroOpResolver {
+public:
+    LinearOpResolver() : registrations(), builtinCodes(), builtinParsers(), numRegistrations(0), numBuiltins(0) {}
+
+    bool addBuiltin(tflite::BuiltinOperator op) {
+        if (numRegistrations >= N || FindOp(op) != nullptr) {
+            return true;
+        }
+
+        registrations[numRegistrations++] = {static_cast<int32_t>(op), nullptr};
+        builtinCodes[numBuiltins]         = op;
+        builtinParsers[numBuiltins++]     = parseNothing;
+
+        return false;
+    }
+
+    bool addCustom(const char *name) {
+        if (numRegistrations >= N || FindOp(name) != nullptr) {
+            return true;
+        }
+
+        registrations[numRegistrations++] = {tflite::BuiltinOperator_CUSTOM, name};
+
+        return false;
+    }
+
+    const tflite::TFLMRegistration *FindOp(tflite::BuiltinOperator op) const override {
+        for (size_t i = 0; i < numRegistrations; i++) {
+            if (registrations[i].builtin_code == op) {
+                return &registrations[i];
+            }
+        }
+
+        return nullptr;
+    }
+
+    const tflite::TFLMRegistration *FindOp(const char *op) const override {
+        for (size_t i = 0; i < numRegistrations; i++) {
+            if (registrations[i].builtin_code == tflite::BuiltinOperator_CUSTOM &&
+                strcmp(registrations[i].custom_name, op) == 0) {
+                return &registrations[i];
+            }
+        }
+
+        return nullptr;
+    }
+
+    tflite::TfLiteBridgeBuiltinParseFunction GetOpDataParser(tflite::BuiltinOperator op) const override {
+        for (size_t i = 0; i < numBuiltins; i++) {
+            if (builtinCodes[i] == op) {
+                return builtinParsers[i];
+            }
+        }
+
+        return nullptr;
+    }
+
+private:
+    tflite::TFLMRegistration registrations[N];
+    tflite::BuiltinOperator builtinCodes[N];
+    tflite::TfLiteBridgeBuiltinParseFunction builtinParsers[N];
+    size_t numRegistrations;
+    size_t numBuiltins;
+};
+
+using Resolver = LinearOpResolver<NumOperators>;
+
+struct Operator {
+    tflite::BuiltinOperator code;
+    const char *name;
+};
+
+// Builtin operators in registration order, which is alphabetical and unrelated to the operator codes
+vector<tflite::BuiltinOperator> createBuiltins(mt19937 &rng) {
+    vector<tflite::BuiltinOperator> builtins;
+
+    for (int i = 0; builtins.size() < NumBuiltins; i++) {
+        if (i != tflite::BuiltinOperator_CUSTOM) {
+            builtins.push_back(static_cast<tflite::BuiltinOperator>(i));
+        }
+    }
+
+    shuffle(builtins.begin(), builtins.end(), rng);
+
+    return builtins;
+}
+
+vector<Operator> createModel(const Config &cfg, const vector<tflite::BuiltinOperator> &builtins, mt19937 &rng) {
+    uniform_int_distribution<size_t> builtinDist(0, builtins.size() - 1);
+    uniform_int_distribution<size_t> customDist(0, NumCustom - 1);
+    bernoulli_distribution customChance(cfg.custom);
+    vector<Operator> model;
+
+    for (size_t i = 0; i < cfg.operators; i++) {
+        if (customChance(rng)) {
+            model.push_back({tflite::BuiltinOperator_CUSTOM, customOperators[customDist(rng)]});
+        } else {
+            model.push_back({builtins[builtinDist(rng)], nullptr});
+        }
+    }
+
+    return model;
+}
+
+void populate(Resolver &resolver, const vector<tflite::BuiltinOperator> &builtins) {
+    for (auto op : builtins) {
+        resolver.addBuiltin(op);
+    }
+
+    for (auto name : customOperators) {
+        resolver.addCustom(name);
+    }
+}
+
+// Resolve the registration and parser of every operator, like the interpreter does when it is initialized
+size_t resolve(const tflite::MicroOpResolver &resolver, const vector<Operator> &model) {
+    size_t found = 0;
+
+    for (auto &op : model) {
+        if (op.code == tflite::BuiltinOperator_CUSTOM) {
+            found += resolver.FindOp(op.name) != nullptr;
+        } else {
+            found += resolver.FindOp(op.code) != nullptr && resolver.GetOpDataParser(op.code) != nullptr;
+        }
+    }
+
+    return found;
+}
+
+double elapsed(chrono::steady_clock::time_point start) {
+    return chrono::duration<double, micro>(chrono::steady_clock::now() - start).count();
+}
+
+void usage(const char *name) {
+    printf("Usage: %s [options]\n"
+           "  --operators N        Number of operators in the model\n"
+           "  --custom F           Fraction of custom operators\n"
+           "  --iterations N       Number of initializations to average\n"
+           "  --seed N             Random seed\n",
+           name);
+}
+
+bool parse(int argc, char *argv[], Config &cfg) {
+    for (int i = 1; i < argc; i++) {
+        const string arg = argv[i];
+
+        if (arg == "--help" || i + 1 >= argc) {
+            return true;
+        }
+
+        if (arg == "--operators") {
+            cfg.operators = strtoul(argv[++i], nullptr, 0);
+        } else if (arg == "--custom") {
+            cfg.custom = strtod(argv[++i], nullptr);
+        } else if (arg == "--iterations") {
+            cfg.iterations = strtoul(argv[++i], nullptr, 0);
+        } else if (arg == "--seed") {
+            cfg.seed = strtoul(argv[++i], nullptr, 0);
+        } else {
+            return true;
+        }
+    }
+
+    return cfg.operators == 0 || cfg.iterations == 0 || cfg.custom < 0 || cfg.custom > 1;
+}
+} // namespace
+
+int main(int argc, char *argv[]) {
+    Config cfg;
+    if (parse(argc, argv, cfg)) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    mt19937 rng(cfg.seed);
+    const vector<tflite::BuiltinOperator> builtins = createBuiltins(rng);
+    const vector<Operator> model                   = createModel(cfg, builtins, rng);
+
+    // Baseline, the resolver is created and populated for every initialization
+    size_t linearFound = 0;
+    auto start         = chrono::steady_clock::now();
+
+    for (size_t i = 0; i < cfg.iterations; i++) {
+        Resolver resolver;
+        populate(resolver, builtins);
+        linearFound += resolve(resolver, model);
+    }
+
+    const double linear = elapsed(start) / cfg.iterations;
+
+    // Hashed resolver, built once and shared by every initialization
+    start = chrono::steady_clock::now();
+    const HashedOpResolver<Resolver, NumCustom> hashed([&](Resolver &r) { populate(r, builtins); },
+                                                       customOperatorHash);
+    const double build = elapsed(start);
+
+    size_t hashedFound = 0;
+    start              = chrono::steady_clock::now();
+
+    for (size_t i = 0; i < cfg.iterations; i++) {
+        hashedFound += resolve(hashed, model);
+    }
+
+    const double lookup = elapsed(start) / cfg.iterations;
+
+    if (linearFound != cfg.operators * cfg.iterations || hashedFound != linearFound) {
+        printf("Operators not resolved: linear=%zu, hashed=%zu, expected=%zu\n",
+               linearFound,
+               hashedFound,
+               cfg.operators * cfg.iterations);
+        return 1;
+    }
+
+    printf("Model: operators=%zu, custom=%.2f, registered=%zu, custom hash seed=%u\n",
+           cfg.operators,
+           cfg.custom,
+           NumOperators,
+           static_cast<unsigned int>(customOperatorHash.getSeed()));
+    printf("%-18s init=%9.2f us\n", "Linear", linear);
+    printf("%-18s init=%9.2f us, build=%.2f us once, speedup=%.2fx\n", "Hashed", lookup, build, linear / lookup);
+
+    return 0;
+}
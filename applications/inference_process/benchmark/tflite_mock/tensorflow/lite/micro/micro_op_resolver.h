@@ -0,0 +1,46 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2023 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Minimal operator resolver interface of TensorFlow Lite for Microcontrollers for host benchmarks.
+ */
+
+#pragma once
+
+#include "tensorflow/lite/schema/schema_generated.h"
+
+#include <stdint.h>
+
+namespace tflite {
+
+struct TFLMRegistration {
+    int32_t builtin_code;
+    const char *custom_name;
+};
+
+using TfLiteBridgeBuiltinParseFunction = int (*)(const void *op, void *allocator, void **builtin_data);
+
+class MicroOpResolver {
+public:
+    virtual const TFLMRegistration *FindOp(BuiltinOperator op) const             = 0;
+    virtual const TFLMRegistration *FindOp(const char *op) const                 = 0;
+    virtual TfLiteBridgeBuiltinParseFunction GetOpDataParser(BuiltinOperator op) const = 0;
+    virtual ~MicroOpResolver() {}
+};
+
+} // namespace tflite
@@ -0,0 +1,36 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2023 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Minimal schema of TensorFlow Lite for host benchmarks.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+namespace tflite {
+
+enum BuiltinOperator : int32_t {
+    BuiltinOperator_ADD    = 0,
+    BuiltinOperator_CUSTOM = 32,
+    BuiltinOperator_MIN    = BuiltinOperator_ADD,
+    BuiltinOperator_MAX    = 161
+};
+
+} // namespace tflite
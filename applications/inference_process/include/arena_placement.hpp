@@ -0,0 +1,93 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2023 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+namespace InferenceProcess {
+
+/**
+ * Place the planned buffers of a network, the non persistent tensors and the scratch buffers, in a small fast memory
+ * region and a large slow memory region.
+ *
+ * Buffers are moved to the fast region in priority order for as long as they fit. Within each region the buffers are
+ * assigned offsets greedily by size, reusing memory between buffers whose lifetimes do not overlap. Buffers with an
+ * offline planned offset always stay in the fast region.
+ *
+ * The SIZE policy prioritizes small buffers, which keeps as many buffers as possible in the fast region. The
+ * ACCESS_FREQUENCY policy prioritizes buffers by estimated accesses per byte, based on the operator ticks measured by
+ * the profiler of a previous inference. The ticks of an operator are shared between the buffers it produces or uses
+ * last in proportion to their size, and the accesses of a buffer are its share of the ticks of these operators.
+ * Without operator ticks the ACCESS_FREQUENCY policy falls back to the SIZE policy.
+ */
+class ArenaPlacement {
+public:
+    enum Policy {
+        SIZE,
+        ACCESS_FREQUENCY
+    };
+
+    struct Buffer {
+        int size;
+        int firstTimeUsed;
+        int lastTimeUsed;
+        int offlineOffset;
+        bool fast;
+        int offset;
+    };
+
+    ArenaPlacement(size_t fastSize,
+                   Policy policy                 = SIZE,
+                   const uint32_t *operatorTicks = nullptr,
+                   size_t numOperators           = 0);
+
+    void clear();
+    void addBuffer(int size, int firstTimeUsed, int lastTimeUsed, int offlineOffset = -1);
+
+    /**
+     * Place the buffers. Returns true if the offline planned buffers do not fit in the fast region.
+     */
+    bool place();
+
+    /**
+     * Estimated accesses of a buffer, as used by the ACCESS_FREQUENCY policy.
+     */
+    uint64_t getAccesses(const Buffer &buffer) const;
+
+    const std::vector<Buffer> &getBuffers() const;
+    size_t getFastUsedBytes() const;
+    size_t getSlowUsedBytes() const;
+    size_t getSpilledCount() const;
+
+private:
+    size_t planRegion(bool fast);
+
+    size_t fastSize;
+    Policy policy;
+    const uint32_t *operatorTicks;
+    size_t numOperators;
+    std::vector<Buffer> buffers;
+    std::vector<uint64_t> touchedBytes;
+    size_t fastUsed;
+    size_t slowUsed;
+};
+
+} // namespace InferenceProcess
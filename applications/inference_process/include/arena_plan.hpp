@@ -0,0 +1,107 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2023 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "tensorflow/lite/micro/memory_planner/greedy_memory_planner.h"
+#include "tensorflow/lite/micro/memory_planner/micro_memory_planner.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+namespace InferenceProcess {
+
+/**
+ * Serialized memory plan for a network model and a tensor arena.
+ *
+ * The plan holds the size, lifetime and arena offset of every buffer handed to the memory planner, which are the
+ * non persistent tensors and the scratch buffers requested by the kernels. Persistent allocations are placed
+ * deterministically at the tail of the arena and are recreated when the interpreter is constructed.
+ *
+ * A plan starts with an ArenaPlanHeader, followed by bufferCount ArenaPlanBuffer entries. All fields are 32 bit
+ * little endian and the plan must be 4 byte aligned.
+ */
+struct ArenaPlanHeader {
+    static constexpr uint32_t Magic   = 0x50415545; // "EUAP"
+    static constexpr uint32_t Version = 1;
+
+    uint32_t magic;
+    uint32_t version;
+    uint32_t modelCrc;
+    uint32_t modelSize;
+    uint32_t arenaSize;
+    uint32_t maxMemorySize;
+    uint32_t bufferCount;
+    uint32_t reserved;
+};
+
+struct ArenaPlanBuffer {
+    int32_t size;
+    int32_t firstTimeUsed;
+    int32_t lastTimeUsed;
+    int32_t offset;
+};
+
+/**
+ * Greedy memory planner recording the plan it produces.
+ */
+class ArenaPlanRecorder : public tflite::GreedyMemoryPlanner {
+public:
+    TfLiteStatus Init(unsigned char *scratchBuffer, int scratchBufferSize) override;
+    TfLiteStatus AddBuffer(int size, int firstTimeUsed, int lastTimeUsed) override;
+    TfLiteStatus AddBuffer(int size, int firstTimeUsed, int lastTimeUsed, int offlineOffset) override;
+
+    static size_t getPlanSize(size_t bufferCount);
+
+    /**
+     * Serialize the recorded plan. Returns true if the plan does not fit in the buffer.
+     */
+    bool serialize(uint32_t modelCrc, uint32_t modelSize, uint32_t arenaSize, void *plan, size_t &planSize);
+
+private:
+    std::vector<ArenaPlanBuffer> buffers;
+};
+
+/**
+ * Memory planner restoring a serialized plan instead of planning. Fails if the buffers added by the allocator do not
+ * match the buffers of the plan, for example because the kernels request different scratch buffers.
+ */
+class ArenaPlanPlanner : public tflite::MicroMemoryPlanner {
+public:
+    ArenaPlanPlanner(const void *plan);
+
+    TfLiteStatus Init(unsigned char *scratchBuffer, int scratchBufferSize) override;
+    TfLiteStatus AddBuffer(int size, int firstTimeUsed, int lastTimeUsed) override;
+    TfLiteStatus AddBuffer(int size, int firstTimeUsed, int lastTimeUsed, int offlineOffset) override;
+    size_t GetMaximumMemorySize() override;
+    int GetBufferCount() override;
+    TfLiteStatus GetOffsetForBuffer(int bufferIndex, int *offset) override;
+
+    /**
+     * Validate a plan against the model and the arena size. Returns true if the plan is invalid.
+     */
+    static bool validate(const void *plan, size_t planSize, const void *model, size_t modelSize, size_t arenaSize);
+
+private:
+    const ArenaPlanHeader *header;
+    const ArenaPlanBuffer *buffers;
+    int count;
+};
+
+} // namespace InferenceProcess
@@ -0,0 +1,130 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2023 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifndef INFERENCE_PROCESS_TELEMETRY_MAX_MODELS
+#define INFERENCE_PROCESS_TELEMETRY_MAX_MODELS 8
+#endif
+
+/**
+ * Heap usage hook, called before and after every job. Returns true if the heap usage is unknown. used is the number
+ * of allocated bytes, and freeBytes the number of free bytes held by the heap, which is a measure of its fragmentation.
+ * The weak default implementation uses mallinfo() with newlib, and reports the usage as unknown otherwise.
+ */
+extern "C" bool inference_process_get_heap_usage(size_t *used, size_t *freeBytes);
+
+namespace InferenceProcess {
+
+/**
+ * Tensor arena and heap telemetry of the jobs run by InferenceProcess.
+ *
+ * The arena usage is recorded per network model: the peak number of used bytes, split into persistent allocations,
+ * like the tensor metadata and the persistent buffers of the kernels, and non persistent allocations, the planned
+ * tensors and scratch buffers. For jobs split across a slow arena, the peak number of bytes used in the slow arena is
+ * recorded as well. The headroom is the smallest number of free arena bytes seen. A model is identified by
+ * its address, and its size and CRC-32, computed when the model is first recorded, identify it across devices. Jobs of
+ * models that do not fit in the table are counted as untracked.
+ *
+ * The heap usage is sampled before and after every job, including result cache hits.
+ */
+class ArenaTelemetry {
+public:
+    static constexpr uint32_t StatsMagic   = 0x4c455441; // "ATEL"
+    static constexpr uint32_t StatsVersion = 2;
+
+    /**
+     * Arena size and usage of a job. slowUsed is the part of the usage located in the slow arena, if any.
+     */
+    struct ArenaUsage {
+        size_t size;
+        size_t persistent;
+        size_t nonPersistent;
+        size_t slowUsed;
+    };
+
+    struct ModelStats {
+        const void *model;
+        uint32_t modelSize;
+        uint32_t modelCrc;
+        uint32_t jobs;
+        uint32_t arenaSize;
+        uint32_t lastUsed;
+        uint32_t peakUsed;
+        uint32_t peakPersistent;
+        uint32_t peakNonPersistent;
+        uint32_t peakSlowUsed;
+        uint32_t minHeadroom;
+    };
+
+    struct HeapStats {
+        uint32_t samples;
+        uint32_t used;
+        uint32_t peakUsed;
+        uint32_t free;
+        uint32_t peakFree;
+        int32_t lastDelta;
+        uint32_t grownJobs;
+    };
+
+    struct Stats {
+        uint32_t numModels;
+        uint32_t untrackedJobs;
+        HeapStats heap;
+        ModelStats models[INFERENCE_PROCESS_TELEMETRY_MAX_MODELS];
+    };
+
+    ArenaTelemetry();
+
+    void clear();
+
+    /**
+     * Record the arena usage of a job for a network model.
+     */
+    void recordArena(const void *model, size_t modelSize, const ArenaUsage &usage);
+
+    /**
+     * Record the heap usage before and after a job.
+     */
+    void recordHeap(size_t usedBefore, size_t usedAfter, size_t freeBytes);
+
+    const Stats &getStats() const;
+    const ModelStats *find(const void *model) const;
+    ModelStats *find(const void *model);
+
+    /**
+     * Print the statistics to the log.
+     */
+    static void log(const Stats &stats);
+
+    /**
+     * Serialize the statistics into a compact little endian message, for example to be sent with rpmsg_send().
+     * Returns the message size, or 0 if the buffer is too small.
+     */
+    static size_t serialize(const Stats &stats, uint8_t *buf, size_t size);
+
+    static size_t getSerializedSize(const Stats &stats);
+
+private:
+    Stats stats;
+};
+
+} // namespace InferenceProcess
@@ -0,0 +1,186 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2023 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "tensorflow/lite/micro/micro_op_resolver.h"
+#include "tensorflow/lite/schema/schema_generated.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <type_traits>
+#include <utility>
+
+namespace InferenceProcess {
+
+// Smallest power of two holding at least two slots per name
+constexpr size_t getCustomOpTableSize(size_t names) {
+    size_t size = 2;
+
+    while (size < names * 2) {
+        size *= 2;
+    }
+
+    return size;
+}
+
+/**
+ * Perfect hash of a set of custom operator names, computed at compile time.
+ *
+ * The names are hashed with FNV-1a into a table with at least twice as many slots as names, and the seed is searched
+ * for at compile time so that every name has a slot of its own. A lookup hashes the name once and confirms the match
+ * with a single string compare.
+ */
+template <size_t N>
+class CustomOpHash {
+public:
+    static constexpr size_t TableSize = getCustomOpTableSize(N);
+
+    constexpr CustomOpHash(const char *const (&_names)[N]) : names(), seed(0), slots() {
+        for (size_t i = 0; i < N; i++) {
+            names[i] = _names[i];
+        }
+
+        // Find the first seed without collisions
+        while (!place()) {
+            seed++;
+        }
+    }
+
+    /**
+     * Slot of a name, or -1 if the name is not in the set.
+     */
+    int find(const char *name) const {
+        const size_t slot = index(name, seed);
+        const int i       = slots[slot];
+
+        return i >= 0 && strcmp(names[i], name) == 0 ? static_cast<int>(slot) : -1;
+    }
+
+    const char *getName(size_t slot) const {
+        return slots[slot] >= 0 ? names[slots[slot]] : nullptr;
+    }
+
+    constexpr uint32_t getSeed() const {
+        return seed;
+    }
+
+private:
+    static constexpr size_t index(const char *name, uint32_t seed) {
+        uint32_t h = 2166136261u ^ seed;
+
+        while (*name != '\0') {
+            h ^= static_cast<uint8_t>(*name++);
+            h *= 16777619u;
+        }
+
+        return h & (TableSize - 1);
+    }
+
+    constexpr bool place() {
+        for (size_t i = 0; i < TableSize; i++) {
+            slots[i] = -1;
+        }
+
+        for (size_t i = 0; i < N; i++) {
+            const size_t slot = index(names[i], seed);
+
+            if (slots[slot] >= 0) {
+                return false;
+            }
+
+            slots[slot] = static_cast<int>(i);
+        }
+
+        return true;
+    }
+
+    const char *names[N];
+    uint32_t seed;
+    int slots[TableSize];
+};
+
+/**
+ * Operator resolver with constant time lookups, indexing the operators registered in another resolver.
+ *
+ * Builtin operators are looked up in a table indexed by BuiltinOperator, and custom operators by the perfect hash of
+ * their names. Custom operators that are not in the hash are looked up in the indexed resolver. The tables are built
+ * once by the constructor, so the resolver is meant to be created once and shared by all interpreters.
+ */
+template <typename Resolver, size_t NumCustom>
+class HashedOpResolver : public tflite::MicroOpResolver {
+public:
+    using RegistrationPtr = decltype(std::declval<const Resolver &>().FindOp(tflite::BuiltinOperator_ADD));
+    using Registration    = typename std::remove_pointer<RegistrationPtr>::type;
+    using Parser          = decltype(std::declval<const Resolver &>().GetOpDataParser(tflite::BuiltinOperator_ADD));
+
+    static constexpr size_t NumBuiltins = static_cast<size_t>(tflite::BuiltinOperator_MAX) + 1;
+
+    /**
+     * Register the operators by calling populate with the indexed resolver, and build the tables.
+     */
+    template <typename Populate>
+    HashedOpResolver(Populate populate, const CustomOpHash<NumCustom> &_hash) :
+        resolver(), hash(_hash), builtins(), parsers(), customs() {
+        populate(resolver);
+
+        for (size_t i = 0; i < NumBuiltins; i++) {
+            const auto op = static_cast<tflite::BuiltinOperator>(i);
+
+            if (op == tflite::BuiltinOperator_CUSTOM) {
+                continue;
+            }
+
+            builtins[i] = resolver.FindOp(op);
+            parsers[i]  = builtins[i] != nullptr ? resolver.GetOpDataParser(op) : nullptr;
+        }
+
+        for (size_t i = 0; i < CustomOpHash<NumCustom>::TableSize; i++) {
+            const char *name = hash.getName(i);
+            customs[i]       = name != nullptr ? resolver.FindOp(name) : nullptr;
+        }
+    }
+
+    HashedOpResolver(const HashedOpResolver &)            = delete;
+    HashedOpResolver &operator=(const HashedOpResolver &) = delete;
+
+    const Registration *FindOp(tflite::BuiltinOperator op) const override {
+        const size_t i = static_cast<size_t>(op);
+        return i < NumBuiltins ? builtins[i] : nullptr;
+    }
+
+    const Registration *FindOp(const char *op) const override {
+        const int slot = hash.find(op);
+        return slot >= 0 ? customs[slot] : resolver.FindOp(op);
+    }
+
+    Parser GetOpDataParser(tflite::BuiltinOperator op) const override {
+        const size_t i = static_cast<size_t>(op);
+        return i < NumBuiltins ? parsers[i] : nullptr;
+    }
+
+private:
+    Resolver resolver;
+    const CustomOpHash<NumCustom> &hash;
+    const Registration *builtins[NumBuiltins];
+    Parser parsers[NumBuiltins];
+    const Registration *customs[CustomOpHash<NumCustom>::TableSize];
+};
+
+} // namespace InferenceProcess
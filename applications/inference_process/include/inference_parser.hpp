@@ -20,7 +20,9 @@
 
 #include "tensorflow/lite/schema/schema_generated.h"
 
+#include <algorithm>
 #include <stdlib.h>
+#include <string.h>
 #include <string>
 
 namespace InferenceProcess {
@@ -54,8 +56,93 @@ Array<T, U> makeArray(T *const data, U &size, size_t capacity) {
     return Array<T, U>{data, size, capacity};
 }
 
+/**
+ * Compact description of a tensor as found in the model flatbuffer.
+ */
+struct TensorInfo {
+    static constexpr size_t MaxRank = 6;
+
+    tflite::TensorType type;
+    uint8_t rank;
+    bool isConstant;
+    bool isVariable;
+    bool isInput;
+    bool isOutput;
+    int32_t shape[MaxRank];
+    size_t bytes;
+
+    // Constant data in the model buffer, or nullptr for non constant tensors
+    const uint8_t *data;
+    size_t dataSize;
+
+    // Quantization parameters. For per channel quantization numChannels is larger than one and scale and zeroPoint
+    // hold the parameters of the first channel.
+    float scale;
+    int64_t zeroPoint;
+    uint32_t numChannels;
+    int32_t quantizedDimension;
+};
+
+/**
+ * Summary of one subgraph. The tensors of the subgraph are stored in ModelInfo::tensors starting at firstTensor.
+ */
+struct SubGraphInfo {
+    uint32_t firstTensor;
+    uint32_t numTensors;
+    uint32_t numOperators;
+    uint32_t numInputs;
+    uint32_t numOutputs;
+    size_t inputBytes;
+    size_t outputBytes;
+    size_t arenaLowerBound;
+};
+
+/**
+ * One entry of the operator histogram, indexed in the same order as the operator codes of the model.
+ */
+struct OperatorInfo {
+    int32_t builtinCode;
+    const char *customCode;
+    uint32_t count;
+};
+
+/**
+ * Model descriptor built by InferenceParser::parseModelInfo() in a single walk over the flatbuffer. The descriptor
+ * has a fixed size and holds no heap allocations, which makes it suitable for caching next to the model. Custom code
+ * strings point into the model buffer, which must therefore outlive the descriptor.
+ *
+ * The arena lower bound is an estimate of the smallest tensor arena the model could ever fit in. It is the largest
+ * sum of non constant tensors that must be live at the same time for a single operator, plus all variable tensors.
+ * The actual arena size required by TFLu is always larger.
+ */
+template <size_t MaxSubGraphs, size_t MaxTensors, size_t MaxOperatorCodes>
+struct ModelInfo {
+    const tflite::Model *model;
+    uint32_t numSubGraphs;
+    uint32_t numTensors;
+    uint32_t numOperatorCodes;
+    uint32_t numOperators;
+    uint32_t numEthosUOperators;
+    bool allOpsOnEthosU;
+    size_t arenaLowerBound;
+
+    SubGraphInfo subGraphs[MaxSubGraphs];
+    TensorInfo tensors[MaxTensors];
+    OperatorInfo operatorCodes[MaxOperatorCodes];
+
+    const TensorInfo *getTensor(size_t subGraph, size_t index) const {
+        if (subGraph >= numSubGraphs || index >= subGraphs[subGraph].numTensors) {
+            return nullptr;
+        }
+
+        return &tensors[subGraphs[subGraph].firstTensor + index];
+    }
+};
+
 class InferenceParser {
 public:
+    static constexpr const char *EthosUCustomCode = "ethos-u";
+
     const tflite::Model *getModel(const void *buffer, size_t size) {
         // Verify buffer
         flatbuffers::Verifier base_verifier(reinterpret_cast<const uint8_t *>(buffer), size);
@@ -103,48 +190,358 @@ public:
         return false;
     }
 
-private:
-    bool getShapeSize(const flatbuffers::Vector<int32_t> *shape, size_t &size) {
-        size = 1;
+    /**
+     * Get the input and output dimensions of a signature, in the order of the signature. The inputs and outputs of a
+     * signature belong to the subgraph of the signature, see getSignature().
+     */
+    template <typename T, typename U>
+    bool parseSignature(const void *buffer, size_t size, const char *signature, T &&ifmDims, U &&ofmDims) {
+        const tflite::Model *model = getModel(buffer, size);
+        if (model == nullptr) {
+            return true;
+        }
 
-        if (shape == nullptr) {
-            printf("Warning: nullptr shape size.\n");
+        const tflite::SignatureDef *def = getSignature(model, signature);
+        if (def == nullptr) {
+            printf("Warning: signature not found. signature=%s\n", signature);
             return true;
         }
 
-        if (shape->size() == 0) {
-            printf("Warning: shape zero size.\n");
+        auto *subgraph = model->subgraphs()->Get(def->subgraph_index());
+        bool failed    = getSignatureDims(subgraph, def->inputs(), ifmDims);
+        if (failed) {
             return true;
         }
 
-        for (auto it = shape->begin(); it != shape->end(); ++it) {
-            size *= *it;
+        failed = getSignatureDims(subgraph, def->outputs(), ofmDims);
+        if (failed) {
+            return true;
         }
 
         return false;
     }
 
-    bool getTensorTypeSize(const enum tflite::TensorType type, size_t &size) {
+    /**
+     * Look up a signature by its key. Returns nullptr if the model has no such signature, or if the subgraph index of
+     * the signature is out of range.
+     */
+    static const tflite::SignatureDef *getSignature(const tflite::Model *model, const char *key) {
+        auto signatures = model->signature_defs();
+        if (signatures == nullptr || key == nullptr) {
+            return nullptr;
+        }
+
+        for (auto signature : *signatures) {
+            if (signature->signature_key() != nullptr && strcmp(signature->signature_key()->c_str(), key) == 0) {
+                return signature->subgraph_index() < model->subgraphs()->size() ? signature : nullptr;
+            }
+        }
+
+        return nullptr;
+    }
+
+    template <size_t MaxSubGraphs, size_t MaxTensors, size_t MaxOperatorCodes>
+    bool parseModelInfo(const void *buffer, size_t size, ModelInfo<MaxSubGraphs, MaxTensors, MaxOperatorCodes> &info) {
+        const tflite::Model *model = getModel(buffer, size);
+        if (model == nullptr) {
+            return true;
+        }
+
+        return parseModelInfo(model, info);
+    }
+
+    template <size_t MaxSubGraphs, size_t MaxTensors, size_t MaxOperatorCodes>
+    bool parseModelInfo(const tflite::Model *model, ModelInfo<MaxSubGraphs, MaxTensors, MaxOperatorCodes> &info) {
+        info.model              = model;
+        info.numSubGraphs       = 0;
+        info.numTensors         = 0;
+        info.numOperatorCodes   = 0;
+        info.numOperators       = 0;
+        info.numEthosUOperators = 0;
+        info.arenaLowerBound    = 0;
+
+        if (model == nullptr || model->subgraphs() == nullptr) {
+            printf("Warning: nullptr subgraph\n");
+            return true;
+        }
+
+        // Operator histogram, indexed like the operator codes of the model
+        auto opcodes = model->operator_codes();
+        if (opcodes != nullptr) {
+            if (opcodes->size() > MaxOperatorCodes) {
+                printf("Warning: number of operator codes is larger than capacity. codes=%u, capacity=%zu\n",
+                       opcodes->size(),
+                       MaxOperatorCodes);
+                return true;
+            }
+
+            for (auto opcode : *opcodes) {
+                OperatorInfo &op = info.operatorCodes[info.numOperatorCodes++];
+                op.builtinCode   = getBuiltinCode(opcode);
+                op.customCode    = opcode->custom_code() != nullptr ? opcode->custom_code()->c_str() : nullptr;
+                op.count         = 0;
+            }
+        }
+
+        if (model->subgraphs()->size() > MaxSubGraphs) {
+            printf("Warning: number of subgraphs is larger than capacity. subgraphs=%u, capacity=%zu\n",
+                   model->subgraphs()->size(),
+                   MaxSubGraphs);
+            return true;
+        }
+
+        size_t maxLiveBytes  = 0;
+        size_t variableBytes = 0;
+
+        for (auto subgraph : *model->subgraphs()) {
+            SubGraphInfo &sg = info.subGraphs[info.numSubGraphs++];
+            sg               = SubGraphInfo{};
+            sg.firstTensor   = info.numTensors;
+
+            // Tensors
+            auto tensors = subgraph->tensors();
+            if (tensors != nullptr) {
+                if (tensors->size() > MaxTensors - info.numTensors) {
+                    printf("Warning: number of tensors is larger than capacity. capacity=%zu\n", MaxTensors);
+                    return true;
+                }
+
+                for (auto tensor : *tensors) {
+                    getTensorInfo(model, tensor, info.tensors[info.numTensors++]);
+                }
+
+                sg.numTensors = tensors->size();
+            }
+
+            TensorInfo *sgTensors = &info.tensors[sg.firstTensor];
+
+            bool failed = markSubGraphTensors(
+                subgraph->inputs(), sgTensors, sg.numTensors, &TensorInfo::isInput, sg.numInputs, sg.inputBytes);
+            if (failed) {
+                return true;
+            }
+
+            failed = markSubGraphTensors(
+                subgraph->outputs(), sgTensors, sg.numTensors, &TensorInfo::isOutput, sg.numOutputs, sg.outputBytes);
+            if (failed) {
+                return true;
+            }
+
+            // Operators
+            size_t sgMaxLiveBytes = sg.inputBytes + sg.outputBytes;
+            auto operators        = subgraph->operators();
+            if (operators != nullptr) {
+                for (auto op : *operators) {
+                    if (op->opcode_index() >= info.numOperatorCodes) {
+                        printf("Warning: operator code index out of range. index=%u\n", op->opcode_index());
+                        return true;
+                    }
+
+                    OperatorInfo &opcode = info.operatorCodes[op->opcode_index()];
+                    opcode.count++;
+
+                    if (opcode.customCode != nullptr && strcmp(opcode.customCode, EthosUCustomCode) == 0) {
+                        info.numEthosUOperators++;
+                    }
+
+                    const size_t liveBytes = getLiveBytes(op->inputs(), sgTensors, sg.numTensors) +
+                                             getLiveBytes(op->outputs(), sgTensors, sg.numTensors);
+                    sgMaxLiveBytes         = std::max(sgMaxLiveBytes, liveBytes);
+                }
+
+                sg.numOperators = operators->size();
+                info.numOperators += operators->size();
+            }
+
+            size_t sgVariableBytes = 0;
+            for (size_t i = 0; i < sg.numTensors; ++i) {
+                if (sgTensors[i].isVariable) {
+                    sgVariableBytes += sgTensors[i].bytes;
+                }
+            }
+
+            sg.arenaLowerBound = sgMaxLiveBytes + sgVariableBytes;
+            maxLiveBytes       = std::max(maxLiveBytes, sgMaxLiveBytes);
+            variableBytes += sgVariableBytes;
+        }
+
+        info.allOpsOnEthosU  = info.numOperators > 0 && info.numOperators == info.numEthosUOperators;
+        info.arenaLowerBound = maxLiveBytes + variableBytes;
+
+        return false;
+    }
+
+    size_t getOperatorCount(const tflite::Model *model, int32_t builtinCode) {
+        size_t count = 0;
+
+        for (auto subgraph : *model->subgraphs()) {
+            if (subgraph->operators() == nullptr) {
+                continue;
+            }
+
+            for (auto op : *subgraph->operators()) {
+                if (getBuiltinCode(model->operator_codes()->Get(op->opcode_index())) == builtinCode) {
+                    count++;
+                }
+            }
+        }
+
+        return count;
+    }
+
+    static bool getTensorBytes(const enum tflite::TensorType type, size_t elements, size_t &size) {
         switch (type) {
+        case tflite::TensorType::TensorType_INT4:
+            size = (elements + 1) / 2;
+            break;
+        case tflite::TensorType::TensorType_BOOL:
         case tflite::TensorType::TensorType_UINT8:
         case tflite::TensorType::TensorType_INT8:
-            size = 1;
+            size = elements;
             break;
         case tflite::TensorType::TensorType_INT16:
-            size = 2;
+        case tflite::TensorType::TensorType_UINT16:
+        case tflite::TensorType::TensorType_FLOAT16:
+            size = elements * 2;
             break;
         case tflite::TensorType::TensorType_INT32:
+        case tflite::TensorType::TensorType_UINT32:
         case tflite::TensorType::TensorType_FLOAT32:
-            size = 4;
+            size = elements * 4;
+            break;
+        case tflite::TensorType::TensorType_INT64:
+        case tflite::TensorType::TensorType_UINT64:
+        case tflite::TensorType::TensorType_FLOAT64:
+        case tflite::TensorType::TensorType_COMPLEX64:
+            size = elements * 8;
+            break;
+        case tflite::TensorType::TensorType_COMPLEX128:
+            size = elements * 16;
             break;
         default:
-            printf("Warning: Unsupported tensor type\n");
+            size = 0;
+            return true;
+        }
+
+        return false;
+    }
+
+    static int32_t getBuiltinCode(const tflite::OperatorCode *opcode) {
+        // The builtin code was extended from int8 to int32. Older models only set the deprecated field.
+        return std::max(static_cast<int32_t>(opcode->builtin_code()),
+                        static_cast<int32_t>(opcode->deprecated_builtin_code()));
+    }
+
+private:
+    bool getShapeSize(const flatbuffers::Vector<int32_t> *shape, size_t &size) {
+        size = 1;
+
+        if (shape == nullptr) {
+            printf("Warning: nullptr shape size.\n");
             return true;
         }
 
+        if (shape->size() == 0) {
+            printf("Warning: shape zero size.\n");
+            return true;
+        }
+
+        for (auto it = shape->begin(); it != shape->end(); ++it) {
+            size *= *it;
+        }
+
         return false;
     }
 
+    void getTensorInfo(const tflite::Model *model, const tflite::Tensor *tensor, TensorInfo &info) {
+        info            = TensorInfo{};
+        info.type       = tensor->type();
+        info.isVariable = tensor->is_variable();
+
+        // Tensors referencing a non empty buffer hold constant data, typically weights and biases
+        auto buffers = model->buffers();
+        if (buffers != nullptr && tensor->buffer() > 0 && tensor->buffer() < buffers->size()) {
+            auto data       = buffers->Get(tensor->buffer())->data();
+            info.isConstant = data != nullptr && data->size() > 0;
+
+            if (info.isConstant) {
+                info.data     = data->data();
+                info.dataSize = data->size();
+            }
+        }
+
+        size_t elements = 1;
+        auto shape      = tensor->shape();
+        if (shape != nullptr) {
+            info.rank = std::min(shape->size(), static_cast<flatbuffers::uoffset_t>(TensorInfo::MaxRank));
+
+            for (size_t i = 0; i < shape->size(); ++i) {
+                const int32_t dim = shape->Get(i);
+                elements *= dim > 0 ? dim : 0;
+
+                if (i < TensorInfo::MaxRank) {
+                    info.shape[i] = dim;
+                }
+            }
+        }
+
+        // Unsupported types like strings and resources are reported with zero bytes
+        getTensorBytes(info.type, elements, info.bytes);
+
+        auto quantization = tensor->quantization();
+        if (quantization != nullptr && quantization->scale() != nullptr && quantization->scale()->size() > 0) {
+            info.scale              = quantization->scale()->Get(0);
+            info.numChannels        = quantization->scale()->size();
+            info.quantizedDimension = quantization->quantized_dimension();
+
+            if (quantization->zero_point() != nullptr && quantization->zero_point()->size() > 0) {
+                info.zeroPoint = quantization->zero_point()->Get(0);
+            }
+        }
+    }
+
+    bool markSubGraphTensors(const flatbuffers::Vector<int32_t> *tensorMap,
+                             TensorInfo *tensors,
+                             size_t numTensors,
+                             bool TensorInfo::*flag,
+                             uint32_t &count,
+                             size_t &bytes) {
+        if (tensorMap == nullptr) {
+            return false;
+        }
+
+        for (auto index : *tensorMap) {
+            if (index < 0 || static_cast<size_t>(index) >= numTensors) {
+                printf("Warning: subgraph tensor index out of range. index=%d\n", index);
+                return true;
+            }
+
+            tensors[index].*flag = true;
+            bytes += tensors[index].bytes;
+            count++;
+        }
+
+        return false;
+    }
+
+    size_t getLiveBytes(const flatbuffers::Vector<int32_t> *tensorMap, const TensorInfo *tensors, size_t numTensors) {
+        size_t bytes = 0;
+
+        if (tensorMap == nullptr) {
+            return 0;
+        }
+
+        // Optional tensors are encoded with index -1
+        for (auto index : *tensorMap) {
+            if (index >= 0 && static_cast<size_t>(index) < numTensors && !tensors[index].isConstant &&
+                !tensors[index].isVariable) {
+                bytes += tensors[index].bytes;
+            }
+        }
+
+        return bytes;
+    }
+
     template <typename T>
     bool getSubGraphDims(const tflite::SubGraph *subgraph, const flatbuffers::Vector<int32_t> *tensorMap, T &dims) {
         if (subgraph == nullptr || tensorMap == nullptr) {
@@ -158,25 +555,63 @@ private:
         }
 
         for (auto index = tensorMap->begin(); index != tensorMap->end(); ++index) {
-            auto tensor = subgraph->tensors()->Get(*index);
-            size_t size;
-            size_t tensorSize;
-
-            bool failed = getShapeSize(tensor->shape(), size);
+            bool failed = getTensorDims(subgraph, *index, dims);
             if (failed) {
                 return true;
             }
+        }
+
+        return false;
+    }
+
+    template <typename T>
+    bool getSignatureDims(const tflite::SubGraph *subgraph,
+                          const flatbuffers::Vector<flatbuffers::Offset<tflite::TensorMap>> *tensorMap,
+                          T &dims) {
+        if (subgraph == nullptr || tensorMap == nullptr) {
+            printf("Warning: nullptr subgraph or tensormap.\n");
+            return true;
+        }
 
-            failed = getTensorTypeSize(tensor->type(), tensorSize);
+        if ((dims.capacity() - dims.size()) < tensorMap->size()) {
+            printf("Warning: tensormap size is larger than dimension capacity.\n");
+            return true;
+        }
+
+        for (auto entry : *tensorMap) {
+            bool failed = getTensorDims(subgraph, entry->tensor_index(), dims);
             if (failed) {
                 return true;
             }
+        }
 
-            size *= tensorSize;
+        return false;
+    }
 
-            if (size > 0) {
-                dims.push_back(size);
-            }
+    template <typename T>
+    bool getTensorDims(const tflite::SubGraph *subgraph, uint32_t index, T &dims) {
+        if (subgraph->tensors() == nullptr || index >= subgraph->tensors()->size()) {
+            printf("Warning: tensor index out of range. index=%u\n", static_cast<unsigned>(index));
+            return true;
+        }
+
+        auto tensor = subgraph->tensors()->Get(index);
+        size_t elements;
+        size_t size;
+
+        bool failed = getShapeSize(tensor->shape(), elements);
+        if (failed) {
+            return true;
+        }
+
+        failed = getTensorBytes(tensor->type(), elements, size);
+        if (failed) {
+            printf("Warning: Unsupported tensor type\n");
+            return true;
+        }
+
+        if (size > 0) {
+            dims.push_back(size);
         }
 
         return false;
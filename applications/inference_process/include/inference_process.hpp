@@ -18,9 +18,17 @@
 
 #pragma once
 
+#include "arena_placement.hpp"
+#include "arena_telemetry.hpp"
+#include "arm_profiler.hpp"
 #include "inference_parser.hpp"
+#include "input_transform.hpp"
+#include "model_view.hpp"
+#include "result_cache.hpp"
 
 #include <array>
+#include <atomic>
+#include <memory>
 #include <queue>
 #include <stdlib.h>
 #include <string>
@@ -28,10 +36,21 @@
 
 struct TfLiteTensor;
 
+#ifndef INFERENCE_PROCESS_PROFILER_MAX_EVENTS
+#define INFERENCE_PROCESS_PROFILER_MAX_EVENTS 200
+#endif
+
+#ifndef INFERENCE_PROCESS_PROFILER_POOL_SIZE
+#define INFERENCE_PROCESS_PROFILER_POOL_SIZE 2
+#endif
+
 namespace tflite {
 // Forward declarations
 class MicroInterpreter;
+class MicroOpResolver;
 class MicroResourceVariables;
+class SingleArenaBufferAllocator;
+struct Model;
 } // namespace tflite
 
 namespace InferenceProcess {
@@ -48,6 +67,17 @@ struct DataPtr {
     char *end() const;
 };
 
+/**
+ * Inference job. A job runs the first subgraph of the network model, unless it selects a signature by key or
+ * another subgraph by index. Only the operators needed for the outputs of the selected signature or subgraph are run,
+ * see ModelView. The inputs and outputs of the job are then those of the signature, in the order of the signature.
+ * The selection is made in a copy of the network model at the start of the tensor arena, which must therefore hold
+ * the model as well, see the PARTIAL_JOBS option of ethosu_add_model(). Consecutive partial jobs with the same
+ * selection reuse the copy.
+ *
+ * An input with an InputTransform at the same index is preprocessed while copied to the input tensor, see
+ * transformInput(). Inputs without a transform, or with a COPY transform, must match the size of the tensor.
+ */
 struct InferenceJob {
     std::string name;
     DataPtr networkModel;
@@ -55,8 +85,13 @@ struct InferenceJob {
     std::vector<DataPtr> output;
     std::vector<DataPtr> expectedOutput;
     uint64_t cpuCycles{0};
+    // Bytes copied between the job buffers and the tensor arena by the last run
+    size_t bytesCopied{0};
     size_t numBytesToPrint;
     void *externalContext;
+    std::string signature;
+    size_t subgraph{0};
+    std::vector<InputTransform> inputTransform;
 
     InferenceJob();
     InferenceJob(const std::string &name,
@@ -69,24 +104,248 @@ struct InferenceJob {
 
     void invalidate();
     void clean();
+
+    // True if the job selects a signature, or a subgraph other than the first
+    bool isPartial() const;
+};
+
+/**
+ * One model in a cascaded pipeline. All interpreters of a pipeline are alive at the same time, so every stage
+ * needs its own tensor arena.
+ *
+ * The output tensors of a stage are handed over to the input tensors of the next stage directly from arena to arena.
+ * Without a glue function the shapes and types must match. A glue function, for example cropTensor() or
+ * requantizeTensor(), is applied to each output and input tensor pair instead of the plain copy.
+ */
+struct PipelineStage {
+    using Glue = bool (*)(const TfLiteTensor &output, TfLiteTensor &input, void *context);
+
+    DataPtr networkModel;
+    DataPtr tensorArena;
+    Glue glue;
+    void *glueContext;
+
+    PipelineStage(const DataPtr &networkModel = DataPtr(),
+                  const DataPtr &tensorArena  = DataPtr(),
+                  Glue glue                   = nullptr,
+                  void *glueContext           = nullptr);
+};
+
+/**
+ * Glue context for cropTensor(). The crop size is given by the height and width of the input tensor.
+ */
+struct CropWindow {
+    int32_t top;
+    int32_t left;
+};
+
+// Crop a NHWC tensor at the CropWindow passed as context
+bool cropTensor(const TfLiteTensor &output, TfLiteTensor &input, void *context);
+
+// Requantize between int8 and uint8 tensors using the quantization parameters of the tensors
+bool requantizeTensor(const TfLiteTensor &output, TfLiteTensor &input, void *context);
+
+/**
+ * Statically sized profilers reused between jobs. A job, an open session and every pipeline stage hold one profiler
+ * while running. Stages that find the pool empty run without profiling.
+ */
+using ProfilerPool =
+    tflite::ArmProfilerPool<INFERENCE_PROCESS_PROFILER_MAX_EVENTS, INFERENCE_PROCESS_PROFILER_POOL_SIZE>;
+
+/**
+ * Statistics of the model slots. Cycles are measured with the TFLM time ticks.
+ */
+struct ModelSwapStats {
+    uint32_t swaps;
+    uint32_t prepareCycles;
+    uint32_t swapCycles;
+    uint32_t waitedJobs;
+    uint32_t totalWaitedJobs;
 };
 
 class InferenceProcess {
 public:
     InferenceProcess(uint8_t *_tensorArena, size_t _tensorArenaSize);
+    virtual ~InferenceProcess();
 
     virtual bool runJob(InferenceJob &job);
 
+    /**
+     * Run a cascade of models as one unit. The job input is copied to the first stage, the job output is copied
+     * from the last stage and the network model of the job is ignored. job.cpuCycles holds the sum over all stages.
+     * The interpreters of the stages are created in storage kept between runs, which is only reallocated when a
+     * pipeline has more stages than any earlier one.
+     */
+    bool runPipeline(InferenceJob &job, std::vector<PipelineStage> &stages);
+
+    /**
+     * Capture the memory plan of a network model for the tensor arena, and print it base64 encoded to the log. On
+     * input planSize holds the size of the plan buffer, on output the size of the plan.
+     */
+    bool captureArenaPlan(const DataPtr &networkModel, void *plan, size_t &planSize);
+
+    /**
+     * Restore a captured memory plan instead of planning when running jobs for the network model. The plan is
+     * validated against the CRC of the model and the size of the tensor arena once, when it is set, and is then
+     * reused for jobs with the same model buffer and size. A model changed in place must be dropped with
+     * invalidateModel(), which also removes the plan. A job falls back to planning if the plan does not match the
+     * buffers requested by the kernels. Partial jobs always plan. An empty plan removes the plan.
+     */
+    bool setArenaPlan(const DataPtr &networkModel, const DataPtr &plan);
+
+    /**
+     * Split the memory of jobs across the tensor arena, which is then the fast region, and a slow arena. Persistent
+     * allocations go to the slow arena, and the planned buffers are placed in the fast region in the priority order
+     * of the policy, spilling the rest to the slow arena. The ACCESS_FREQUENCY policy uses the operator ticks
+     * profiled by the previous job for the same network model, unless either job is partial. A restored arena plan
+     * takes precedence, and sessions and pipelines use the tensor arena only. An empty slow arena removes the split.
+     */
+    bool setSlowArena(const DataPtr &slowArena, ArenaPlacement::Policy policy = ArenaPlacement::ACCESS_FREQUENCY);
+
+    /**
+     * Cache job outputs, and return the cached outputs instead of running jobs with the same network model and
+     * inputs, see ResultCache. Jobs with expected output, partial jobs and jobs for an open session are always run.
+     * Zero entries disables the cache.
+     */
+    void setResultCache(size_t maxEntries,
+                        size_t maxBytes,
+                        ResultCache::Eviction eviction = ResultCache::LRU,
+                        uint8_t ignoreBits             = 0);
+    const ResultCache::Stats &getResultCacheStats() const;
+
+    /**
+     * Drop the cached results of a network model, or drop all cached results.
+     */
+    void invalidateResultCache(const DataPtr &networkModel);
+    void clearResultCache();
+
+    /**
+     * Drop everything cached for a network model, the cached results, the narrowed copy reused by partial jobs and
+     * the arena plan. Must be done when the model is changed in place.
+     */
+    void invalidateModel(const DataPtr &networkModel);
+
+    /**
+     * Size of the tensor arena, and number of arena bytes used by the last job. For a job split across a slow arena,
+     * getArenaUsedBytes() counts the fast region only.
+     */
+    size_t getArenaSize() const;
+    size_t getArenaUsedBytes() const;
+    size_t getSlowArenaUsedBytes() const;
+
+    /**
+     * Arena usage per network model and heap usage around runJob(), see ArenaTelemetry. For a job split across a slow
+     * arena, the arena size covers both arenas, the spilled buffers count as non persistent and the usage of the slow
+     * arena is recorded separately. Like the other statistics, the telemetry is recorded without locking.
+     */
+    const ArenaTelemetry::Stats &getArenaTelemetry() const;
+    void clearArenaTelemetry();
+
+    /**
+     * Open a stateful session for a network model.
+     *
+     * The session keeps the interpreter and the resource variables (VAR_HANDLE, ASSIGN_VARIABLE, READ_VARIABLE)
+     * alive in the tensor arena between jobs, so that recurrent state carries over from one job to the next. While
+     * the session is open runJob() reuses the session interpreter for jobs with the same network model, and rejects
+     * jobs for any other model and partial jobs.
+     */
+    bool openSession(const DataPtr &networkModel);
+    void closeSession();
+    bool isSessionOpen() const;
+
+    /**
+     * Reset variable tensors and resource variables of the open session to their initial values.
+     */
+    bool resetSession();
+
+    /**
+     * Snapshot and restore the resource variables of the open session. The state buffer must be at least
+     * getSessionStateSize() bytes.
+     */
+    size_t getSessionStateSize() const;
+    bool saveSessionState(DataPtr &state) const;
+    bool restoreSessionState(const DataPtr &state);
+
+    /**
+     * A/B model slots for replacing a model without stopping the callers.
+     *
+     * prepareModel() verifies the network model, and creates and allocates an interpreter for it in its own arena in
+     * the standby slot. It may be called from another task while jobs run on the active slot. swapModel() then makes
+     * the standby slot active with an atomic pointer flip. Jobs without network model run on the active slot, and a
+     * job in flight during the swap completes on the slot it started on. The arena telemetry of such a job is
+     * recorded for the model that served it, and the job itself is not modified. Partial jobs without network model
+     * are rejected.
+     *
+     * The swap latency is measured from the swap until the previously active slot has no jobs in flight, and the
+     * number of jobs it had to wait for is recorded. Until then the standby slot is busy. Afterwards the previous
+     * model stays prepared, so swapping again rolls back. prepareModel() and swapModel() fail while the other one
+     * runs.
+     */
+    bool prepareModel(const DataPtr &networkModel, const DataPtr &arena);
+    bool swapModel();
+    ModelSwapStats getModelSwapStats() const;
+
 protected:
+    class ModelSlot;
+    class PipelineInterpreters;
+    class Session;
+
+    bool dispatchJob(InferenceJob &job);
+    bool runModel(InferenceJob &job);
+    bool runSlotJob(InferenceJob &job);
+    void releaseSlot(ModelSlot *slot);
+    bool prepareSlot(const DataPtr &networkModel, const DataPtr &arena, std::unique_ptr<ModelSlot> &standby);
+    bool runInterpreter(InferenceJob &job, tflite::MicroInterpreter &interpreter, tflite::ArmProfiler *profiler);
+    bool runTieredJob(InferenceJob &job,
+                      const tflite::Model *model,
+                      const tflite::MicroOpResolver &resolver,
+                      tflite::ArmProfiler *profiler,
+                      uint8_t *arena,
+                      size_t arenaSize);
+    static bool transferTensors(const PipelineStage &stage,
+                                tflite::MicroInterpreter &producer,
+                                tflite::MicroInterpreter &consumer);
     static bool copyIfm(InferenceJob &job, tflite::MicroInterpreter &interpreter);
     static bool copyOfm(InferenceJob &job, tflite::MicroInterpreter &interpreter);
     static bool compareOfm(InferenceJob &job, tflite::MicroInterpreter &interpreter);
     static void printJob(InferenceJob &job, tflite::MicroInterpreter &interpreter);
     static void printOutputTensor(TfLiteTensor *output, size_t bytesToPrint);
     static void tfluDebugLog(const char *s);
+    void setJobArena(size_t size, const tflite::SingleArenaBufferAllocator *memory);
 
     uint8_t *tensorArena;
     const size_t tensorArenaSize;
+    size_t arenaUsedBytes;
+    DataPtr arenaPlanModel;
+    DataPtr arenaPlan;
+    DataPtr slowArena;
+    ArenaPlacement::Policy arenaPolicy;
+    size_t slowArenaUsedBytes;
+    ArenaTelemetry telemetry;
+    ArenaTelemetry::ArenaUsage jobArena;
+    DataPtr jobModel;
+    const void *accessProfileModel;
+    std::vector<uint32_t> accessProfile;
+    ResultCache resultCache;
     InferenceParser parser;
+    ProfilerPool profilers;
+    ModelView modelView;
+    std::unique_ptr<Session> session;
+    std::unique_ptr<PipelineInterpreters> pipeline;
+    std::unique_ptr<ModelSlot> slots[2];
+    std::atomic<ModelSlot *> activeSlot;
+
+    // Number of active slot lookups in progress, and SlotsLocked while a model is prepared or swapped
+    static constexpr uint32_t SlotsLocked = 1U << 31;
+    std::atomic<uint32_t> slotState;
+
+    struct {
+        std::atomic<uint32_t> swaps{0};
+        std::atomic<uint32_t> prepareCycles{0};
+        std::atomic<uint32_t> swapCycles{0};
+        std::atomic<uint32_t> waitedJobs{0};
+        std::atomic<uint32_t> totalWaitedJobs{0};
+        std::atomic<uint32_t> swapStart{0};
+    } swapStats;
 };
 } // namespace InferenceProcess
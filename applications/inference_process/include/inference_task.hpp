@@ -0,0 +1,175 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2023 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "inference_process.hpp"
+#include "job_queue.hpp"
+#include "job_stats.hpp"
+
+#include "FreeRTOS.h"
+#include "queue.h"
+#include "task.h"
+
+namespace InferenceProcess {
+
+/**
+ * FreeRTOS worker task running the inference jobs posted to its queues.
+ *
+ * Tasks post jobs to a FreeRTOS queue with post(). A single producer in interrupt context, for example the rpmsg
+ * receive callback, posts jobs to a lock free ring with postFromISR() instead, see SpscQueue. Either way only the job
+ * handle is passed, and the worker is woken by a task notification. Jobs in the ring run before the jobs in the
+ * queue.
+ *
+ * The task stack, the task control block and the queue storage are members of the object. With
+ * configSUPPORT_STATIC_ALLOCATION enabled the kernel objects of the worker are not allocated from the heap, and an
+ * object placed in static memory makes their memory usage known at link time. Running the jobs still allocates from
+ * the C library heap, for example the tensor lists of InferenceJob, the input buffers of copyIfm() and the sessions,
+ * model slots and pipelines of InferenceProcess.
+ */
+template <size_t StackDepth, size_t QueueLength, size_t IsrQueueLength = 8>
+class InferenceTask {
+public:
+    // Called from the worker task when a job has completed
+    using Callback = void (*)(InferenceJob &job, bool failed, void *context);
+
+    InferenceTask(uint8_t *arena, size_t arenaSize, Callback _callback = nullptr, void *_context = nullptr) :
+        process(arena, arenaSize), callback(_callback), context(_context), stats(nullptr), task(nullptr),
+        queue(nullptr) {}
+
+    InferenceTask(const InferenceTask &)            = delete;
+    InferenceTask &operator=(const InferenceTask &) = delete;
+
+    /**
+     * Create the queue and the worker task. Nothing is left allocated on failure.
+     */
+    bool start(const char *name, UBaseType_t priority) {
+#if (configSUPPORT_STATIC_ALLOCATION == 1)
+        queue = xQueueCreateStatic(QueueLength, sizeof(InferenceJob *), queueStorage, &queueBuffer);
+        task  = xTaskCreateStatic(run, name, StackDepth, this, priority, stack, &taskBuffer);
+#else
+        queue = xQueueCreate(QueueLength, sizeof(InferenceJob *));
+        if (queue != nullptr && xTaskCreate(run, name, StackDepth, this, priority, &task) != pdPASS) {
+            vQueueDelete(queue);
+            queue = nullptr;
+            task  = nullptr;
+        }
+#endif
+
+        return queue == nullptr || task == nullptr;
+    }
+
+    /**
+     * Post a job to the worker. The job is passed by reference and must stay valid until the callback has been
+     * called. Fails if the worker has not been started.
+     */
+    bool post(InferenceJob &job, TickType_t timeout = portMAX_DELAY) {
+        InferenceJob *ptr = &job;
+
+        if (queue == nullptr || task == nullptr || xQueueSendToBack(queue, &ptr, timeout) != pdPASS) {
+            return true;
+        }
+
+        xTaskNotifyGive(task);
+
+        return false;
+    }
+
+    /**
+     * Post a job from interrupt context without blocking. Only one producer may call this function, and the job must
+     * stay valid until the callback has been called. Fails if the worker has not been started or the ring is full.
+     * Pass higherPriorityTaskWoken to portYIELD_FROM_ISR() when returning from the interrupt.
+     */
+    bool postFromISR(InferenceJob &job, BaseType_t *higherPriorityTaskWoken) {
+        if (task == nullptr || ring.push(&job)) {
+            return true;
+        }
+
+        vTaskNotifyGiveFromISR(task, higherPriorityTaskWoken);
+
+        return false;
+    }
+
+    /**
+     * Record the queue depth and the result of every job in stats. Must be set before the worker is started.
+     */
+    void setStats(JobStats *_stats) {
+        stats = _stats;
+    }
+
+    InferenceProcess &getProcess() {
+        return process;
+    }
+
+    TaskHandle_t getTask() const {
+        return task;
+    }
+
+    // Number of jobs waiting in the queue and in the ring. The queue only exists once the worker has been started.
+    size_t getQueueDepth() const {
+        const size_t queued = queue != nullptr ? uxQueueMessagesWaiting(queue) : 0;
+
+        return queued + ring.size();
+    }
+
+private:
+    static void run(void *param) {
+        InferenceTask *self = static_cast<InferenceTask *>(param);
+
+        while (true) {
+            InferenceJob *job;
+
+            // Sleep when both are empty. A job posted in the meantime leaves a notification pending.
+            if (self->ring.pop(job) && xQueueReceive(self->queue, &job, 0) != pdPASS) {
+                (void)ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+                continue;
+            }
+
+            if (self->stats != nullptr) {
+                self->stats->recordQueueDepth(self->getQueueDepth() + 1);
+            }
+
+            bool failed = self->process.runJob(*job);
+
+            if (self->stats != nullptr) {
+                self->stats->recordJob(*job, failed, self->process);
+            }
+
+            if (self->callback != nullptr) {
+                self->callback(*job, failed, self->context);
+            }
+        }
+    }
+
+    InferenceProcess process;
+    Callback callback;
+    void *context;
+    JobStats *stats;
+    TaskHandle_t task;
+    QueueHandle_t queue;
+    SpscQueue<InferenceJob *, IsrQueueLength> ring;
+
+#if (configSUPPORT_STATIC_ALLOCATION == 1)
+    StackType_t stack[StackDepth];
+    StaticTask_t taskBuffer;
+    uint8_t queueStorage[QueueLength * sizeof(InferenceJob *)];
+    StaticQueue_t queueBuffer;
+#endif
+};
+
+} // namespace InferenceProcess
@@ -0,0 +1,91 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2023 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+struct TfLiteTensor;
+
+namespace InferenceProcess {
+
+/**
+ * Preprocessing of a job input, fused into the copy of the input to the input tensor.
+ *
+ * The job input is an image of height x width x channels elements of the given type, in NHWC or NCHW layout. The crop
+ * window of the image is resized to the height and width of the input tensor with nearest neighbour sampling. Channel
+ * c of the tensor is taken from channel channelOrder[c] of the image, and its value is
+ *
+ *   real = (source - offset[c]) * scale[c]
+ *
+ * quantized with the quantization parameters of the input tensor. For an int8 tensor with scale 1/255 and zero point
+ * -128, offset 0 and scale 1/255 turn a uint8 image into the input of the network. The input tensor must be NHWC with
+ * a batch of one, HWC or HW, with at most MaxChannels channels, and of type int8, uint8, int16 or float32.
+ *
+ * A default constructed transform copies the input unchanged. The struct has no padding, so that it can be hashed.
+ */
+struct InputTransform {
+    enum Type : uint8_t {
+        COPY,
+        UINT8,
+        INT8,
+        FLOAT32
+    };
+
+    enum Layout : uint8_t {
+        NHWC,
+        NCHW
+    };
+
+    static constexpr size_t MaxChannels = 4;
+
+    int32_t height;
+    int32_t width;
+    int32_t channels;
+    int32_t cropTop;
+    int32_t cropLeft;
+    int32_t cropHeight;
+    int32_t cropWidth;
+    float offset[MaxChannels];
+    float scale[MaxChannels];
+    Type type;
+    Layout layout;
+    uint8_t channelOrder[MaxChannels];
+    uint8_t reserved[2];
+
+    InputTransform();
+
+    /**
+     * Transform of a whole image without normalization and with the channels in order.
+     */
+    InputTransform(Type type, Layout layout, int32_t height, int32_t width, int32_t channels);
+
+    void setCrop(int32_t top, int32_t left, int32_t height, int32_t width);
+    void setNormalization(float offset, float scale);
+    void setNormalization(size_t channel, float offset, float scale);
+
+    size_t getInputSize() const;
+};
+
+/**
+ * Transform a job input into an input tensor. Returns true if the transform does not match the input or the tensor.
+ */
+bool transformInput(const InputTransform &transform, const void *data, size_t size, TfLiteTensor &tensor);
+
+} // namespace InferenceProcess
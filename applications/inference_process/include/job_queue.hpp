@@ -0,0 +1,112 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2023 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+#include <type_traits>
+
+#ifndef INFERENCE_PROCESS_CACHE_LINE_SIZE
+#ifdef __DCACHE_LINE_SIZE
+#define INFERENCE_PROCESS_CACHE_LINE_SIZE __DCACHE_LINE_SIZE
+#else
+#define INFERENCE_PROCESS_CACHE_LINE_SIZE 32
+#endif
+#endif
+
+namespace InferenceProcess {
+
+/**
+ * Lock free ring with a single producer and a single consumer, meant for passing job handles.
+ *
+ * The producer only writes the head index and the consumer only writes the tail index, so push() and pop() need
+ * nothing but atomic loads and stores with acquire and release ordering. Both are wait free and may be called from
+ * interrupt context, also on cores without exclusive access instructions. The indices run freely and are masked with
+ * the capacity, which must be a power of two.
+ *
+ * The indices and the slots are on cache lines of their own, so that the producer and the consumer do not write to
+ * the same line.
+ */
+template <typename T, size_t Capacity>
+class SpscQueue {
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+    static_assert(std::is_trivially_copyable<T>::value, "Entries must be trivially copyable");
+
+public:
+    SpscQueue() : head(0), tail(0) {}
+    SpscQueue(const SpscQueue &)            = delete;
+    SpscQueue &operator=(const SpscQueue &) = delete;
+
+    /**
+     * Producer side. Returns true if the queue is full.
+     */
+    bool push(const T &value) {
+        const uint32_t h = head.load(std::memory_order_relaxed);
+
+        // The consumer has finished reading the slot once it has moved the tail past it
+        if (h - tail.load(std::memory_order_acquire) >= Capacity) {
+            return true;
+        }
+
+        slots[h & (Capacity - 1)] = value;
+        head.store(h + 1, std::memory_order_release);
+
+        return false;
+    }
+
+    /**
+     * Consumer side. Returns true if the queue is empty.
+     */
+    bool pop(T &value) {
+        const uint32_t t = tail.load(std::memory_order_relaxed);
+
+        if (head.load(std::memory_order_acquire) == t) {
+            return true;
+        }
+
+        value = slots[t & (Capacity - 1)];
+        tail.store(t + 1, std::memory_order_release);
+
+        return false;
+    }
+
+    /**
+     * Number of entries. Exact on the consumer side, a snapshot anywhere else.
+     */
+    size_t size() const {
+        const uint32_t t = tail.load(std::memory_order_acquire);
+        return head.load(std::memory_order_acquire) - t;
+    }
+
+    bool empty() const {
+        return size() == 0;
+    }
+
+    static constexpr size_t capacity() {
+        return Capacity;
+    }
+
+private:
+    alignas(INFERENCE_PROCESS_CACHE_LINE_SIZE) std::atomic<uint32_t> head;
+    alignas(INFERENCE_PROCESS_CACHE_LINE_SIZE) std::atomic<uint32_t> tail;
+    alignas(INFERENCE_PROCESS_CACHE_LINE_SIZE) T slots[Capacity];
+};
+
+} // namespace InferenceProcess
@@ -0,0 +1,42 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2023 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <stddef.h>
+
+namespace InferenceProcess {
+
+struct InferenceJob;
+class InferenceProcess;
+
+/**
+ * Statistics of the jobs run by an InferenceTask, for example EthosURuntimeStats. Both functions are called from the
+ * worker task, recordQueueDepth() before a job is run and recordJob() when it has completed.
+ */
+class JobStats {
+public:
+    virtual ~JobStats() = default;
+
+    // Number of jobs waiting in the queues, including the job about to run
+    virtual void recordQueueDepth(size_t depth) = 0;
+
+    virtual void recordJob(const InferenceJob &job, bool failed, const InferenceProcess &process) = 0;
+};
+
+} // namespace InferenceProcess
@@ -0,0 +1,53 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2023 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "inference_process.hpp"
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace InferenceProcess {
+
+/**
+ * Static description of a network model, generated at build time by ethosu_add_model(). The arena size is the
+ * number of tensor arena bytes used by the model, and the tensor sizes are in bytes.
+ */
+struct ModelDescriptor {
+    const char *name;
+    const uint8_t *model;
+    size_t modelSize;
+    size_t arenaSize;
+    const size_t *inputSizes;
+    size_t numInputs;
+    const size_t *outputSizes;
+    size_t numOutputs;
+};
+
+/**
+ * Create a job for a described model. input and output hold one buffer per tensor, sized as given by the
+ * descriptor.
+ */
+InferenceJob makeJob(const ModelDescriptor &descriptor,
+                     void *const *input,
+                     void *const *output,
+                     size_t numBytesToPrint = 0,
+                     void *externalContext  = nullptr);
+
+} // namespace InferenceProcess
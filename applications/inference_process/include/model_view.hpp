@@ -0,0 +1,109 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2023 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace tflite {
+struct Model;
+struct SubGraph;
+} // namespace tflite
+
+namespace InferenceProcess {
+
+/**
+ * View of a network model narrowed down to one signature or subgraph, created by patching a private copy of the
+ * model flatbuffer.
+ *
+ * TFLu plans the tensor arena for all subgraphs of a model and invokes the first one. select() copies the model to a
+ * writable buffer, for example the start of the tensor arena, makes the selected subgraph the only subgraph of the
+ * copy, sets its inputs and outputs to the tensors of the signature, and removes the operators that the outputs do not
+ * depend on. Operators without outputs and operators updating variable tensors are always kept. The tensors only used
+ * by removed operators are given an empty shape, so that the memory planner skips them. The interpreter then plans
+ * and runs the operators of the signature only, and a cheap head of a multi head model does not pay for an expensive
+ * one.
+ *
+ * The model passed to select() is never written, so it may be in read only memory and may be used by other
+ * interpreters at the same time. The buffer must hold the whole model, and must stay valid while an interpreter uses
+ * the view. If a shape vector is shared with a tensor that is still used, all operators are run.
+ *
+ * Subgraphs with control flow operators reference other subgraphs by index, and are only supported if they are the
+ * first subgraph. The other subgraphs are then kept. Offline memory plans cover the tensors of all subgraphs, so a
+ * model with an offline memory plan only supports the first subgraph as well.
+ */
+class ModelView {
+public:
+    ModelView();
+
+    /**
+     * Copy the model to the buffer and select the signature with the given key, or the subgraph with the given index
+     * if the key is empty. The model must have been verified. Returns true on failure.
+     */
+    bool select(const void *modelData,
+                size_t modelSize,
+                const char *signature,
+                size_t subgraph,
+                uint8_t *buffer,
+                size_t bufferSize);
+
+    /**
+     * True if the view holds the selection of select() with the same arguments, so that the copy can be reused as
+     * long as the buffer has not been written and the model has not been changed in place.
+     */
+    bool matches(const void *modelData, size_t modelSize, const char *signature, size_t subgraph) const;
+    bool isCopyOf(const void *modelData) const;
+
+    /**
+     * Release the view. The buffer is not used after this.
+     */
+    void reset();
+
+    bool isSelected() const;
+    const tflite::Model *getModel() const;
+
+    // Bytes of the buffer used by the copy, rounded up to the alignment of the tensor arena
+    size_t getSize() const;
+    size_t getSubGraph() const;
+    size_t getNumOperators() const;
+    size_t getNumSkippedOperators() const;
+
+private:
+    bool selectSubGraph(const tflite::Model *model, size_t index, bool keepOthers);
+    bool setTensors(const uint8_t *data, const std::vector<int32_t> &tensors);
+    bool pruneOperators(const tflite::Model *model, const tflite::SubGraph *subgraph);
+    bool write(const void *location, uint32_t value);
+    bool writeOffset(const uint8_t *location, const uint8_t *target);
+
+    const void *source;
+    size_t sourceSize;
+    std::string sourceSignature;
+    size_t sourceSubGraph;
+    const tflite::Model *copy;
+    uint8_t *begin;
+    uint8_t *end;
+    size_t size;
+    size_t subGraph;
+    size_t numOperators;
+    size_t numSkipped;
+};
+
+} // namespace InferenceProcess
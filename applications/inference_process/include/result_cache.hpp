@@ -0,0 +1,127 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2023 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+namespace InferenceProcess {
+// Forward declarations
+struct InferenceJob;
+
+/**
+ * Cache of inference results, keyed by a CRC-32 of the network model and a CRC-32 of all job inputs.
+ *
+ * The CRC of a network model is computed the first time the model is seen at an address and remembered for up to
+ * maxEntries models, so copies of a model share their entries. A model changed in place must be invalidated, which
+ * makes the cache compute its CRC again.
+ *
+ * A hit copies the cached outputs to the job output buffers, so the interpreter is neither created nor invoked. Only
+ * complete inputs are hashed, so two inputs sharing a checksum, which happens with a probability of about 2^-32,
+ * return the same outputs. With ignoreBits set the lowest bits of every input byte are masked before hashing, which
+ * lets near identical frames from a noisy sensor share an entry.
+ *
+ * The cache holds at most maxEntries entries and maxBytes bytes of output data. When full, the entry to evict is
+ * selected by the eviction policy.
+ */
+class ResultCache {
+public:
+    enum Eviction {
+        LRU,
+        LFU,
+        FIFO
+    };
+
+    struct Stats {
+        uint32_t lookups;
+        uint32_t hits;
+        uint32_t insertions;
+        uint32_t evictions;
+        uint64_t hashCycles;
+        uint64_t savedCycles;
+    };
+
+    ResultCache();
+
+    /**
+     * Configure and clear the cache. Zero entries disables the cache.
+     */
+    void configure(size_t maxEntries, size_t maxBytes, Eviction eviction = LRU, uint8_t ignoreBits = 0);
+    bool isEnabled() const;
+
+    /**
+     * Checksum of the job inputs. The cycles spent hashing are added to the statistics.
+     */
+    uint32_t checksum(const InferenceJob &job);
+
+    /**
+     * Copy the cached outputs for the job to the job output buffers. Returns true on a hit.
+     */
+    bool lookup(InferenceJob &job, uint32_t crc);
+
+    /**
+     * Insert the outputs of a job that has been run. Outputs larger than maxBytes are not cached.
+     */
+    void insert(const InferenceJob &job, uint32_t crc);
+
+    /**
+     * Forget the CRC of a network model and drop its entries, for example after the model has been replaced in place.
+     */
+    void invalidate(const void *model);
+
+    void clear();
+
+    const Stats &getStats() const;
+    void resetStats();
+
+private:
+    struct Model {
+        const void *data;
+        size_t size;
+        uint32_t crc;
+    };
+
+    struct Entry {
+        uint32_t modelCrc;
+        uint32_t crc;
+        uint32_t lastUsed;
+        uint32_t inserted;
+        uint32_t hits;
+        uint64_t cpuCycles;
+        std::vector<size_t> outputSizes;
+        std::vector<uint8_t> outputs;
+    };
+
+    uint32_t modelChecksum(const InferenceJob &job);
+    Entry *find(const InferenceJob &job, uint32_t modelCrc, uint32_t crc);
+    void evict();
+
+    size_t maxEntries;
+    size_t maxBytes;
+    Eviction eviction;
+    uint8_t mask;
+    size_t bytes;
+    uint32_t clock;
+    std::vector<Model> models;
+    std::vector<Entry> entries;
+    Stats stats;
+};
+
+} // namespace InferenceProcess
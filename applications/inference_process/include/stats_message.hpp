@@ -0,0 +1,75 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2023 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+namespace InferenceProcess {
+
+/**
+ * Writer of the compact little endian statistics messages, for example sent with rpmsg_send(). A message starts with
+ * a 32-bit magic and a 32-bit version, followed by the fields of the statistics. The size of the message is known up
+ * front, and nothing is written if it does not fit in the buffer.
+ */
+class StatsMessage {
+public:
+    StatsMessage(uint8_t *buf, size_t bufSize, size_t messageSize, uint32_t magic, uint32_t version) :
+        begin(buf), pos(messageSize <= bufSize ? buf : nullptr) {
+        put(magic, 4);
+        put(version, 4);
+    }
+
+    void put(uint64_t value, size_t size) {
+        if (pos == nullptr) {
+            return;
+        }
+
+        for (size_t i = 0; i < size; i++) {
+            *pos++ = static_cast<uint8_t>(value >> (8 * i));
+        }
+    }
+
+    void putBytes(const void *data, size_t size) {
+        if (pos == nullptr) {
+            return;
+        }
+
+        memcpy(pos, data, size);
+        pos += size;
+    }
+
+    /**
+     * Number of bytes written, or 0 if the message did not fit.
+     */
+    size_t size() const {
+        return pos == nullptr ? 0 : pos - begin;
+    }
+
+    static uint32_t clamp(size_t value) {
+        return value > UINT32_MAX ? UINT32_MAX : static_cast<uint32_t>(value);
+    }
+
+private:
+    uint8_t *begin;
+    uint8_t *pos;
+};
+
+} // namespace InferenceProcess
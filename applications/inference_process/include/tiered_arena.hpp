@@ -0,0 +1,88 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2023 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "tensorflow/lite/micro/memory_planner/micro_memory_planner.h"
+
+#include "arena_placement.hpp"
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace tflite {
+// Forward declarations
+class INonPersistentBufferAllocator;
+class IPersistentBufferAllocator;
+class MicroAllocator;
+} // namespace tflite
+
+namespace InferenceProcess {
+
+/**
+ * Memory planner splitting the tensor arena across a fast and a slow memory region, for example tightly coupled SRAM
+ * and DRAM.
+ *
+ * The allocator created by createAllocator() places all persistent allocations, like the tensor metadata and the
+ * persistent buffers of the kernels, in the slow region. The planned buffers are placed by an ArenaPlacement. The
+ * buffers spilled to the slow region share one persistent allocation, and their offsets are given relative to the
+ * start of the fast region.
+ */
+class TieredMemoryPlanner : public tflite::MicroMemoryPlanner {
+public:
+    TieredMemoryPlanner(uint8_t *fastArena,
+                        size_t fastArenaSize,
+                        ArenaPlacement::Policy policy,
+                        const uint32_t *operatorTicks = nullptr,
+                        size_t numOperators           = 0);
+
+    /**
+     * Create an allocator using this planner. The allocator and the planner must not outlive the slow arena.
+     */
+    tflite::MicroAllocator *createAllocator(uint8_t *slowArena, size_t slowArenaSize);
+
+    TfLiteStatus Init(unsigned char *scratchBuffer, int scratchBufferSize) override;
+    TfLiteStatus AddBuffer(int size, int firstTimeUsed, int lastTimeUsed) override;
+    TfLiteStatus AddBuffer(int size, int firstTimeUsed, int lastTimeUsed, int offlineOffset) override;
+    size_t GetMaximumMemorySize() override;
+    int GetBufferCount() override;
+    TfLiteStatus GetOffsetForBuffer(int bufferIndex, int *offset) override;
+
+    const ArenaPlacement &getPlacement() const;
+
+    /**
+     * Bytes used in each region by the allocator, including the scratch buffers in the fast region, and the spilled
+     * buffers and the allocators themselves in the slow region.
+     */
+    size_t getFastUsedBytes() const;
+    size_t getSlowUsedBytes() const;
+
+private:
+    bool plan();
+
+    uint8_t *fastArena;
+    size_t fastArenaSize;
+    ArenaPlacement placement;
+    tflite::IPersistentBufferAllocator *persistent;
+    tflite::INonPersistentBufferAllocator *nonPersistent;
+    uint8_t *spill;
+    bool planned;
+    bool failed;
+};
+
+} // namespace InferenceProcess
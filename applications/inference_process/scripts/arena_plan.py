@@ -0,0 +1,99 @@
+#!/usr/bin/env python3
+#
+# SPDX-FileCopyrightText: Copyright 2023 Arm Limited and/or its affiliates <open-source-office@arm.com>
+# SPDX-License-Identifier: Apache-2.0
+#
+# Licensed under the Apache License, Version 2.0 (the License); you may
+# not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+# www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an AS IS BASIS, WITHOUT
+# WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+
+"""
+Convert an arena plan captured with InferenceProcess::captureArenaPlan() into
+a C source file, to be linked next to the network model.
+
+The plan is read from a log containing the '"arena_plan": "<base64>"' line
+printed by the capture, or from a binary file.
+"""
+
+import argparse
+import base64
+import re
+import struct
+import zlib
+
+MAGIC = 0x50415545
+VERSION = 1
+HEADER = struct.Struct('<8I')
+BUFFER = struct.Struct('<4i')
+
+
+def read_plan(path):
+    with open(path, 'rb') as f:
+        data = f.read()
+
+    match = re.search(rb'"arena_plan": "([A-Za-z0-9+/=]+)"', data)
+    if match:
+        return base64.b64decode(match.group(1))
+
+    return data
+
+
+def verify_plan(plan, model):
+    if len(plan) < HEADER.size:
+        raise ValueError('Arena plan truncated')
+
+    magic, version, crc, size, arena, max_memory, count, _ = HEADER.unpack_from(plan)
+    if magic != MAGIC or version != VERSION:
+        raise ValueError(f'Invalid arena plan: magic={magic:#x}, version={version}')
+
+    if len(plan) < HEADER.size + count * BUFFER.size:
+        raise ValueError(f'Arena plan truncated: buffers={count}')
+
+    if model is not None:
+        with open(model, 'rb') as f:
+            data = f.read()
+
+        if len(data) != size or zlib.crc32(data) != crc:
+            raise ValueError('Arena plan does not match the model')
+
+    print(f'Arena plan: model_size={size}, crc={crc:#010x}, arena_size={arena}, '
+          f'max_memory={max_memory}, buffers={count}')
+
+
+def write_source(plan, path, name, section):
+    with open(path, 'w') as f:
+        f.write('#include <stddef.h>\n#include <stdint.h>\n\n')
+        f.write(f'const uint8_t {name}[] __attribute__((aligned(16), section("{section}"))) = {{\n')
+
+        for i in range(0, len(plan), 16):
+            f.write('    ' + ', '.join(f'0x{b:02x}' for b in plan[i:i + 16]) + ',\n')
+
+        f.write('};\n\n')
+        f.write(f'const size_t {name}_size = sizeof({name});\n')
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Convert a captured arena plan to a C source file')
+    parser.add_argument('input', help='Capture log or binary arena plan')
+    parser.add_argument('-o', '--output', required=True, help='Output C source file')
+    parser.add_argument('-m', '--model', help='Network model to verify the plan against')
+    parser.add_argument('-n', '--name', default='arena_plan', help='Name of the C array')
+    parser.add_argument('-s', '--section', default='network_model_sec', help='Linker section')
+    args = parser.parse_args()
+
+    plan = read_plan(args.input)
+    verify_plan(plan, args.model)
+    write_source(plan, args.output, args.name, args.section)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,205 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2023 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "arena_placement.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+namespace InferenceProcess {
+
+ArenaPlacement::ArenaPlacement(size_t _fastSize,
+                               Policy _policy,
+                               const uint32_t *_operatorTicks,
+                               size_t _numOperators) :
+    fastSize(_fastSize), policy(_policy), operatorTicks(_operatorTicks), numOperators(_numOperators), fastUsed(0),
+    slowUsed(0) {}
+
+void ArenaPlacement::clear() {
+    buffers.clear();
+    fastUsed = 0;
+    slowUsed = 0;
+}
+
+void ArenaPlacement::addBuffer(int size, int firstTimeUsed, int lastTimeUsed, int offlineOffset) {
+    buffers.push_back({size, firstTimeUsed, lastTimeUsed, offlineOffset, true, 0});
+}
+
+bool ArenaPlacement::place() {
+    std::vector<size_t> order;
+
+    for (size_t i = 0; i < buffers.size(); i++) {
+        buffers[i].fast = true;
+
+        if (buffers[i].offlineOffset < 0) {
+            order.push_back(i);
+        }
+    }
+
+    // Everything fits in the fast region
+    fastUsed = planRegion(true);
+    slowUsed = 0;
+    if (fastUsed <= fastSize) {
+        return false;
+    }
+
+    for (auto i : order) {
+        buffers[i].fast = false;
+    }
+
+    // Offline planned buffers must stay in the fast region
+    if (planRegion(true) > fastSize) {
+        return true;
+    }
+
+    if (policy == ACCESS_FREQUENCY && operatorTicks != nullptr && numOperators > 0) {
+        touchedBytes.assign(numOperators, 0);
+
+        for (auto &buffer : buffers) {
+            for (auto time : {buffer.firstTimeUsed, buffer.lastTimeUsed}) {
+                if (time >= 0 && static_cast<size_t>(time) < numOperators) {
+                    touchedBytes[time] += buffer.size;
+                }
+            }
+        }
+
+        // Accesses per byte. Empty buffers take no fast memory and go first.
+        auto density = [this](size_t i) {
+            if (buffers[i].size <= 0) {
+                return std::numeric_limits<double>::infinity();
+            }
+
+            return static_cast<double>(getAccesses(buffers[i])) / buffers[i].size;
+        };
+
+        std::stable_sort(order.begin(), order.end(), [&density](size_t a, size_t b) {
+            return density(a) > density(b);
+        });
+    } else {
+        std::stable_sort(order.begin(), order.end(), [this](size_t a, size_t b) {
+            return buffers[a].size < buffers[b].size;
+        });
+    }
+
+    // Move buffers to the fast region in priority order for as long as they fit
+    for (auto i : order) {
+        if (static_cast<size_t>(buffers[i].size) > fastSize) {
+            continue;
+        }
+
+        buffers[i].fast = true;
+        if (planRegion(true) > fastSize) {
+            buffers[i].fast = false;
+        }
+    }
+
+    fastUsed = planRegion(true);
+    slowUsed = planRegion(false);
+
+    return false;
+}
+
+size_t ArenaPlacement::planRegion(bool fast) {
+    std::vector<size_t> placed;
+    std::vector<size_t> order;
+    size_t used = 0;
+
+    for (size_t i = 0; i < buffers.size(); i++) {
+        Buffer &buffer = buffers[i];
+
+        if (buffer.fast != fast) {
+            continue;
+        }
+
+        if (buffer.offlineOffset >= 0) {
+            buffer.offset = buffer.offlineOffset;
+            used          = std::max(used, static_cast<size_t>(buffer.offset) + buffer.size);
+            placed.push_back(i);
+        } else {
+            order.push_back(i);
+        }
+    }
+
+    // Place the largest buffers first, at the lowest offset not used by a buffer with an overlapping lifetime
+    std::stable_sort(order.begin(), order.end(), [this](size_t a, size_t b) {
+        return buffers[a].size > buffers[b].size;
+    });
+
+    std::vector<std::pair<int, int>> live;
+    for (auto i : order) {
+        Buffer &buffer = buffers[i];
+
+        live.clear();
+        for (auto j : placed) {
+            const Buffer &other = buffers[j];
+
+            if (other.lastTimeUsed >= buffer.firstTimeUsed && other.firstTimeUsed <= buffer.lastTimeUsed) {
+                live.push_back({other.offset, other.offset + other.size});
+            }
+        }
+
+        std::sort(live.begin(), live.end());
+
+        int offset = 0;
+        for (auto &it : live) {
+            if (it.first >= offset + buffer.size) {
+                break;
+            }
+
+            offset = std::max(offset, it.second);
+        }
+
+        buffer.offset = offset;
+        used          = std::max(used, static_cast<size_t>(offset) + buffer.size);
+        placed.push_back(i);
+    }
+
+    return used;
+}
+
+uint64_t ArenaPlacement::getAccesses(const Buffer &buffer) const {
+    uint64_t accesses = 0;
+
+    // Share of the ticks of the producing and the last consuming operator, in proportion to the buffer size
+    for (auto time : {buffer.firstTimeUsed, buffer.lastTimeUsed}) {
+        if (time >= 0 && static_cast<size_t>(time) < numOperators && touchedBytes[time] > 0) {
+            accesses += static_cast<uint64_t>(operatorTicks[time]) * buffer.size / touchedBytes[time];
+        }
+    }
+
+    return accesses;
+}
+
+const std::vector<ArenaPlacement::Buffer> &ArenaPlacement::getBuffers() const {
+    return buffers;
+}
+
+size_t ArenaPlacement::getFastUsedBytes() const {
+    return fastUsed;
+}
+
+size_t ArenaPlacement::getSlowUsedBytes() const {
+    return slowUsed;
+}
+
+size_t ArenaPlacement::getSpilledCount() const {
+    return std::count_if(buffers.begin(), buffers.end(), [](const Buffer &buffer) { return !buffer.fast; });
+}
+
+} // namespace InferenceProcess
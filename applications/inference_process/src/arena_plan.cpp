@@ -0,0 +1,197 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2023 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "arena_plan.hpp"
+
+#include "crc.hpp"
+#include "ethosu_log.h"
+
+#include <inttypes.h>
+#include <string.h>
+
+namespace InferenceProcess {
+
+/****************************************************************************
+ * ArenaPlanRecorder
+ ****************************************************************************/
+
+TfLiteStatus ArenaPlanRecorder::Init(unsigned char *scratchBuffer, int scratchBufferSize) {
+    buffers.clear();
+
+    return GreedyMemoryPlanner::Init(scratchBuffer, scratchBufferSize);
+}
+
+TfLiteStatus ArenaPlanRecorder::AddBuffer(int size, int firstTimeUsed, int lastTimeUsed) {
+    TfLiteStatus status = GreedyMemoryPlanner::AddBuffer(size, firstTimeUsed, lastTimeUsed);
+    if (status == kTfLiteOk) {
+        buffers.push_back({size, firstTimeUsed, lastTimeUsed, -1});
+    }
+
+    return status;
+}
+
+TfLiteStatus ArenaPlanRecorder::AddBuffer(int size, int firstTimeUsed, int lastTimeUsed, int offlineOffset) {
+    // The greedy planner adds the buffer through the virtual three argument AddBuffer(), which records it
+    TfLiteStatus status = GreedyMemoryPlanner::AddBuffer(size, firstTimeUsed, lastTimeUsed, offlineOffset);
+    if (status == kTfLiteOk && !buffers.empty()) {
+        buffers.back().offset = offlineOffset;
+    }
+
+    return status;
+}
+
+size_t ArenaPlanRecorder::getPlanSize(size_t bufferCount) {
+    return sizeof(ArenaPlanHeader) + bufferCount * sizeof(ArenaPlanBuffer);
+}
+
+bool ArenaPlanRecorder::serialize(uint32_t modelCrc,
+                                  uint32_t modelSize,
+                                  uint32_t arenaSize,
+                                  void *plan,
+                                  size_t &planSize) {
+    const size_t size = getPlanSize(buffers.size());
+    if (plan == nullptr || planSize < size) {
+        LOG_ERR("Arena plan buffer too small: size=%zu, required=%zu", planSize, size);
+        return true;
+    }
+
+    ArenaPlanHeader *header = static_cast<ArenaPlanHeader *>(plan);
+    header->magic           = ArenaPlanHeader::Magic;
+    header->version         = ArenaPlanHeader::Version;
+    header->modelCrc        = modelCrc;
+    header->modelSize       = modelSize;
+    header->arenaSize       = arenaSize;
+    header->maxMemorySize   = GetMaximumMemorySize();
+    header->bufferCount     = buffers.size();
+    header->reserved        = 0;
+
+    ArenaPlanBuffer *entries = reinterpret_cast<ArenaPlanBuffer *>(header + 1);
+    for (size_t i = 0; i < buffers.size(); ++i) {
+        int offset;
+        if (GetOffsetForBuffer(i, &offset) != kTfLiteOk) {
+            LOG_ERR("Failed to get offset for buffer: index=%zu", i);
+            return true;
+        }
+
+        entries[i]        = buffers[i];
+        entries[i].offset = offset;
+    }
+
+    planSize = size;
+
+    return false;
+}
+
+/****************************************************************************
+ * ArenaPlanPlanner
+ ****************************************************************************/
+
+ArenaPlanPlanner::ArenaPlanPlanner(const void *plan) :
+    header(static_cast<const ArenaPlanHeader *>(plan)), buffers(reinterpret_cast<const ArenaPlanBuffer *>(header + 1)),
+    count(0) {}
+
+TfLiteStatus ArenaPlanPlanner::Init(unsigned char *, int) {
+    count = 0;
+
+    return kTfLiteOk;
+}
+
+TfLiteStatus ArenaPlanPlanner::AddBuffer(int size, int firstTimeUsed, int lastTimeUsed) {
+    if (count >= static_cast<int>(header->bufferCount)) {
+        LOG_ERR("Arena plan buffer overflow: count=%d", count);
+        return kTfLiteError;
+    }
+
+    const ArenaPlanBuffer &buffer = buffers[count];
+    if (buffer.size != size || buffer.firstTimeUsed != firstTimeUsed || buffer.lastTimeUsed != lastTimeUsed) {
+        LOG_ERR("Arena plan buffer mismatch: index=%d, size=%d, expected=%" PRId32, count, size, buffer.size);
+        return kTfLiteError;
+    }
+
+    count++;
+
+    return kTfLiteOk;
+}
+
+TfLiteStatus ArenaPlanPlanner::AddBuffer(int size, int firstTimeUsed, int lastTimeUsed, int offlineOffset) {
+    if (count < static_cast<int>(header->bufferCount) && buffers[count].offset != offlineOffset) {
+        LOG_ERR("Arena plan offline offset mismatch: index=%d", count);
+        return kTfLiteError;
+    }
+
+    return AddBuffer(size, firstTimeUsed, lastTimeUsed);
+}
+
+size_t ArenaPlanPlanner::GetMaximumMemorySize() {
+    return header->maxMemorySize;
+}
+
+int ArenaPlanPlanner::GetBufferCount() {
+    return count;
+}
+
+TfLiteStatus ArenaPlanPlanner::GetOffsetForBuffer(int bufferIndex, int *offset) {
+    if (bufferIndex < 0 || bufferIndex >= count) {
+        return kTfLiteError;
+    }
+
+    *offset = buffers[bufferIndex].offset;
+
+    return kTfLiteOk;
+}
+
+bool ArenaPlanPlanner::validate(const void *plan,
+                                size_t planSize,
+                                const void *model,
+                                size_t modelSize,
+                                size_t arenaSize) {
+    if (plan == nullptr || reinterpret_cast<uintptr_t>(plan) % alignof(ArenaPlanHeader) != 0 ||
+        planSize < sizeof(ArenaPlanHeader)) {
+        LOG_ERR("Invalid arena plan: plan=%p, size=%zu", plan, planSize);
+        return true;
+    }
+
+    const ArenaPlanHeader *header = static_cast<const ArenaPlanHeader *>(plan);
+
+    if (header->magic != ArenaPlanHeader::Magic || header->version != ArenaPlanHeader::Version) {
+        LOG_ERR("Arena plan magic or version mismatch: magic=0x%08" PRIx32 ", version=%" PRIu32,
+                header->magic,
+                header->version);
+        return true;
+    }
+
+    if (planSize < ArenaPlanRecorder::getPlanSize(header->bufferCount)) {
+        LOG_ERR("Arena plan truncated: size=%zu, buffers=%" PRIu32, planSize, header->bufferCount);
+        return true;
+    }
+
+    if (header->arenaSize != arenaSize || header->maxMemorySize > arenaSize) {
+        LOG_ERR("Arena plan arena size mismatch: plan=%" PRIu32 ", arena=%zu", header->arenaSize, arenaSize);
+        return true;
+    }
+
+    constexpr auto crc = Crc();
+    if (header->modelSize != modelSize || header->modelCrc != crc.crc32(model, modelSize)) {
+        LOG_ERR("Arena plan model mismatch");
+        return true;
+    }
+
+    return false;
+}
+
+} // namespace InferenceProcess
@@ -0,0 +1,207 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2023 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "arena_telemetry.hpp"
+#include "stats_message.hpp"
+
+#include "crc.hpp"
+#include "ethosu_log.h"
+
+#include <algorithm>
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_NEWLIB_VERSION)
+#include <malloc.h>
+#endif
+
+namespace {
+constexpr size_t HeaderSize = 16;
+constexpr size_t HeapSize   = 28;
+constexpr size_t ModelSize  = 40;
+} // namespace
+
+extern "C" __attribute__((weak)) bool inference_process_get_heap_usage(size_t *used, size_t *freeBytes) {
+#if defined(_NEWLIB_VERSION)
+    const struct mallinfo info = mallinfo();
+
+    *used      = info.uordblks;
+    *freeBytes = info.fordblks;
+
+    return false;
+#else
+    *used      = 0;
+    *freeBytes = 0;
+
+    return true;
+#endif
+}
+
+namespace InferenceProcess {
+
+ArenaTelemetry::ArenaTelemetry() {
+    clear();
+}
+
+void ArenaTelemetry::clear() {
+    memset(&stats, 0, sizeof(stats));
+}
+
+void ArenaTelemetry::recordArena(const void *model, size_t modelSize, const ArenaUsage &usage) {
+    constexpr auto crc = Crc();
+    ModelStats *m      = find(model);
+
+    if (m == nullptr) {
+        if (stats.numModels >= INFERENCE_PROCESS_TELEMETRY_MAX_MODELS) {
+            stats.untrackedJobs++;
+            return;
+        }
+
+        m              = &stats.models[stats.numModels++];
+        *m             = ModelStats();
+        m->model       = model;
+        m->modelSize   = StatsMessage::clamp(modelSize);
+        m->modelCrc    = crc.crc32(model, modelSize);
+        m->minHeadroom = UINT32_MAX;
+    }
+
+    const size_t used     = usage.persistent + usage.nonPersistent;
+    const size_t headroom = usage.size > used ? usage.size - used : 0;
+
+    m->jobs++;
+    m->arenaSize         = StatsMessage::clamp(usage.size);
+    m->lastUsed          = StatsMessage::clamp(used);
+    m->peakUsed          = std::max(m->peakUsed, StatsMessage::clamp(used));
+    m->peakPersistent    = std::max(m->peakPersistent, StatsMessage::clamp(usage.persistent));
+    m->peakNonPersistent = std::max(m->peakNonPersistent, StatsMessage::clamp(usage.nonPersistent));
+    m->peakSlowUsed      = std::max(m->peakSlowUsed, StatsMessage::clamp(usage.slowUsed));
+    m->minHeadroom       = std::min(m->minHeadroom, StatsMessage::clamp(headroom));
+}
+
+void ArenaTelemetry::recordHeap(size_t usedBefore, size_t usedAfter, size_t freeBytes) {
+    HeapStats &heap = stats.heap;
+
+    heap.samples++;
+    heap.used      = StatsMessage::clamp(usedAfter);
+    heap.peakUsed  = std::max(heap.peakUsed, StatsMessage::clamp(std::max(usedBefore, usedAfter)));
+    heap.free      = StatsMessage::clamp(freeBytes);
+    heap.peakFree  = std::max(heap.peakFree, StatsMessage::clamp(freeBytes));
+    heap.lastDelta = static_cast<int32_t>(static_cast<int64_t>(usedAfter) - static_cast<int64_t>(usedBefore));
+
+    if (usedAfter > usedBefore) {
+        heap.grownJobs++;
+    }
+}
+
+const ArenaTelemetry::Stats &ArenaTelemetry::getStats() const {
+    return stats;
+}
+
+ArenaTelemetry::ModelStats *ArenaTelemetry::find(const void *model) {
+    for (size_t i = 0; i < stats.numModels; i++) {
+        if (stats.models[i].model == model) {
+            return &stats.models[i];
+        }
+    }
+
+    return nullptr;
+}
+
+const ArenaTelemetry::ModelStats *ArenaTelemetry::find(const void *model) const {
+    for (size_t i = 0; i < stats.numModels; i++) {
+        if (stats.models[i].model == model) {
+            return &stats.models[i];
+        }
+    }
+
+    return nullptr;
+}
+
+void ArenaTelemetry::log(const Stats &stats) {
+    const HeapStats &heap = stats.heap;
+
+    LOG("Arena telemetry: models=%" PRIu32 ", untracked_jobs=%" PRIu32 "\n", stats.numModels, stats.untrackedJobs);
+
+    for (size_t i = 0; i < stats.numModels; i++) {
+        const ModelStats &m = stats.models[i];
+
+        LOG("Model: size=%" PRIu32 ", crc=0x%08" PRIx32 ", jobs=%" PRIu32 ", arena=%" PRIu32 ", used=%" PRIu32
+            ", peak=%" PRIu32 ", persistent=%" PRIu32 ", non_persistent=%" PRIu32 ", slow=%" PRIu32
+            ", headroom=%" PRIu32 "\n",
+            m.modelSize,
+            m.modelCrc,
+            m.jobs,
+            m.arenaSize,
+            m.lastUsed,
+            m.peakUsed,
+            m.peakPersistent,
+            m.peakNonPersistent,
+            m.peakSlowUsed,
+            m.minHeadroom);
+    }
+
+    LOG("Heap: samples=%" PRIu32 ", used=%" PRIu32 ", peak=%" PRIu32 ", free=%" PRIu32 ", peak_free=%" PRIu32
+        ", last_delta=%" PRId32 ", grown_jobs=%" PRIu32 "\n",
+        heap.samples,
+        heap.used,
+        heap.peakUsed,
+        heap.free,
+        heap.peakFree,
+        heap.lastDelta,
+        heap.grownJobs);
+}
+
+size_t ArenaTelemetry::getSerializedSize(const Stats &stats) {
+    return HeaderSize + HeapSize + stats.numModels * ModelSize;
+}
+
+size_t ArenaTelemetry::serialize(const Stats &stats, uint8_t *buf, size_t size) {
+    const HeapStats &heap = stats.heap;
+    StatsMessage msg(buf, size, getSerializedSize(stats), StatsMagic, StatsVersion);
+
+    msg.put(stats.numModels, 4);
+    msg.put(stats.untrackedJobs, 4);
+
+    msg.put(heap.samples, 4);
+    msg.put(heap.used, 4);
+    msg.put(heap.peakUsed, 4);
+    msg.put(heap.free, 4);
+    msg.put(heap.peakFree, 4);
+    msg.put(static_cast<uint32_t>(heap.lastDelta), 4);
+    msg.put(heap.grownJobs, 4);
+
+    for (size_t i = 0; i < stats.numModels; i++) {
+        const ModelStats &m = stats.models[i];
+
+        msg.put(m.modelSize, 4);
+        msg.put(m.modelCrc, 4);
+        msg.put(m.jobs, 4);
+        msg.put(m.arenaSize, 4);
+        msg.put(m.lastUsed, 4);
+        msg.put(m.peakUsed, 4);
+        msg.put(m.peakPersistent, 4);
+        msg.put(m.peakNonPersistent, 4);
+        msg.put(m.peakSlowUsed, 4);
+        msg.put(m.minHeadroom, 4);
+    }
+
+    return msg.size();
+}
+
+} // namespace InferenceProcess
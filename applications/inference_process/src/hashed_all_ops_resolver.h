@@ -0,0 +1,45 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2023 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Resolver with all operators and constant time lookups. Select it with
+ * INFERENCE_PROCESS_OPS_RESOLVER=hashed_all_ops_resolver.h.
+ */
+
+#pragma once
+
+#include "hashed_op_resolver.hpp"
+#include "micro_mutable_all_ops.h"
+
+namespace InferenceProcess {
+
+// Names of the custom operators registered by add_all_ops()
+constexpr const char *kCustomOperators[] = {"ethos-u", "CIRCULAR_BUFFER", "TFLite_Detection_PostProcess"};
+constexpr size_t kNumberCustomOperators  = sizeof(kCustomOperators) / sizeof(kCustomOperators[0]);
+constexpr CustomOpHash<kNumberCustomOperators> kCustomOperatorHash(kCustomOperators);
+
+using HashedAllOpsResolver = HashedOpResolver<tflite::MicroMutableOpResolver<kNumberOperators>, kNumberCustomOperators>;
+
+} // namespace InferenceProcess
+
+// The resolver is built on first use and shared by all interpreters
+inline const InferenceProcess::HashedAllOpsResolver &get_resolver() {
+    static const InferenceProcess::HashedAllOpsResolver resolver(add_all_ops, InferenceProcess::kCustomOperatorHash);
+
+    return resolver;
+}
@@ -23,25 +23,94 @@
 #define STRINGIFY(a)  _STRINGIFY(a)
 #include STRINGIFY(INFERENCE_PROCESS_OPS_RESOLVER)
 #endif
+#include "tensorflow/lite/micro/arena_allocator/single_arena_buffer_allocator.h"
 #include "tensorflow/lite/micro/cortex_m_generic/debug_log_callback.h"
+#include "tensorflow/lite/micro/memory_helpers.h"
+#include "tensorflow/lite/micro/memory_planner/greedy_memory_planner.h"
+#include "tensorflow/lite/micro/micro_arena_constants.h"
+#include "tensorflow/lite/micro/micro_allocator.h"
 #include "tensorflow/lite/micro/micro_interpreter.h"
+#include "tensorflow/lite/micro/micro_resource_variable.h"
 #include "tensorflow/lite/micro/micro_time.h"
 #include "tensorflow/lite/schema/schema_generated.h"
 
+#include "arena_plan.hpp"
 #include "arm_profiler.hpp"
 #include "cmsis_compiler.h"
 #include "crc.hpp"
 #include "ethosu_log.h"
 #include "inference_process.hpp"
+#include "tiered_arena.hpp"
 
+#include <algorithm>
 #include <inttypes.h>
+#include <new>
+#include <optional>
 
 using namespace std;
 
 namespace {
+// Resolver type of the selected resolver header, which may be a reference to a shared resolver
+using OpResolver = decltype(get_resolver());
+
+// Profiler borrowed from a profiler pool for the lifetime of the object
+class ScopedProfiler {
+public:
+    ScopedProfiler(InferenceProcess::ProfilerPool &_pool) : pool(_pool), profiler(pool.Acquire()) {}
+    ScopedProfiler(const ScopedProfiler &)            = delete;
+    ScopedProfiler &operator=(const ScopedProfiler &) = delete;
+
+    ~ScopedProfiler() {
+        if (profiler != nullptr) {
+            pool.Release(profiler);
+        }
+    }
+
+    tflite::ArmProfiler *get() const {
+        return profiler;
+    }
+
+private:
+    InferenceProcess::ProfilerPool &pool;
+    tflite::ArmProfiler *profiler;
+};
+
+// Allocator for an arena, created like MicroAllocator::Create() does, but keeping the arena buffer allocator to read
+// the persistent and non persistent usage. Without planner a GreedyMemoryPlanner is placed in the arena.
+tflite::MicroAllocator *createAllocator(uint8_t *arena,
+                                        size_t size,
+                                        tflite::MicroMemoryPlanner *planner,
+                                        tflite::SingleArenaBufferAllocator *&memory) {
+    uint8_t *aligned = tflite::AlignPointerUp(arena, tflite::MicroArenaBufferAlignment());
+    if (arena == nullptr || aligned >= arena + size) {
+        return nullptr;
+    }
+
+    memory = tflite::SingleArenaBufferAllocator::Create(aligned, arena + size - aligned);
+    if (memory == nullptr) {
+        return nullptr;
+    }
+
+    if (planner == nullptr) {
+        uint8_t *buffer =
+            memory->AllocatePersistentBuffer(sizeof(tflite::GreedyMemoryPlanner), alignof(tflite::GreedyMemoryPlanner));
+        if (buffer == nullptr) {
+            return nullptr;
+        }
+
+        planner = new (buffer) tflite::GreedyMemoryPlanner();
+    }
+
+    return tflite::MicroAllocator::Create(memory, memory, planner);
+}
+
 const char *BASE64 = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
 
 void printBase64(const uint8_t *data, size_t len) {
+#ifdef ETHOSU_LOG_TOKENIZED
+    // The data is logged in binary, and printed in base64 by the decoder
+    ETHOSU_LOG_BASE64(stdout, data, len);
+#else
     size_t count     = len / 3;
     size_t remainder = len % 3;
     char buf[]       = "====";
@@ -61,6 +130,7 @@ void printBase64(const uint8_t *data, size_t len) {
         buf[3]     = '=';
         LOG("%s", buf);
     }
+#endif
 }
 
 } // namespace
@@ -101,6 +171,13 @@ InferenceJob::InferenceJob(const string &_name,
     networkModel(_networkModel), input(_input), output(_output), expectedOutput(_expectedOutput),
     numBytesToPrint(_numBytesToPrint), externalContext(_externalContext) {}
 
+PipelineStage::PipelineStage(const DataPtr &_networkModel,
+                             const DataPtr &_tensorArena,
+                             Glue _glue,
+                             void *_glueContext) :
+    networkModel(_networkModel),
+    tensorArena(_tensorArena), glue(_glue), glueContext(_glueContext) {}
+
 void InferenceJob::invalidate() {
     networkModel.invalidate();
 
@@ -133,8 +210,156 @@ void InferenceJob::clean() {
     }
 }
 
+bool InferenceJob::isPartial() const {
+    return !signature.empty() || subgraph != 0;
+}
+
+class InferenceProcess::Session {
+public:
+    Session(const void *_networkModel,
+            const tflite::Model *model,
+            tflite::MicroAllocator *allocator,
+            const tflite::SingleArenaBufferAllocator *_memory,
+            tflite::MicroResourceVariables *_resourceVariables,
+            ProfilerPool &profilers) :
+        networkModel(_networkModel), memory(_memory), resolver(get_resolver()), profiler(profilers),
+        resourceVariables(_resourceVariables),
+        interpreter(model, resolver, allocator, resourceVariables, profiler.get()) {}
+
+    // Look up the ids of all resource variables referenced by VAR_HANDLE operators. The ids were created when the
+    // VAR_HANDLE operators were prepared, so the lookup returns the same ids the kernels use.
+    void findResourceVariables(const tflite::Model *model) {
+        if (resourceVariables == nullptr) {
+            return;
+        }
+
+        for (auto subgraph : *model->subgraphs()) {
+            if (subgraph->operators() == nullptr) {
+                continue;
+            }
+
+            for (auto op : *subgraph->operators()) {
+                auto opcode = model->operator_codes()->Get(op->opcode_index());
+                if (InferenceParser::getBuiltinCode(opcode) != tflite::BuiltinOperator_VAR_HANDLE) {
+                    continue;
+                }
+
+                auto options = op->builtin_options_as_VarHandleOptions();
+                if (options == nullptr || options->shared_name() == nullptr) {
+                    continue;
+                }
+
+                const char *container = options->container() != nullptr ? options->container()->c_str() : nullptr;
+                const int id = resourceVariables->CreateIdIfNoneFound(container, options->shared_name()->c_str());
+
+                if (id >= 0 && find(variableIds.begin(), variableIds.end(), id) == variableIds.end()) {
+                    variableIds.push_back(id);
+                }
+            }
+        }
+    }
+
+    TfLiteEvalTensor *getVariable(size_t index, size_t &bytes) const {
+        TfLiteEvalTensor *tensor = resourceVariables->GetBufferForId(variableIds[index]);
+
+        if (tensor == nullptr || tensor->data.data == nullptr ||
+            tflite::TfLiteEvalTensorByteLength(tensor, &bytes) != kTfLiteOk) {
+            bytes = 0;
+            return nullptr;
+        }
+
+        return tensor;
+    }
+
+    const void *networkModel;
+    const tflite::SingleArenaBufferAllocator *memory;
+    OpResolver resolver;
+    ScopedProfiler profiler;
+    tflite::MicroResourceVariables *resourceVariables;
+    tflite::MicroInterpreter interpreter;
+    vector<int> variableIds;
+};
+
+class InferenceProcess::ModelSlot {
+public:
+    ModelSlot(const DataPtr &_networkModel,
+              const tflite::Model *model,
+              tflite::MicroAllocator *allocator,
+              const tflite::SingleArenaBufferAllocator *_memory,
+              size_t _arenaSize) :
+        networkModel(_networkModel),
+        memory(_memory), arenaSize(_arenaSize), resolver(get_resolver()),
+        interpreter(model, resolver, allocator, nullptr, &profiler), inFlight(0), retiring(false) {}
+
+    DataPtr networkModel;
+    const tflite::SingleArenaBufferAllocator *memory;
+    size_t arenaSize;
+    OpResolver resolver;
+    tflite::StaticArmProfiler<INFERENCE_PROCESS_PROFILER_MAX_EVENTS> profiler;
+    tflite::MicroInterpreter interpreter;
+    std::atomic<uint32_t> inFlight;
+    std::atomic<bool> retiring;
+};
+
+// Interpreters of the stages of a pipeline. The storage is kept between runs, and only grows for a pipeline with more
+// stages. The interpreters are constructed in place for every run.
+class InferenceProcess::PipelineInterpreters {
+public:
+    struct Stage {
+        Stage(const tflite::Model *model, const DataPtr &arena, ProfilerPool &profilers) :
+            resolver(get_resolver()), profiler(profilers),
+            interpreter(
+                model, resolver, reinterpret_cast<uint8_t *>(arena.data), arena.size, nullptr, profiler.get()) {}
+
+        OpResolver resolver;
+        ScopedProfiler profiler;
+        tflite::MicroInterpreter interpreter;
+    };
+
+    PipelineInterpreters() : capacity(0), count(0) {}
+
+    void reserve(size_t numStages) {
+        if (numStages > capacity) {
+            clear();
+            stages   = make_unique<std::optional<Stage>[]>(numStages);
+            capacity = numStages;
+        }
+    }
+
+    // Construct the interpreter of the next stage, within the reserved number of stages
+    Stage &add(const tflite::Model *model, const DataPtr &arena, ProfilerPool &profilers) {
+        return stages[count++].emplace(model, arena, profilers);
+    }
+
+    // Destroy the interpreters, which returns their profilers to the pool
+    void clear() {
+        for (size_t i = 0; i < count; ++i) {
+            stages[i].reset();
+        }
+
+        count = 0;
+    }
+
+    Stage &operator[](size_t i) {
+        return *stages[i];
+    }
+
+    size_t size() const {
+        return count;
+    }
+
+private:
+    std::unique_ptr<std::optional<Stage>[]> stages;
+    size_t capacity;
+    size_t count;
+};
+
 InferenceProcess::InferenceProcess(uint8_t *_tensorArena, size_t _tensorArenaSize) :
-    tensorArena(_tensorArena), tensorArenaSize(_tensorArenaSize) {}
+    tensorArena(_tensorArena), tensorArenaSize(_tensorArenaSize), arenaUsedBytes(0), arenaPlanModel(),
+    arenaPolicy(ArenaPlacement::SIZE), slowArenaUsedBytes(0), jobArena(), jobModel(), accessProfileModel(nullptr),
+    activeSlot(nullptr), slotState(0) {}
+
+InferenceProcess::~InferenceProcess() = default;
 
 bool InferenceProcess::runJob(InferenceJob &job) {
     LOG_INFO("Running inference job: %s", job.name.c_str());
@@ -142,6 +367,128 @@ bool InferenceProcess::runJob(InferenceJob &job) {
     // Register debug log callback for profiling
     RegisterDebugLogCallback(tfluDebugLog);
 
+    size_t heapBefore, heapFree;
+    const bool heapUnknown = inference_process_get_heap_usage(&heapBefore, &heapFree);
+
+    jobArena          = ArenaTelemetry::ArenaUsage();
+    jobModel          = job.networkModel;
+    const bool failed = dispatchJob(job);
+
+    // Jobs that did not run an interpreter, for example result cache hits, use no arena
+    if (jobArena.size > 0) {
+        telemetry.recordArena(jobModel.data, jobModel.size, jobArena);
+    }
+
+    size_t heapAfter;
+    if (!heapUnknown && !inference_process_get_heap_usage(&heapAfter, &heapFree)) {
+        telemetry.recordHeap(heapBefore, heapAfter, heapFree);
+    }
+
+    return failed;
+}
+
+bool InferenceProcess::dispatchJob(InferenceJob &job) {
+    // Reuse the interpreter of an open session
+    if (session) {
+        if (session->networkModel != job.networkModel.data) {
+            LOG_ERR("Job network model does not match open session: job=%s", job.name.c_str());
+            return true;
+        }
+
+        if (job.isPartial()) {
+            LOG_ERR("Sessions do not support partial jobs: job=%s", job.name.c_str());
+            return true;
+        }
+
+        if (session->profiler.get() != nullptr) {
+            session->profiler.get()->ClearEvents();
+        }
+
+        setJobArena(tensorArenaSize, session->memory);
+
+        return runInterpreter(job, session->interpreter, session->profiler.get());
+    }
+
+    // Serve jobs without network model from the active model slot
+    if (job.networkModel.data == nullptr && activeSlot.load() != nullptr) {
+        if (job.isPartial()) {
+            LOG_ERR("Model slots do not support partial jobs: job=%s", job.name.c_str());
+            return true;
+        }
+
+        return runSlotJob(job);
+    }
+
+    // The cache key does not cover the signature or subgraph
+    if (!resultCache.isEnabled() || !job.expectedOutput.empty() || job.isPartial()) {
+        return runModel(job);
+    }
+
+    // Return the outputs of an earlier job with the same inputs
+    const uint32_t crc = resultCache.checksum(job);
+
+    if (resultCache.lookup(job, crc)) {
+        LOG_INFO("Result cache hit: job=%s, hits=%" PRIu32 "/%" PRIu32 ", hash=%" PRIu64 " cycles total",
+                 job.name.c_str(),
+                 resultCache.getStats().hits,
+                 resultCache.getStats().lookups,
+                 resultCache.getStats().hashCycles);
+
+        return false;
+    }
+
+    if (runModel(job)) {
+        return true;
+    }
+
+    resultCache.insert(job, crc);
+
+    return false;
+}
+
+bool InferenceProcess::runSlotJob(InferenceJob &job) {
+    ModelSlot *slot;
+
+    // Hold the slot, and retry if a swap got in between. The standby slot can not be prepared during the lookup.
+    slotState++;
+
+    while (true) {
+        slot = activeSlot.load();
+        slot->inFlight++;
+
+        if (activeSlot.load() == slot) {
+            break;
+        }
+
+        releaseSlot(slot);
+    }
+
+    slotState--;
+
+    // The job belongs to the caller, the model that served it is only recorded
+    jobModel = slot->networkModel;
+    slot->profiler.ClearEvents();
+    setJobArena(slot->arenaSize, slot->memory);
+
+    const bool failed = runInterpreter(job, slot->interpreter, &slot->profiler);
+
+    releaseSlot(slot);
+
+    return failed;
+}
+
+void InferenceProcess::releaseSlot(ModelSlot *slot) {
+    // The last job in flight on a retiring slot completes the swap
+    if (--slot->inFlight == 0 && slot->retiring.exchange(false)) {
+        swapStats.swapCycles = tflite::GetCurrentTimeTicks() - swapStats.swapStart;
+
+        LOG_INFO("Model swap completed: latency=%" PRIu32 " cycles, waited_jobs=%" PRIu32,
+                 swapStats.swapCycles.load(),
+                 swapStats.waitedJobs.load());
+    }
+}
+
+bool InferenceProcess::runModel(InferenceJob &job) {
     // Get model handle and verify that the version is correct
     const tflite::Model *model = parser.getModel(job.networkModel.data, job.networkModel.size);
     if (model == nullptr) {
@@ -149,10 +496,75 @@ bool InferenceProcess::runJob(InferenceJob &job) {
         return true;
     }
 
+    // Narrow a copy of the model down to the signature or subgraph of the job. The copy is placed at the start of the
+    // tensor arena, and the interpreter gets the rest. The copy is reused by the following partial jobs for the same
+    // selection, until a job uses the start of the tensor arena for something else.
+    uint8_t *arena   = tensorArena;
+    size_t arenaSize = tensorArenaSize;
+    if (!job.isPartial()) {
+        modelView.reset();
+    } else if (!modelView.matches(job.networkModel.data, job.networkModel.size, job.signature.c_str(), job.subgraph)) {
+        if (modelView.select(job.networkModel.data,
+                             job.networkModel.size,
+                             job.signature.c_str(),
+                             job.subgraph,
+                             tensorArena,
+                             tensorArenaSize)) {
+            LOG_ERR("Failed to select signature or subgraph: job=%s, signature=%s, subgraph=%zu",
+                    job.name.c_str(),
+                    job.signature.c_str(),
+                    job.subgraph);
+            return true;
+        }
+    }
+
+    if (modelView.isSelected()) {
+        LOG_INFO("Running subgraph: job=%s, subgraph=%zu, operators=%zu, skipped=%zu",
+                 job.name.c_str(),
+                 modelView.getSubGraph(),
+                 modelView.getNumOperators(),
+                 modelView.getNumSkippedOperators());
+
+        model = modelView.getModel();
+        arena += modelView.getSize();
+        arenaSize -= modelView.getSize();
+    }
+
     // Create the TFL micro interpreter
-    tflite::MicroMutableOpResolver<kNumberOperators> resolver = get_resolver();
-    tflite::ArmProfiler profiler;
-    tflite::MicroInterpreter interpreter(model, resolver, tensorArena, tensorArenaSize, nullptr, &profiler);
+    OpResolver resolver = get_resolver();
+    ScopedProfiler profiler(profilers);
+
+    // Restore the memory plan captured for the model instead of planning
+    if (arenaPlan.data != nullptr && arenaPlanModel.data == job.networkModel.data &&
+        arenaPlanModel.size == job.networkModel.size && !job.isPartial()) {
+        ArenaPlanPlanner planner(arenaPlan.data);
+        tflite::SingleArenaBufferAllocator *memory = nullptr;
+        tflite::MicroAllocator *allocator          = createAllocator(tensorArena, tensorArenaSize, &planner, memory);
+
+        if (allocator != nullptr) {
+            tflite::MicroInterpreter interpreter(model, resolver, allocator, nullptr, profiler.get());
+
+            if (interpreter.AllocateTensors() == kTfLiteOk) {
+                setJobArena(tensorArenaSize, memory);
+                return runInterpreter(job, interpreter, profiler.get());
+            }
+        }
+
+        LOG_WARN("Failed to restore arena plan, planning memory: job=%s", job.name.c_str());
+    }
+
+    if (slowArena.data != nullptr) {
+        return runTieredJob(job, model, resolver, profiler.get(), arena, arenaSize);
+    }
+
+    tflite::SingleArenaBufferAllocator *memory = nullptr;
+    tflite::MicroAllocator *allocator          = createAllocator(arena, arenaSize, nullptr, memory);
+    if (allocator == nullptr) {
+        LOG_ERR("Failed to create allocator for inference: job=%s", job.name.c_str());
+        return true;
+    }
+
+    tflite::MicroInterpreter interpreter(model, resolver, allocator, nullptr, profiler.get());
 
     // Allocate tensors
     TfLiteStatus status = interpreter.AllocateTensors();
@@ -161,6 +573,17 @@ bool InferenceProcess::runJob(InferenceJob &job) {
         return true;
     }
 
+    setJobArena(arenaSize, memory);
+
+    return runInterpreter(job, interpreter, profiler.get());
+}
+
+bool InferenceProcess::runInterpreter(InferenceJob &job,
+                                      tflite::MicroInterpreter &interpreter,
+                                      tflite::ArmProfiler *profiler) {
+    arenaUsedBytes     = interpreter.arena_used_bytes();
+    slowArenaUsedBytes = 0;
+
     // Set external context
     if (job.externalContext != nullptr) {
         interpreter.SetMicroExternalContext(job.externalContext);
@@ -175,7 +598,7 @@ bool InferenceProcess::runJob(InferenceJob &job) {
     uint32_t cpuCyclesBegin = tflite::GetCurrentTimeTicks();
 
     // Run the inference
-    status = interpreter.Invoke();
+    TfLiteStatus status = interpreter.Invoke();
 
     // Calculate nbr of CPU cycles for the Invoke call
     job.cpuCycles = tflite::GetCurrentTimeTicks() - cpuCyclesBegin;
@@ -200,16 +623,709 @@ bool InferenceProcess::runJob(InferenceJob &job) {
     LOG_INFO("\n");
     LOG_INFO("Finished running job: %s", job.name.c_str());
 
-    profiler.ReportResults();
+    if (profiler != nullptr) {
+        profiler->ReportResults();
 
-    LOG("\n");
-    LOG("Operator(s) total: %" PRIu64 " CPU cycles\n\n", profiler.GetTotalTicks());
+        LOG("\n");
+        LOG("Operator(s) total: %" PRIu64 " CPU cycles\n\n", profiler->GetTotalTicks());
+    }
 
     LOG("Inference runtime: %" PRIu64 " CPU cycles total\n\n", job.cpuCycles);
 
     return false;
 }
 
+bool InferenceProcess::runTieredJob(InferenceJob &job,
+                                    const tflite::Model *model,
+                                    const tflite::MicroOpResolver &resolver,
+                                    tflite::ArmProfiler *profiler,
+                                    uint8_t *arena,
+                                    size_t arenaSize) {
+    // The operators of partial jobs do not match the profile of the model
+    const bool profiled = accessProfileModel == job.networkModel.data && !job.isPartial();
+    TieredMemoryPlanner planner(arena,
+                                arenaSize,
+                                arenaPolicy,
+                                profiled ? accessProfile.data() : nullptr,
+                                profiled ? accessProfile.size() : 0);
+
+    tflite::MicroAllocator *allocator = planner.createAllocator(static_cast<uint8_t *>(slowArena.data), slowArena.size);
+    if (allocator == nullptr) {
+        LOG_ERR("Failed to create allocator for slow arena: job=%s", job.name.c_str());
+        return true;
+    }
+
+    tflite::MicroInterpreter interpreter(model, resolver, allocator, nullptr, profiler);
+
+    if (interpreter.AllocateTensors() != kTfLiteOk) {
+        LOG_ERR("Failed to allocate tensors for inference: job=%s", job.name.c_str());
+        return true;
+    }
+
+    const bool failed = runInterpreter(job, interpreter, profiler);
+
+    const ArenaPlacement &placement = planner.getPlacement();
+    arenaUsedBytes                  = planner.getFastUsedBytes();
+    slowArenaUsedBytes              = planner.getSlowUsedBytes();
+
+    // The spilled buffers are planned buffers, allocated in one persistent buffer of the slow arena
+    const size_t spilled = std::min(placement.getSlowUsedBytes(), slowArenaUsedBytes);
+
+    jobArena.size          = arenaSize + slowArena.size;
+    jobArena.persistent    = slowArenaUsedBytes - spilled;
+    jobArena.nonPersistent = arenaUsedBytes + spilled;
+    jobArena.slowUsed      = slowArenaUsedBytes;
+
+    LOG_INFO("Arena usage: fast=%zu/%zu, slow=%zu/%zu, spilled=%zu/%zu buffers",
+             arenaUsedBytes,
+             arenaSize,
+             slowArenaUsedBytes,
+             slowArena.size,
+             placement.getSpilledCount(),
+             placement.getBuffers().size());
+
+    // Keep the operator ticks as access frequency for the next job
+    if (!failed && profiler != nullptr && !job.isPartial()) {
+        accessProfileModel = job.networkModel.data;
+        accessProfile.resize(profiler->GetNumEvents());
+
+        for (size_t i = 0; i < accessProfile.size(); ++i) {
+            accessProfile[i] = profiler->GetEventTicks(i);
+        }
+    }
+
+    return failed;
+}
+
+bool InferenceProcess::runPipeline(InferenceJob &job, vector<PipelineStage> &stages) {
+    LOG_INFO("Running inference pipeline: %s, stages=%zu", job.name.c_str(), stages.size());
+
+    if (stages.empty()) {
+        LOG_ERR("Pipeline has no stages: job=%s", job.name.c_str());
+        return true;
+    }
+
+    if (session) {
+        LOG_ERR("Pipelines can not run while a session is open: job=%s", job.name.c_str());
+        return true;
+    }
+
+    // Register debug log callback for profiling
+    RegisterDebugLogCallback(tfluDebugLog);
+
+    if (!pipeline) {
+        pipeline = make_unique<PipelineInterpreters>();
+    }
+
+    // The interpreters live until the run ends
+    struct Release {
+        PipelineInterpreters &interpreters;
+
+        ~Release() {
+            interpreters.clear();
+        }
+    } release{*pipeline};
+
+    PipelineInterpreters &interpreters = *pipeline;
+    interpreters.reserve(stages.size());
+
+    // Create and allocate all interpreters up front, so that a failing stage is detected before any inference runs
+    for (size_t i = 0; i < stages.size(); ++i) {
+        const tflite::Model *model = parser.getModel(stages[i].networkModel.data, stages[i].networkModel.size);
+        if (model == nullptr) {
+            LOG_ERR("Invalid model: job=%s, stage=%zu", job.name.c_str(), i);
+            return true;
+        }
+
+        if (stages[i].tensorArena.data == nullptr) {
+            LOG_ERR("Missing tensor arena: job=%s, stage=%zu", job.name.c_str(), i);
+            return true;
+        }
+
+        PipelineInterpreters::Stage &stage = interpreters.add(model, stages[i].tensorArena, profilers);
+
+        if (stage.interpreter.AllocateTensors() != kTfLiteOk) {
+            LOG_ERR("Failed to allocate tensors for inference: job=%s, stage=%zu", job.name.c_str(), i);
+            return true;
+        }
+    }
+
+    tflite::MicroInterpreter &first = interpreters[0].interpreter;
+    tflite::MicroInterpreter &last  = interpreters[interpreters.size() - 1].interpreter;
+
+    if (job.externalContext != nullptr) {
+        for (size_t i = 0; i < interpreters.size(); ++i) {
+            interpreters[i].interpreter.SetMicroExternalContext(job.externalContext);
+        }
+    }
+
+    if (copyIfm(job, first)) {
+        return true;
+    }
+
+    job.cpuCycles = 0;
+
+    for (size_t i = 0; i < interpreters.size(); ++i) {
+        if (i > 0 && transferTensors(stages[i - 1], interpreters[i - 1].interpreter, interpreters[i].interpreter)) {
+            LOG_ERR("Failed to transfer tensors between stages: job=%s, stage=%zu", job.name.c_str(), i);
+            return true;
+        }
+
+        uint32_t cpuCyclesBegin = tflite::GetCurrentTimeTicks();
+        TfLiteStatus status     = interpreters[i].interpreter.Invoke();
+        job.cpuCycles += tflite::GetCurrentTimeTicks() - cpuCyclesBegin;
+
+        if (status != kTfLiteOk) {
+            LOG_ERR("Invoke failed for inference: job=%s, stage=%zu", job.name.c_str(), i);
+            return true;
+        }
+    }
+
+    if (copyOfm(job, last)) {
+        return true;
+    }
+
+    printJob(job, last);
+
+    if (compareOfm(job, last)) {
+        return true;
+    }
+
+    LOG_INFO("\n");
+    LOG_INFO("Finished running pipeline: %s", job.name.c_str());
+
+    for (size_t i = 0; i < interpreters.size(); ++i) {
+        const tflite::ArmProfiler *profiler = interpreters[i].profiler.get();
+        if (profiler != nullptr) {
+            LOG("Stage %zu operator(s) total: %" PRIu64 " CPU cycles\n", i, profiler->GetTotalTicks());
+        }
+    }
+
+    LOG("Inference runtime: %" PRIu64 " CPU cycles total\n\n", job.cpuCycles);
+
+    return false;
+}
+
+bool InferenceProcess::captureArenaPlan(const DataPtr &networkModel, void *plan, size_t &planSize) {
+    if (session) {
+        LOG_ERR("Arena plan can not be captured while a session is open");
+        return true;
+    }
+
+    const tflite::Model *model = parser.getModel(networkModel.data, networkModel.size);
+    if (model == nullptr) {
+        LOG_ERR("Invalid model");
+        return true;
+    }
+
+    modelView.reset();
+
+    ArenaPlanRecorder recorder;
+    tflite::MicroAllocator *allocator = tflite::MicroAllocator::Create(tensorArena, tensorArenaSize, &recorder);
+    if (allocator == nullptr) {
+        LOG_ERR("Failed to create allocator for arena plan");
+        return true;
+    }
+
+    OpResolver resolver = get_resolver();
+    tflite::MicroInterpreter interpreter(model, resolver, allocator);
+
+    if (interpreter.AllocateTensors() != kTfLiteOk) {
+        LOG_ERR("Failed to allocate tensors for arena plan");
+        return true;
+    }
+
+    constexpr auto crc   = Crc();
+    const uint32_t crc32 = crc.crc32(networkModel.data, networkModel.size);
+    if (recorder.serialize(crc32, networkModel.size, tensorArenaSize, plan, planSize)) {
+        return true;
+    }
+
+    LOG("\"arena_plan\": \"");
+    printBase64(static_cast<const uint8_t *>(plan), planSize);
+    LOG("\"\n");
+
+    return false;
+}
+
+bool InferenceProcess::setArenaPlan(const DataPtr &networkModel, const DataPtr &plan) {
+    arenaPlanModel = DataPtr();
+    arenaPlan      = DataPtr();
+
+    if (plan.data == nullptr) {
+        return false;
+    }
+
+    if (ArenaPlanPlanner::validate(plan.data, plan.size, networkModel.data, networkModel.size, tensorArenaSize)) {
+        return true;
+    }
+
+    arenaPlanModel = networkModel;
+    arenaPlan      = plan;
+
+    return false;
+}
+
+bool InferenceProcess::setSlowArena(const DataPtr &_slowArena, ArenaPlacement::Policy policy) {
+    slowArena          = _slowArena;
+    arenaPolicy        = policy;
+    accessProfileModel = nullptr;
+    accessProfile.clear();
+
+    if (slowArena.data != nullptr && slowArena.size == 0) {
+        LOG_ERR("Invalid slow arena");
+        slowArena = DataPtr();
+        return true;
+    }
+
+    return false;
+}
+
+void InferenceProcess::setResultCache(size_t maxEntries,
+                                      size_t maxBytes,
+                                      ResultCache::Eviction eviction,
+                                      uint8_t ignoreBits) {
+    resultCache.configure(maxEntries, maxBytes, eviction, ignoreBits);
+}
+
+const ResultCache::Stats &InferenceProcess::getResultCacheStats() const {
+    return resultCache.getStats();
+}
+
+void InferenceProcess::invalidateResultCache(const DataPtr &networkModel) {
+    resultCache.invalidate(networkModel.data);
+}
+
+void InferenceProcess::invalidateModel(const DataPtr &networkModel) {
+    resultCache.invalidate(networkModel.data);
+
+    if (modelView.isCopyOf(networkModel.data)) {
+        modelView.reset();
+    }
+
+    // The plan was validated against the CRC of the previous contents
+    if (arenaPlanModel.data == networkModel.data) {
+        arenaPlanModel = DataPtr();
+        arenaPlan      = DataPtr();
+    }
+}
+
+void InferenceProcess::clearResultCache() {
+    resultCache.clear();
+}
+
+bool InferenceProcess::prepareModel(const DataPtr &networkModel, const DataPtr &arena) {
+    const uint32_t start = tflite::GetCurrentTimeTicks();
+
+    // Lock the slots only if no lookup is in progress, which could still be holding the standby slot. The active slot
+    // does not change while locked, so later lookups do not see the standby slot.
+    uint32_t state = 0;
+    if (!slotState.compare_exchange_strong(state, SlotsLocked)) {
+        LOG_ERR("Standby model slot busy");
+        return true;
+    }
+
+    // Jobs can only leave the standby slot while locked
+    std::unique_ptr<ModelSlot> &standby = slots[slots[0].get() == activeSlot.load() ? 1 : 0];
+    if (standby && (standby->inFlight > 0 || standby->retiring)) {
+        LOG_ERR("Standby model slot busy");
+        slotState &= ~SlotsLocked;
+        return true;
+    }
+
+    standby.reset();
+
+    const bool failed = prepareSlot(networkModel, arena, standby);
+    if (!failed) {
+        swapStats.prepareCycles = tflite::GetCurrentTimeTicks() - start;
+
+        LOG_INFO("Prepared model: inputs=%zu, outputs=%zu, arena_used_bytes=%zu, cycles=%" PRIu32,
+                 standby->interpreter.inputs_size(),
+                 standby->interpreter.outputs_size(),
+                 standby->interpreter.arena_used_bytes(),
+                 swapStats.prepareCycles.load());
+    }
+
+    slotState &= ~SlotsLocked;
+
+    return failed;
+}
+
+bool InferenceProcess::prepareSlot(const DataPtr &networkModel,
+                                   const DataPtr &arena,
+                                   std::unique_ptr<ModelSlot> &standby) {
+    // Jobs may use the shared parser concurrently
+    InferenceParser slotParser;
+
+    const tflite::Model *model = slotParser.getModel(networkModel.data, networkModel.size);
+    if (model == nullptr) {
+        LOG_ERR("Invalid model");
+        return true;
+    }
+
+    tflite::SingleArenaBufferAllocator *memory = nullptr;
+    tflite::MicroAllocator *allocator =
+        createAllocator(static_cast<uint8_t *>(arena.data), arena.size, nullptr, memory);
+    if (allocator == nullptr) {
+        LOG_ERR("Failed to create allocator for model slot");
+        return true;
+    }
+
+    auto slot = make_unique<ModelSlot>(networkModel, model, allocator, memory, arena.size);
+
+    if (slot->interpreter.AllocateTensors() != kTfLiteOk) {
+        LOG_ERR("Failed to allocate tensors for model slot");
+        return true;
+    }
+
+    standby = std::move(slot);
+
+    return false;
+}
+
+bool InferenceProcess::swapModel() {
+    if (slotState.fetch_or(SlotsLocked) & SlotsLocked) {
+        LOG_ERR("Model slots busy");
+        return true;
+    }
+
+    ModelSlot *standby = slots[slots[0].get() == activeSlot.load() ? 1 : 0].get();
+    if (standby == nullptr || standby->inFlight > 0 || standby->retiring) {
+        LOG_ERR("No prepared model to swap to");
+        slotState &= ~SlotsLocked;
+        return true;
+    }
+
+    swapStats.swapStart = tflite::GetCurrentTimeTicks();
+    ModelSlot *old      = activeSlot.exchange(standby);
+
+    swapStats.swaps++;
+    swapStats.waitedJobs = 0;
+
+    if (old == nullptr) {
+        swapStats.swapCycles = tflite::GetCurrentTimeTicks() - swapStats.swapStart;
+        slotState &= ~SlotsLocked;
+        return false;
+    }
+
+    // The last job in flight on the previous slot completes the swap, or the swap completes right away
+    const uint32_t waitedJobs = old->inFlight;
+    swapStats.waitedJobs      = waitedJobs;
+    swapStats.totalWaitedJobs += waitedJobs;
+    old->retiring = true;
+
+    old->inFlight++;
+    releaseSlot(old);
+
+    slotState &= ~SlotsLocked;
+
+    return false;
+}
+
+ModelSwapStats InferenceProcess::getModelSwapStats() const {
+    ModelSwapStats stats;
+
+    stats.swaps           = swapStats.swaps;
+    stats.prepareCycles   = swapStats.prepareCycles;
+    stats.swapCycles      = swapStats.swapCycles;
+    stats.waitedJobs      = swapStats.waitedJobs;
+    stats.totalWaitedJobs = swapStats.totalWaitedJobs;
+
+    return stats;
+}
+
+size_t InferenceProcess::getArenaSize() const {
+    return tensorArenaSize;
+}
+
+size_t InferenceProcess::getArenaUsedBytes() const {
+    return arenaUsedBytes;
+}
+
+size_t InferenceProcess::getSlowArenaUsedBytes() const {
+    return slowArenaUsedBytes;
+}
+
+const ArenaTelemetry::Stats &InferenceProcess::getArenaTelemetry() const {
+    return telemetry.getStats();
+}
+
+void InferenceProcess::clearArenaTelemetry() {
+    telemetry.clear();
+}
+
+void InferenceProcess::setJobArena(size_t size, const tflite::SingleArenaBufferAllocator *memory) {
+    jobArena.size          = size;
+    jobArena.persistent    = memory->GetPersistentUsedBytes();
+    jobArena.nonPersistent = memory->GetNonPersistentUsedBytes();
+    jobArena.slowUsed      = 0;
+}
+
+bool InferenceProcess::transferTensors(const PipelineStage &stage,
+                                       tflite::MicroInterpreter &producer,
+                                       tflite::MicroInterpreter &consumer) {
+    if (producer.outputs_size() != consumer.inputs_size()) {
+        LOG_ERR("Number of tensors mismatch: outputs=%zu, inputs=%zu",
+                static_cast<size_t>(producer.outputs_size()),
+                static_cast<size_t>(consumer.inputs_size()));
+        return true;
+    }
+
+    for (size_t i = 0; i < producer.outputs_size(); ++i) {
+        const TfLiteTensor *output = producer.output(i);
+        TfLiteTensor *input        = consumer.input(i);
+
+        if (output == nullptr || input == nullptr) {
+            return true;
+        }
+
+        if (stage.glue != nullptr) {
+            if (stage.glue(*output, *input, stage.glueContext)) {
+                return true;
+            }
+
+            continue;
+        }
+
+        if (output->type != input->type || output->bytes != input->bytes) {
+            LOG_ERR("Tensor type or size mismatch: index=%zu, output=%zu, input=%zu", i, output->bytes, input->bytes);
+            return true;
+        }
+
+        copy(output->data.uint8, output->data.uint8 + output->bytes, input->data.uint8);
+    }
+
+    return false;
+}
+
+bool cropTensor(const TfLiteTensor &output, TfLiteTensor &input, void *context) {
+    const CropWindow *window = static_cast<const CropWindow *>(context);
+
+    if (window == nullptr || output.dims == nullptr || input.dims == nullptr || output.dims->size != 4 ||
+        input.dims->size != 4 || output.type != input.type) {
+        LOG_ERR("Crop requires two NHWC tensors of the same type and a crop window");
+        return true;
+    }
+
+    for (int32_t i = 0; i < 4; ++i) {
+        if (output.dims->data[i] <= 0 || input.dims->data[i] <= 0) {
+            LOG_ERR("Crop requires tensors without empty dimensions");
+            return true;
+        }
+    }
+
+    const int32_t batches = input.dims->data[0];
+    const int32_t height  = input.dims->data[1];
+    const int32_t width   = input.dims->data[2];
+    const int32_t depth   = input.dims->data[3];
+
+    const int32_t srcHeight = output.dims->data[1];
+    const int32_t srcWidth  = output.dims->data[2];
+
+    if (output.dims->data[0] != batches || output.dims->data[3] != depth || window->top < 0 || window->left < 0 ||
+        window->top + height > srcHeight || window->left + width > srcWidth) {
+        LOG_ERR("Crop window out of bounds: top=%" PRId32 ", left=%" PRId32 ", height=%" PRId32 ", width=%" PRId32,
+                window->top,
+                window->left,
+                height,
+                width);
+        return true;
+    }
+
+    const size_t elements    = static_cast<size_t>(batches) * height * width * depth;
+    const size_t elementSize = input.bytes / elements;
+
+    if (elementSize == 0 || input.bytes != elements * elementSize ||
+        output.bytes != static_cast<size_t>(batches) * srcHeight * srcWidth * depth * elementSize) {
+        LOG_ERR("Crop tensor sizes do not match their dimensions: output=%zu, input=%zu",
+                static_cast<size_t>(output.bytes),
+                static_cast<size_t>(input.bytes));
+        return true;
+    }
+
+    const size_t rowBytes = elementSize * width * depth;
+    const uint8_t *src    = output.data.uint8;
+    uint8_t *dst          = input.data.uint8;
+
+    for (int32_t n = 0; n < batches; ++n) {
+        for (int32_t y = 0; y < height; ++y) {
+            const size_t offset = ((static_cast<size_t>(n) * srcHeight + window->top + y) * srcWidth + window->left) *
+                                  depth * elementSize;
+            copy(src + offset, src + offset + rowBytes, dst);
+            dst += rowBytes;
+        }
+    }
+
+    return false;
+}
+
+bool requantizeTensor(const TfLiteTensor &output, TfLiteTensor &input, void *context) {
+    (void)context;
+
+    const bool isSupported = (output.type == kTfLiteInt8 || output.type == kTfLiteUInt8) &&
+                             (input.type == kTfLiteInt8 || input.type == kTfLiteUInt8);
+
+    if (!isSupported || output.bytes != input.bytes || input.params.scale == 0.0f) {
+        LOG_ERR("Requantize requires int8 or uint8 tensors of the same size");
+        return true;
+    }
+
+    const float scale   = output.params.scale / input.params.scale;
+    const int32_t min   = input.type == kTfLiteInt8 ? INT8_MIN : 0;
+    const int32_t max   = input.type == kTfLiteInt8 ? INT8_MAX : UINT8_MAX;
+    const bool isSigned = output.type == kTfLiteInt8;
+
+    for (size_t i = 0; i < output.bytes; ++i) {
+        const int32_t q     = isSigned ? output.data.int8[i] : output.data.uint8[i];
+        const float real    = static_cast<float>(q - output.params.zero_point) * scale;
+        int32_t value       = static_cast<int32_t>(real >= 0.0f ? real + 0.5f : real - 0.5f) + input.params.zero_point;
+        value               = std::min(std::max(value, min), max);
+        input.data.uint8[i] = static_cast<uint8_t>(value);
+    }
+
+    return false;
+}
+
+bool InferenceProcess::openSession(const DataPtr &networkModel) {
+    closeSession();
+
+    const tflite::Model *model = parser.getModel(networkModel.data, networkModel.size);
+    if (model == nullptr) {
+        LOG_ERR("Invalid model");
+        return true;
+    }
+
+    modelView.reset();
+
+    tflite::SingleArenaBufferAllocator *memory = nullptr;
+    tflite::MicroAllocator *allocator          = createAllocator(tensorArena, tensorArenaSize, nullptr, memory);
+    if (allocator == nullptr) {
+        LOG_ERR("Failed to create allocator for session");
+        return true;
+    }
+
+    // Reserve one resource variable per VAR_HANDLE operator
+    const int numVariables = static_cast<int>(parser.getOperatorCount(model, tflite::BuiltinOperator_VAR_HANDLE));
+
+    tflite::MicroResourceVariables *resourceVariables = nullptr;
+    if (numVariables > 0) {
+        resourceVariables = tflite::MicroResourceVariables::Create(allocator, numVariables);
+        if (resourceVariables == nullptr) {
+            LOG_ERR("Failed to create resource variables for session: variables=%d", numVariables);
+            return true;
+        }
+    }
+
+    session = make_unique<Session>(networkModel.data, model, allocator, memory, resourceVariables, profilers);
+
+    if (session->interpreter.AllocateTensors() != kTfLiteOk) {
+        LOG_ERR("Failed to allocate tensors for session");
+        session.reset();
+        return true;
+    }
+
+    session->findResourceVariables(model);
+
+    LOG_INFO("Opened session: resource_variables=%zu, state_bytes=%zu",
+             session->variableIds.size(),
+             getSessionStateSize());
+
+    return false;
+}
+
+void InferenceProcess::closeSession() {
+    session.reset();
+}
+
+bool InferenceProcess::isSessionOpen() const {
+    return session != nullptr;
+}
+
+bool InferenceProcess::resetSession() {
+    if (!session) {
+        LOG_ERR("No open session");
+        return true;
+    }
+
+    if (session->interpreter.Reset() != kTfLiteOk) {
+        LOG_ERR("Failed to reset session interpreter");
+        return true;
+    }
+
+    if (session->resourceVariables != nullptr && session->resourceVariables->ResetAll() != kTfLiteOk) {
+        LOG_ERR("Failed to reset session resource variables");
+        return true;
+    }
+
+    return false;
+}
+
+size_t InferenceProcess::getSessionStateSize() const {
+    size_t size = 0;
+
+    if (!session) {
+        return 0;
+    }
+
+    for (size_t i = 0; i < session->variableIds.size(); ++i) {
+        size_t bytes;
+        session->getVariable(i, bytes);
+        size += bytes;
+    }
+
+    return size;
+}
+
+bool InferenceProcess::saveSessionState(DataPtr &state) const {
+    if (!session) {
+        LOG_ERR("No open session");
+        return true;
+    }
+
+    if (state.size < getSessionStateSize()) {
+        LOG_ERR("Session state buffer too small: size=%zu, required=%zu", state.size, getSessionStateSize());
+        return true;
+    }
+
+    char *dst = state.begin();
+    for (size_t i = 0; i < session->variableIds.size(); ++i) {
+        size_t bytes;
+        const TfLiteEvalTensor *tensor = session->getVariable(i, bytes);
+
+        if (tensor != nullptr) {
+            copy(tensor->data.raw, tensor->data.raw + bytes, dst);
+            dst += bytes;
+        }
+    }
+
+    return false;
+}
+
+bool InferenceProcess::restoreSessionState(const DataPtr &state) {
+    if (!session) {
+        LOG_ERR("No open session");
+        return true;
+    }
+
+    if (state.size < getSessionStateSize()) {
+        LOG_ERR("Session state buffer too small: size=%zu, required=%zu", state.size, getSessionStateSize());
+        return true;
+    }
+
+    const char *src = state.begin();
+    for (size_t i = 0; i < session->variableIds.size(); ++i) {
+        size_t bytes;
+        TfLiteEvalTensor *tensor = session->getVariable(i, bytes);
+
+        if (tensor != nullptr) {
+            copy(src, src + bytes, tensor->data.raw);
+            src += bytes;
+        }
+    }
+
+    return false;
+}
+
 bool InferenceProcess::copyIfm(InferenceJob &job, tflite::MicroInterpreter &interpreter) {
     // Create a filtered list of non empty input tensors
     vector<TfLiteTensor *> inputTensors;
@@ -229,10 +1345,22 @@ bool InferenceProcess::copyIfm(InferenceJob &job, tflite::MicroInterpreter &inte
     }
 
     // Copy input data from job to TFLu arena
+    job.bytesCopied = 0;
+
     for (size_t i = 0; i < inputTensors.size(); ++i) {
         DataPtr &input       = job.input[i];
         TfLiteTensor *tensor = inputTensors[i];
 
+        if (i < job.inputTransform.size() && job.inputTransform[i].type != InputTransform::COPY) {
+            if (transformInput(job.inputTransform[i], input.data, input.size, *tensor)) {
+                LOG_ERR("Failed to transform job input: job=%s, index=%zu", job.name.c_str(), i);
+                return true;
+            }
+
+            job.bytesCopied += tensor->bytes;
+            continue;
+        }
+
         if (input.size != tensor->bytes) {
             LOG_ERR("Job input size does not match network input size: job=%s, index=%zu, input=%zu, network=%u",
                     job.name.c_str(),
@@ -243,6 +1371,7 @@ bool InferenceProcess::copyIfm(InferenceJob &job, tflite::MicroInterpreter &inte
         }
 
         copy(input.begin(), input.end(), tensor->data.uint8);
+        job.bytesCopied += input.size;
     }
 
     return false;
@@ -272,6 +1401,7 @@ bool InferenceProcess::copyOfm(InferenceJob &job, tflite::MicroInterpreter &inte
         }
 
         copy(tensor->data.uint8, tensor->data.uint8 + tensor->bytes, output.begin());
+        job.bytesCopied += tensor->bytes;
     }
 
     return false;
@@ -376,7 +1506,15 @@ void InferenceProcess::printOutputTensor(TfLiteTensor *output, size_t bytesToPri
 }
 
 void InferenceProcess::tfluDebugLog(const char *s) {
+#ifdef ETHOSU_LOG_TOKENIZED
+    // Tokenized strings are cut at ETHOSU_LOG_TOKENIZED_MAX_STRING, so the message is split over records that the
+    // decoder joins
+    for (size_t i = 0, n = strlen(s); i < n; i += ETHOSU_LOG_TOKENIZED_MAX_STRING) {
+        LOG("%s", s + i);
+    }
+#else
     LOG("%s", s);
+#endif
 }
 
 } // namespace InferenceProcess
@@ -0,0 +1,450 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2023 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "input_transform.hpp"
+
+#include "tensorflow/lite/c/common.h"
+
+#include "ethosu_log.h"
+
+#include <inttypes.h>
+#include <string.h>
+
+#if defined(__ARM_FEATURE_MVE) && (__ARM_FEATURE_MVE & 1)
+#include <arm_mve.h>
+#define INPUT_TRANSFORM_MVE
+#endif
+
+using namespace std;
+
+namespace InferenceProcess {
+
+static_assert(sizeof(InputTransform) == 68, "InputTransform must not have padding");
+
+namespace {
+constexpr size_t LutSize = 256;
+
+struct Image {
+    int32_t height;
+    int32_t width;
+    int32_t channels;
+};
+
+struct Quantization {
+    float invScale;
+    int32_t zeroPoint;
+    int32_t min;
+    int32_t max;
+};
+
+bool getImage(const TfLiteTensor &tensor, Image &image) {
+    const TfLiteIntArray *dims = tensor.dims;
+    if (dims == nullptr) {
+        return true;
+    }
+
+    switch (dims->size) {
+    case 4:
+        if (dims->data[0] != 1) {
+            return true;
+        }
+
+        image = {dims->data[1], dims->data[2], dims->data[3]};
+        break;
+    case 3:
+        image = {dims->data[0], dims->data[1], dims->data[2]};
+        break;
+    case 2:
+        image = {dims->data[0], dims->data[1], 1};
+        break;
+    default:
+        return true;
+    }
+
+    return image.height <= 0 || image.width <= 0 || image.channels <= 0;
+}
+
+bool getQuantization(const TfLiteTensor &tensor, Quantization &q) {
+    switch (tensor.type) {
+    case kTfLiteInt8:
+        q.min = INT8_MIN;
+        q.max = INT8_MAX;
+        break;
+    case kTfLiteUInt8:
+        q.min = 0;
+        q.max = UINT8_MAX;
+        break;
+    case kTfLiteInt16:
+        q.min = INT16_MIN;
+        q.max = INT16_MAX;
+        break;
+    case kTfLiteFloat32:
+        q = {1.0f, 0, 0, 0};
+        return false;
+    default:
+        return true;
+    }
+
+    if (tensor.params.scale == 0.0f) {
+        return true;
+    }
+
+    q.invScale  = 1.0f / tensor.params.scale;
+    q.zeroPoint = tensor.params.zero_point;
+
+    return false;
+}
+
+void quantize(float real, const Quantization &, float &dst) {
+    dst = real;
+}
+
+template <typename D>
+void quantize(float real, const Quantization &q, D &dst) {
+    // Clamp before the conversion, converting a float outside the range of int32_t is undefined. NaN clamps to min.
+    const float min = static_cast<float>(q.min - q.zeroPoint);
+    const float max = static_cast<float>(q.max - q.zeroPoint);
+    float scaled    = real * q.invScale;
+    scaled          = scaled > min ? scaled : min;
+    scaled          = scaled < max ? scaled : max;
+
+    const int32_t value = static_cast<int32_t>(scaled >= 0.0f ? scaled + 0.5f : scaled - 0.5f) + q.zeroPoint;
+
+    // int8 tensors are stored through uint8_t, which keeps the two's complement bit pattern
+    dst = static_cast<D>(value);
+}
+
+// The rows of the crop window are contiguous spans of tensor rows, only resized vertically
+bool isSpan(const InputTransform &t, const Image &image) {
+    if (t.layout != InputTransform::NHWC || t.channels != image.channels || t.cropWidth != image.width) {
+        return false;
+    }
+
+    for (int32_t c = 0; c < image.channels; ++c) {
+        if (t.channelOrder[c] != c) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+int32_t getSourceRow(const InputTransform &t, const Image &image, int32_t y) {
+    return t.cropTop + static_cast<int32_t>(static_cast<int64_t>(y) * t.cropHeight / image.height);
+}
+
+// Gather the tensor elements from the crop window, in NHWC order
+template <typename D, typename Value>
+void gather(const InputTransform &t, const Image &image, D *dst, Value value) {
+    const size_t plane = static_cast<size_t>(t.height) * t.width;
+
+    // The source column cropLeft + x * cropWidth / width, stepped without a division per pixel
+    const int32_t step      = t.cropWidth / image.width;
+    const int32_t remainder = t.cropWidth % image.width;
+
+    for (int32_t y = 0; y < image.height; ++y) {
+        const size_t row = static_cast<size_t>(getSourceRow(t, image, y)) * t.width;
+        int32_t column   = t.cropLeft;
+        int32_t error    = 0;
+
+        for (int32_t x = 0; x < image.width; ++x) {
+            const size_t pixel = row + column;
+
+            for (int32_t c = 0; c < image.channels; ++c) {
+                const size_t sc    = t.channelOrder[c];
+                const size_t index = t.layout == InputTransform::NHWC ? pixel * t.channels + sc : sc * plane + pixel;
+                *dst++             = value(c, index);
+            }
+
+            column += step;
+            error += remainder;
+            if (error >= image.width) {
+                error -= image.width;
+                column++;
+            }
+        }
+    }
+}
+
+/****************************************************************************
+ * Span kernels
+ ****************************************************************************/
+
+void lookupSpan(const uint8_t *src, uint8_t *dst, size_t n, const uint8_t *lut) {
+#ifdef INPUT_TRANSFORM_MVE
+    for (; n >= 16; n -= 16, src += 16, dst += 16) {
+        vst1q_u8(dst, vldrbq_gather_offset_u8(lut, vld1q_u8(src)));
+    }
+
+    if (n > 0) {
+        const mve_pred16_t p = vctp8q(n);
+        vst1q_p_u8(dst, vldrbq_gather_offset_z_u8(lut, vld1q_z_u8(src, p), p), p);
+    }
+#else
+    for (size_t i = 0; i < n; ++i) {
+        dst[i] = lut[src[i]];
+    }
+#endif
+}
+
+// Conversion between uint8 and int8 with the zero point moved by 128
+void flipSpan(const uint8_t *src, uint8_t *dst, size_t n) {
+#ifdef INPUT_TRANSFORM_MVE
+    const uint8x16_t sign = vdupq_n_u8(0x80);
+
+    for (; n >= 16; n -= 16, src += 16, dst += 16) {
+        vst1q_u8(dst, veorq_u8(vld1q_u8(src), sign));
+    }
+
+    if (n > 0) {
+        const mve_pred16_t p = vctp8q(n);
+        vst1q_p_u8(dst, veorq_u8(vld1q_z_u8(src, p), sign), p);
+    }
+#else
+    for (; n >= sizeof(uint32_t); n -= sizeof(uint32_t), src += sizeof(uint32_t), dst += sizeof(uint32_t)) {
+        uint32_t word;
+        memcpy(&word, src, sizeof(word));
+        word ^= 0x80808080u;
+        memcpy(dst, &word, sizeof(word));
+    }
+
+    for (; n > 0; --n) {
+        *dst++ = *src++ ^ 0x80;
+    }
+#endif
+}
+
+enum class Kernel {
+    COPY,
+    FLIP,
+    LOOKUP,
+    INTERLEAVED
+};
+
+template <typename D>
+Kernel getKernel(const D *, bool uniform) {
+    return uniform ? Kernel::LOOKUP : Kernel::INTERLEAVED;
+}
+
+Kernel getKernel(const uint8_t *lut, bool uniform) {
+    if (!uniform) {
+        return Kernel::INTERLEAVED;
+    }
+
+    bool copy = true;
+    bool flip = true;
+
+    for (size_t i = 0; i < LutSize; ++i) {
+        copy = copy && lut[i] == i;
+        flip = flip && lut[i] == (i ^ 0x80);
+    }
+
+    return copy ? Kernel::COPY : flip ? Kernel::FLIP : Kernel::LOOKUP;
+}
+
+void runSpan(Kernel kernel, const uint8_t *src, uint8_t *dst, size_t n, const uint8_t *lut) {
+    switch (kernel) {
+    case Kernel::COPY:
+        memcpy(dst, src, n);
+        break;
+    case Kernel::FLIP:
+        flipSpan(src, dst, n);
+        break;
+    default:
+        lookupSpan(src, dst, n, lut);
+        break;
+    }
+}
+
+template <typename D>
+void runSpan(Kernel, const uint8_t *src, D *dst, size_t n, const D *lut) {
+    for (size_t i = 0; i < n; ++i) {
+        dst[i] = lut[src[i]];
+    }
+}
+
+/****************************************************************************
+ * Transforms
+ ****************************************************************************/
+
+// 8 bit sources go through a lookup table per channel, which folds the normalization and the quantization. The
+// table is on the stack, at most 2 KiB for int16 tensors.
+template <typename D>
+void transformLut(const InputTransform &t, const Image &image, const uint8_t *src, const Quantization &q, D *dst) {
+    D lut[InputTransform::MaxChannels * LutSize];
+    bool uniform = true;
+
+    for (int32_t c = 0; c < image.channels; ++c) {
+        for (size_t i = 0; i < LutSize; ++i) {
+            const float source = t.type == InputTransform::INT8 ? static_cast<int8_t>(i) : static_cast<float>(i);
+            D &value           = lut[c * LutSize + i];
+
+            quantize((source - t.offset[c]) * t.scale[c], q, value);
+            uniform = uniform && value == lut[i];
+        }
+    }
+
+    if (!isSpan(t, image)) {
+        gather(t, image, dst, [&](int32_t c, size_t index) { return lut[c * LutSize + src[index]]; });
+        return;
+    }
+
+    const Kernel kernel  = getKernel(lut, uniform);
+    const size_t rowSize = static_cast<size_t>(image.width) * image.channels;
+
+    for (int32_t y = 0; y < image.height; ++y) {
+        const uint8_t *row =
+            src + (static_cast<size_t>(getSourceRow(t, image, y)) * t.width + t.cropLeft) * image.channels;
+
+        if (kernel != Kernel::INTERLEAVED) {
+            runSpan(kernel, row, dst, rowSize, lut);
+            dst += rowSize;
+            continue;
+        }
+
+        for (int32_t x = 0; x < image.width; ++x) {
+            for (int32_t c = 0; c < image.channels; ++c) {
+                *dst++ = lut[c * LutSize + *row++];
+            }
+        }
+    }
+}
+
+// Float tensors need no table, the normalization costs about as much as the lookup
+void transformLut(const InputTransform &t, const Image &image, const uint8_t *src, const Quantization &, float *dst) {
+    gather(t, image, dst, [&](int32_t c, size_t index) {
+        const float source = t.type == InputTransform::INT8 ? static_cast<int8_t>(src[index]) : src[index];
+        return (source - t.offset[c]) * t.scale[c];
+    });
+}
+
+template <typename D>
+void transformFloat(const InputTransform &t, const Image &image, const float *src, const Quantization &q, D *dst) {
+    gather(t, image, dst, [&](int32_t c, size_t index) {
+        D value;
+        quantize((src[index] - t.offset[c]) * t.scale[c], q, value);
+        return value;
+    });
+}
+
+template <typename D>
+void transform(const InputTransform &t, const Image &image, const void *data, const Quantization &q, D *dst) {
+    if (t.type == InputTransform::FLOAT32) {
+        transformFloat(t, image, static_cast<const float *>(data), q, dst);
+    } else {
+        transformLut(t, image, static_cast<const uint8_t *>(data), q, dst);
+    }
+}
+} // namespace
+
+/****************************************************************************
+ * InputTransform
+ ****************************************************************************/
+
+InputTransform::InputTransform() : InputTransform(COPY, NHWC, 0, 0, 0) {}
+
+InputTransform::InputTransform(Type _type, Layout _layout, int32_t _height, int32_t _width, int32_t _channels) :
+    height(_height), width(_width), channels(_channels), cropTop(0), cropLeft(0), cropHeight(_height),
+    cropWidth(_width), offset(), scale(), type(_type), layout(_layout), channelOrder(), reserved() {
+    for (size_t c = 0; c < MaxChannels; ++c) {
+        scale[c]        = 1.0f;
+        channelOrder[c] = c;
+    }
+}
+
+void InputTransform::setCrop(int32_t top, int32_t left, int32_t _height, int32_t _width) {
+    cropTop    = top;
+    cropLeft   = left;
+    cropHeight = _height;
+    cropWidth  = _width;
+}
+
+void InputTransform::setNormalization(float _offset, float _scale) {
+    for (size_t c = 0; c < MaxChannels; ++c) {
+        setNormalization(c, _offset, _scale);
+    }
+}
+
+void InputTransform::setNormalization(size_t channel, float _offset, float _scale) {
+    if (channel < MaxChannels) {
+        offset[channel] = _offset;
+        scale[channel]  = _scale;
+    }
+}
+
+size_t InputTransform::getInputSize() const {
+    const size_t elementSize = type == FLOAT32 ? sizeof(float) : type == COPY ? 0 : sizeof(uint8_t);
+    return static_cast<size_t>(height) * width * channels * elementSize;
+}
+
+bool transformInput(const InputTransform &t, const void *data, size_t size, TfLiteTensor &tensor) {
+    Image image;
+    if (getImage(tensor, image) || static_cast<size_t>(image.channels) > InputTransform::MaxChannels) {
+        LOG_ERR("Input transform requires a NHWC, HWC or HW tensor with at most %zu channels",
+                InputTransform::MaxChannels);
+        return true;
+    }
+
+    if (t.type == InputTransform::COPY || data == nullptr || size != t.getInputSize() || t.height <= 0 ||
+        t.width <= 0 || t.channels <= 0) {
+        LOG_ERR("Input transform does not match input: size=%zu, expected=%zu", size, t.getInputSize());
+        return true;
+    }
+
+    if (t.cropTop < 0 || t.cropLeft < 0 || t.cropHeight <= 0 || t.cropWidth <= 0 ||
+        t.cropTop + t.cropHeight > t.height || t.cropLeft + t.cropWidth > t.width) {
+        LOG_ERR("Input transform crop window out of bounds: top=%" PRId32 ", left=%" PRId32 ", height=%" PRId32
+                ", width=%" PRId32,
+                t.cropTop,
+                t.cropLeft,
+                t.cropHeight,
+                t.cropWidth);
+        return true;
+    }
+
+    for (int32_t c = 0; c < image.channels; ++c) {
+        if (t.channelOrder[c] >= t.channels) {
+            LOG_ERR("Input transform channel out of range: channel=%" PRId32 ", source=%u", c, t.channelOrder[c]);
+            return true;
+        }
+    }
+
+    Quantization q;
+    if (getQuantization(tensor, q)) {
+        LOG_ERR("Input transform requires a quantized int8, uint8 or int16 tensor, or a float32 tensor: type=%d",
+                tensor.type);
+        return true;
+    }
+
+    switch (tensor.type) {
+    case kTfLiteInt8:
+    case kTfLiteUInt8:
+        transform(t, image, data, q, tensor.data.uint8);
+        break;
+    case kTfLiteInt16:
+        transform(t, image, data, q, tensor.data.i16);
+        break;
+    default:
+        transform(t, image, data, q, tensor.data.f);
+        break;
+    }
+
+    return false;
+}
+
+} // namespace InferenceProcess
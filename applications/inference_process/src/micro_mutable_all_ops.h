@@ -0,0 +1,127 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+   Copyright 2023 Arm Limited and/or its affiliates <open-source-office@arm.com>
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#pragma once
+
+#include <tensorflow/lite/micro/micro_mutable_op_resolver.h>
+
+// All operators, as a list of the names of the MicroMutableOpResolver Add functions
+#define INFERENCE_PROCESS_ALL_OPS(OP) \
+    OP(Abs)                           \
+    OP(Add)                           \
+    OP(AddN)                          \
+    OP(ArgMax)                        \
+    OP(ArgMin)                        \
+    OP(AssignVariable)                \
+    OP(AveragePool2D)                 \
+    OP(BatchToSpaceNd)                \
+    OP(BroadcastArgs)                 \
+    OP(BroadcastTo)                   \
+    OP(CallOnce)                      \
+    OP(Cast)                          \
+    OP(Ceil)                          \
+    OP(CircularBuffer)                \
+    OP(Concatenation)                 \
+    OP(Conv2D)                        \
+    OP(Cos)                           \
+    OP(CumSum)                        \
+    OP(DepthToSpace)                  \
+    OP(DepthwiseConv2D)               \
+    OP(Dequantize)                    \
+    OP(DetectionPostprocess)          \
+    OP(Div)                           \
+    OP(Elu)                           \
+    OP(Equal)                         \
+    OP(EthosU)                        \
+    OP(Exp)                           \
+    OP(ExpandDims)                    \
+    OP(Fill)                          \
+    OP(Floor)                         \
+    OP(FloorDiv)                      \
+    OP(FloorMod)                      \
+    OP(FullyConnected)                \
+    OP(Gather)                        \
+    OP(GatherNd)                      \
+    OP(Greater)                       \
+    OP(GreaterEqual)                  \
+    OP(HardSwish)                     \
+    OP(If)                            \
+    OP(L2Normalization)               \
+    OP(L2Pool2D)                      \
+    OP(LeakyRelu)                     \
+    OP(Less)                          \
+    OP(LessEqual)                     \
+    OP(Log)                           \
+    OP(LogicalAnd)                    \
+    OP(LogicalNot)                    \
+    OP(LogicalOr)                     \
+    OP(Logistic)                      \
+    OP(LogSoftmax)                    \
+    OP(MaxPool2D)                     \
+    OP(Maximum)                       \
+    OP(Mean)                          \
+    OP(Minimum)                       \
+    OP(MirrorPad)                     \
+    OP(Mul)                           \
+    OP(Neg)                           \
+    OP(NotEqual)                      \
+    OP(Pack)                          \
+    OP(Pad)                           \
+    OP(PadV2)                         \
+    OP(Prelu)                         \
+    OP(Quantize)                      \
+    OP(ReadVariable)                  \
+    OP(ReduceMax)                     \
+    OP(Relu)                          \
+    OP(Relu6)                         \
+    OP(Reshape)                       \
+    OP(ResizeBilinear)                \
+    OP(ResizeNearestNeighbor)         \
+    OP(Round)                         \
+    OP(Rsqrt)                         \
+    OP(SelectV2)                      \
+    OP(Shape)                         \
+    OP(Sin)                           \
+    OP(Slice)                         \
+    OP(Softmax)                       \
+    OP(SpaceToBatchNd)                \
+    OP(SpaceToDepth)                  \
+    OP(Split)                         \
+    OP(SplitV)                        \
+    OP(Sqrt)                          \
+    OP(Square)                        \
+    OP(SquaredDifference)             \
+    OP(Squeeze)                       \
+    OP(StridedSlice)                  \
+    OP(Sub)                           \
+    OP(Sum)                           \
+    OP(Svdf)                          \
+    OP(Tanh)                          \
+    OP(Transpose)                     \
+    OP(TransposeConv)                 \
+    OP(UnidirectionalSequenceLSTM)    \
+    OP(Unpack)                        \
+    OP(VarHandle)                     \
+    OP(While)                         \
+    OP(ZerosLike)
+
+constexpr int kNumberOperators = 97;
+
+inline void add_all_ops(tflite::MicroMutableOpResolver<kNumberOperators> &micro_op_resolver) {
+#define ADD_OP(op) micro_op_resolver.Add##op();
+    INFERENCE_PROCESS_ALL_OPS(ADD_OP)
+#undef ADD_OP
+}
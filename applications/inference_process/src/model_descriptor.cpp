@@ -0,0 +1,52 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2023 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "model_descriptor.hpp"
+
+using namespace std;
+
+namespace InferenceProcess {
+
+InferenceJob makeJob(const ModelDescriptor &descriptor,
+                     void *const *input,
+                     void *const *output,
+                     size_t numBytesToPrint,
+                     void *externalContext) {
+    vector<DataPtr> inputs;
+    vector<DataPtr> outputs;
+
+    inputs.reserve(descriptor.numInputs);
+    for (size_t i = 0; i < descriptor.numInputs; i++) {
+        inputs.push_back(DataPtr(input[i], descriptor.inputSizes[i]));
+    }
+
+    outputs.reserve(descriptor.numOutputs);
+    for (size_t i = 0; i < descriptor.numOutputs; i++) {
+        outputs.push_back(DataPtr(output[i], descriptor.outputSizes[i]));
+    }
+
+    return InferenceJob(descriptor.name,
+                        DataPtr(const_cast<uint8_t *>(descriptor.model), descriptor.modelSize),
+                        inputs,
+                        outputs,
+                        {},
+                        numBytesToPrint,
+                        externalContext);
+}
+
+} // namespace InferenceProcess
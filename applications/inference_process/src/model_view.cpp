@@ -0,0 +1,447 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2023 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "model_view.hpp"
+
+#include "tensorflow/lite/schema/schema_generated.h"
+
+#include "ethosu_log.h"
+#include "inference_parser.hpp"
+
+#include <algorithm>
+#include <string.h>
+
+using namespace std;
+
+namespace InferenceProcess {
+
+namespace {
+constexpr const char *OfflinePlanMetadata = "OfflineMemoryAllocation";
+
+// Flatbuffers and the tensor arena of TFLu both expect 16 byte alignment
+constexpr size_t Alignment = 16;
+
+size_t alignUp(size_t value) {
+    return (value + Alignment - 1) & ~(Alignment - 1);
+}
+
+// Control flow operators reference other subgraphs by index
+bool usesControlFlow(const tflite::Model *model, const tflite::SubGraph *subgraph) {
+    if (subgraph->operators() == nullptr) {
+        return false;
+    }
+
+    for (auto op : *subgraph->operators()) {
+        switch (InferenceParser::getBuiltinCode(model->operator_codes()->Get(op->opcode_index()))) {
+        case tflite::BuiltinOperator_IF:
+        case tflite::BuiltinOperator_WHILE:
+        case tflite::BuiltinOperator_CALL_ONCE:
+            return true;
+        default:
+            break;
+        }
+    }
+
+    return false;
+}
+
+bool hasOfflinePlan(const tflite::Model *model) {
+    if (model->metadata() == nullptr) {
+        return false;
+    }
+
+    for (auto metadata : *model->metadata()) {
+        if (metadata->name() != nullptr && strcmp(metadata->name()->c_str(), OfflinePlanMetadata) == 0) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool isConstant(const tflite::Model *model, const tflite::Tensor *tensor) {
+    if (model->buffers() == nullptr || tensor->buffer() >= model->buffers()->size()) {
+        return false;
+    }
+
+    auto data = model->buffers()->Get(tensor->buffer())->data();
+    return data != nullptr && data->size() > 0;
+}
+
+void getTensors(const flatbuffers::Vector<flatbuffers::Offset<tflite::TensorMap>> *tensorMap,
+                vector<int32_t> &tensors) {
+    tensors.clear();
+
+    if (tensorMap != nullptr) {
+        for (auto entry : *tensorMap) {
+            tensors.push_back(entry->tensor_index());
+        }
+    }
+}
+
+// Mark the valid tensor indices of a vector, optional tensors have index -1
+void markTensors(const flatbuffers::Vector<int32_t> *tensors, vector<bool> &used) {
+    if (tensors == nullptr) {
+        return;
+    }
+
+    for (auto index : *tensors) {
+        if (index >= 0 && static_cast<size_t>(index) < used.size()) {
+            used[index] = true;
+        }
+    }
+}
+
+bool anyUsed(const flatbuffers::Vector<int32_t> *tensors, const vector<bool> &used) {
+    if (tensors == nullptr) {
+        return false;
+    }
+
+    for (auto index : *tensors) {
+        if (index >= 0 && static_cast<size_t>(index) < used.size() && used[index]) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// Operators reading variable tensors update them, for example the state of recurrent operators
+bool anyVariable(const flatbuffers::Vector<int32_t> *tensors,
+                 const flatbuffers::Vector<flatbuffers::Offset<tflite::Tensor>> *subgraphTensors) {
+    if (tensors == nullptr) {
+        return false;
+    }
+
+    for (auto index : *tensors) {
+        if (index >= 0 && static_cast<uint32_t>(index) < subgraphTensors->size() &&
+            subgraphTensors->Get(index)->is_variable()) {
+            return true;
+        }
+    }
+
+    return false;
+}
+} // namespace
+
+ModelView::ModelView() :
+    source(nullptr), sourceSize(0), sourceSubGraph(0), copy(nullptr), begin(nullptr), end(nullptr), size(0),
+    subGraph(0), numOperators(0), numSkipped(0) {}
+
+bool ModelView::select(const void *modelData,
+                       size_t modelSize,
+                       const char *signature,
+                       size_t index,
+                       uint8_t *buffer,
+                       size_t bufferSize) {
+    reset();
+
+    // Patch a private copy, the model itself may be in flash or used by other interpreters
+    const size_t padding = alignUp(reinterpret_cast<uintptr_t>(buffer)) - reinterpret_cast<uintptr_t>(buffer);
+    const size_t used    = padding + alignUp(modelSize);
+
+    if (buffer == nullptr || used > bufferSize) {
+        LOG_ERR("Buffer too small for a copy of the model: model=%zu, buffer=%zu", modelSize, bufferSize);
+        return true;
+    }
+
+    begin = buffer + padding;
+    end   = begin + modelSize;
+    memcpy(begin, modelData, modelSize);
+
+    const tflite::Model *model = tflite::GetModel(begin);
+    vector<int32_t> inputs;
+    vector<int32_t> outputs;
+    const bool hasSignature = signature != nullptr && signature[0] != '\0';
+
+    if (hasSignature) {
+        const tflite::SignatureDef *def = InferenceParser::getSignature(model, signature);
+        if (def == nullptr) {
+            LOG_ERR("Signature not found in model: signature=%s", signature);
+            reset();
+            return true;
+        }
+
+        index = def->subgraph_index();
+        getTensors(def->inputs(), inputs);
+        getTensors(def->outputs(), outputs);
+    } else if (index >= model->subgraphs()->size()) {
+        LOG_ERR("Subgraph index out of range: subgraph=%zu, subgraphs=%u", index, model->subgraphs()->size());
+        reset();
+        return true;
+    }
+
+    const tflite::SubGraph *subgraph = model->subgraphs()->Get(index);
+    const bool controlFlow           = usesControlFlow(model, subgraph);
+
+    if (index != 0 && (controlFlow || hasOfflinePlan(model))) {
+        LOG_ERR("Only the first subgraph can be selected in models with control flow or offline memory plan: "
+                "subgraph=%zu",
+                index);
+        reset();
+        return true;
+    }
+
+    bool failed = selectSubGraph(model, index, controlFlow);
+
+    // The subgraph keeps its inputs and outputs unless narrowed down by the signature
+    if (!failed && hasSignature) {
+        failed = subgraph->inputs() == nullptr || subgraph->outputs() == nullptr ||
+                 setTensors(subgraph->inputs()->Data(), inputs) || setTensors(subgraph->outputs()->Data(), outputs);
+    }
+
+    if (!failed) {
+        failed = pruneOperators(model, subgraph);
+    }
+
+    if (failed) {
+        LOG_ERR("Failed to select subgraph: subgraph=%zu", index);
+        reset();
+        return true;
+    }
+
+    source          = modelData;
+    sourceSize      = modelSize;
+    sourceSignature = hasSignature ? signature : "";
+    sourceSubGraph  = hasSignature ? 0 : index;
+    copy            = model;
+    size            = used;
+    subGraph        = index;
+
+    return false;
+}
+
+bool ModelView::matches(const void *modelData, size_t modelSize, const char *signature, size_t index) const {
+    if (copy == nullptr || modelData != source || modelSize != sourceSize) {
+        return false;
+    }
+
+    if (signature != nullptr && signature[0] != '\0') {
+        return sourceSignature == signature;
+    }
+
+    return sourceSignature.empty() && index == sourceSubGraph;
+}
+
+bool ModelView::isCopyOf(const void *modelData) const {
+    return copy != nullptr && modelData == source;
+}
+
+void ModelView::reset() {
+    source         = nullptr;
+    sourceSize     = 0;
+    sourceSubGraph = 0;
+    copy           = nullptr;
+    begin          = nullptr;
+    end            = nullptr;
+    size           = 0;
+    subGraph       = 0;
+    numOperators   = 0;
+    numSkipped     = 0;
+    sourceSignature.clear();
+}
+
+bool ModelView::isSelected() const {
+    return copy != nullptr;
+}
+
+const tflite::Model *ModelView::getModel() const {
+    return copy;
+}
+
+size_t ModelView::getSize() const {
+    return size;
+}
+
+size_t ModelView::getSubGraph() const {
+    return subGraph;
+}
+
+size_t ModelView::getNumOperators() const {
+    return numOperators;
+}
+
+size_t ModelView::getNumSkippedOperators() const {
+    return numSkipped;
+}
+
+bool ModelView::selectSubGraph(const tflite::Model *model, size_t index, bool keepOthers) {
+    const uint8_t *subgraphs = model->subgraphs()->Data();
+
+    // Point the first entry of the subgraph vector to the selected subgraph
+    if (index != 0) {
+        const uint8_t *entry = subgraphs + index * sizeof(flatbuffers::uoffset_t);
+
+        if (writeOffset(subgraphs, entry + flatbuffers::ReadScalar<flatbuffers::uoffset_t>(entry))) {
+            return true;
+        }
+    }
+
+    if (keepOthers) {
+        return false;
+    }
+
+    return write(subgraphs - sizeof(flatbuffers::uoffset_t), 1);
+}
+
+bool ModelView::setTensors(const uint8_t *data, const vector<int32_t> &tensors) {
+    const uint8_t *length = data - sizeof(flatbuffers::uoffset_t);
+
+    if (tensors.size() > flatbuffers::ReadScalar<flatbuffers::uoffset_t>(length)) {
+        LOG_ERR("Signature has more tensors than its subgraph: tensors=%zu", tensors.size());
+        return true;
+    }
+
+    for (size_t i = 0; i < tensors.size(); ++i) {
+        if (write(data + i * sizeof(int32_t), static_cast<uint32_t>(tensors[i]))) {
+            return true;
+        }
+    }
+
+    return write(length, static_cast<uint32_t>(tensors.size()));
+}
+
+bool ModelView::pruneOperators(const tflite::Model *model, const tflite::SubGraph *subgraph) {
+    auto tensors   = subgraph->tensors();
+    auto operators = subgraph->operators();
+
+    if (tensors == nullptr || operators == nullptr) {
+        return false;
+    }
+
+    const size_t total = operators->size();
+    numOperators       = total;
+
+    // Walk the operators backwards from the outputs, keeping the producers of every tensor a kept operator uses
+    vector<bool> used(tensors->size(), false);
+    vector<bool> keep(total, false);
+    size_t kept = 0;
+
+    markTensors(subgraph->outputs(), used);
+
+    for (size_t i = total; i-- > 0;) {
+        auto op = operators->Get(i);
+
+        const bool noOutputs = op->outputs() == nullptr || op->outputs()->size() == 0;
+        if (!noOutputs && !anyUsed(op->outputs(), used) && !anyVariable(op->inputs(), tensors)) {
+            continue;
+        }
+
+        markTensors(op->inputs(), used);
+        markTensors(op->outputs(), used);
+        markTensors(op->intermediates(), used);
+        keep[i] = true;
+        kept++;
+    }
+
+    if (kept == total) {
+        return false;
+    }
+
+    markTensors(subgraph->inputs(), used);
+
+    // Tensors only used by removed operators have no lifetime, which the memory planner rejects unless they are empty
+    vector<const flatbuffers::Vector<int32_t> *> shapes;
+    for (size_t i = 0; i < tensors->size(); ++i) {
+        auto tensor = tensors->Get(i);
+
+        if (used[i] || tensor->is_variable() || isConstant(model, tensor)) {
+            continue;
+        }
+
+        if (tensor->shape() == nullptr || tensor->shape()->size() == 0) {
+            LOG_WARN("Unused scalar tensor, running all operators: tensor=%zu", i);
+            return false;
+        }
+
+        shapes.push_back(tensor->shape());
+    }
+
+    // The converter may share a shape vector between tensors, which must not be emptied for a tensor still in use
+    for (size_t i = 0; i < tensors->size(); ++i) {
+        auto shape = tensors->Get(i)->shape();
+
+        if (shape == nullptr || find(shapes.begin(), shapes.end(), shape) == shapes.end()) {
+            continue;
+        }
+
+        if (used[i] || tensors->Get(i)->is_variable() || isConstant(model, tensors->Get(i))) {
+            LOG_WARN("Shape shared with a used tensor, running all operators: tensor=%zu", i);
+            return false;
+        }
+    }
+
+    for (auto shape : shapes) {
+        if (write(shape->Data(), 0)) {
+            return true;
+        }
+    }
+
+    // Move the kept operators to the front of the operator vector, and shorten it
+    const uint8_t *entries = operators->Data();
+    vector<const uint8_t *> targets;
+
+    for (size_t i = 0; i < total; ++i) {
+        const uint8_t *entry = entries + i * sizeof(flatbuffers::uoffset_t);
+
+        if (keep[i]) {
+            targets.push_back(entry + flatbuffers::ReadScalar<flatbuffers::uoffset_t>(entry));
+        }
+    }
+
+    for (size_t i = 0; i < targets.size(); ++i) {
+        if (writeOffset(entries + i * sizeof(flatbuffers::uoffset_t), targets[i])) {
+            return true;
+        }
+    }
+
+    if (write(entries - sizeof(flatbuffers::uoffset_t), static_cast<uint32_t>(targets.size()))) {
+        return true;
+    }
+
+    numOperators = kept;
+    numSkipped   = total - kept;
+
+    return false;
+}
+
+bool ModelView::write(const void *location, uint32_t value) {
+    const uint8_t *word = static_cast<const uint8_t *>(location);
+
+    // Only the private copy is ever written
+    if (word < begin || word + sizeof(uint32_t) > end) {
+        LOG_ERR("Patch outside the copy of the model");
+        return true;
+    }
+
+    flatbuffers::WriteScalar(begin + (word - begin), value);
+
+    return false;
+}
+
+bool ModelView::writeOffset(const uint8_t *location, const uint8_t *target) {
+    // Flatbuffer offsets are unsigned and relative to their own location
+    if (target <= location) {
+        LOG_ERR("Invalid flatbuffer offset");
+        return true;
+    }
+
+    return write(location, static_cast<uint32_t>(target - location));
+}
+
+} // namespace InferenceProcess
@@ -0,0 +1,249 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2023 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "tensorflow/lite/micro/micro_time.h"
+
+#include "crc.hpp"
+#include "inference_process.hpp"
+#include "result_cache.hpp"
+
+#include <algorithm>
+#include <string.h>
+
+namespace InferenceProcess {
+
+ResultCache::ResultCache() : maxEntries(0), maxBytes(0), eviction(LRU), mask(0xff), bytes(0), clock(0), stats() {}
+
+void ResultCache::configure(size_t _maxEntries, size_t _maxBytes, Eviction _eviction, uint8_t ignoreBits) {
+    maxEntries = _maxEntries;
+    maxBytes   = _maxBytes;
+    eviction   = _eviction;
+    mask       = ignoreBits < 8 ? 0xff << ignoreBits : 0;
+
+    clear();
+    entries.reserve(maxEntries);
+    models.reserve(maxEntries);
+}
+
+bool ResultCache::isEnabled() const {
+    return maxEntries > 0;
+}
+
+uint32_t ResultCache::checksum(const InferenceJob &job) {
+    constexpr auto crc   = Crc();
+    const uint32_t start = tflite::GetCurrentTimeTicks();
+    uint32_t value       = 0;
+
+    for (auto &input : job.input) {
+        const uint32_t size = input.size;
+        value               = crc.crc32(&size, sizeof(size), value);
+
+        if (mask == 0xff) {
+            value = crc.crc32(input.data, input.size, value);
+            continue;
+        }
+
+        // Mask the ignored bits chunk by chunk
+        const uint8_t *src = static_cast<const uint8_t *>(input.data);
+        uint8_t chunk[64];
+
+        for (size_t offset = 0; offset < input.size; offset += sizeof(chunk)) {
+            const size_t length = std::min(sizeof(chunk), input.size - offset);
+
+            for (size_t i = 0; i < length; i++) {
+                chunk[i] = src[offset + i] & mask;
+            }
+
+            value = crc.crc32(chunk, length, value);
+        }
+    }
+
+    // The same input gives a different result with another preprocessing
+    for (auto &transform : job.inputTransform) {
+        value = crc.crc32(&transform, sizeof(transform), value);
+    }
+
+    stats.hashCycles += tflite::GetCurrentTimeTicks() - start;
+
+    return value;
+}
+
+bool ResultCache::lookup(InferenceJob &job, uint32_t crc) {
+    stats.lookups++;
+
+    Entry *entry = find(job, modelChecksum(job), crc);
+    if (entry == nullptr) {
+        return false;
+    }
+
+    const uint8_t *src = entry->outputs.data();
+    job.bytesCopied    = 0;
+
+    for (size_t i = 0; i < job.output.size(); i++) {
+        memcpy(job.output[i].data, src, entry->outputSizes[i]);
+        src += entry->outputSizes[i];
+        job.bytesCopied += entry->outputSizes[i];
+    }
+
+    entry->lastUsed = ++clock;
+    entry->hits++;
+
+    stats.hits++;
+    stats.savedCycles += entry->cpuCycles;
+
+    job.cpuCycles = 0;
+
+    return true;
+}
+
+void ResultCache::insert(const InferenceJob &job, uint32_t crc) {
+    size_t size = 0;
+    for (auto &output : job.output) {
+        size += output.size;
+    }
+
+    if (!isEnabled() || job.output.empty() || size > maxBytes) {
+        return;
+    }
+
+    const uint32_t modelCrc = modelChecksum(job);
+    if (find(job, modelCrc, crc) != nullptr) {
+        return;
+    }
+
+    while (!entries.empty() && (entries.size() >= maxEntries || bytes + size > maxBytes)) {
+        evict();
+    }
+
+    Entry entry;
+    entry.modelCrc  = modelCrc;
+    entry.crc       = crc;
+    entry.lastUsed  = ++clock;
+    entry.inserted  = clock;
+    entry.hits      = 0;
+    entry.cpuCycles = job.cpuCycles;
+
+    entry.outputs.reserve(size);
+    for (auto &output : job.output) {
+        entry.outputSizes.push_back(output.size);
+        entry.outputs.insert(entry.outputs.end(), output.begin(), output.end());
+    }
+
+    entries.push_back(std::move(entry));
+    bytes += size;
+
+    stats.insertions++;
+}
+
+void ResultCache::invalidate(const void *model) {
+    for (auto it = models.begin(); it != models.end();) {
+        if (it->data != model) {
+            ++it;
+            continue;
+        }
+
+        const uint32_t modelCrc = it->crc;
+        it                      = models.erase(it);
+
+        for (auto entry = entries.begin(); entry != entries.end();) {
+            if (entry->modelCrc == modelCrc) {
+                bytes -= entry->outputs.size();
+                entry = entries.erase(entry);
+            } else {
+                ++entry;
+            }
+        }
+    }
+}
+
+void ResultCache::clear() {
+    models.clear();
+    entries.clear();
+    bytes = 0;
+}
+
+const ResultCache::Stats &ResultCache::getStats() const {
+    return stats;
+}
+
+void ResultCache::resetStats() {
+    stats = Stats();
+}
+
+uint32_t ResultCache::modelChecksum(const InferenceJob &job) {
+    for (auto &model : models) {
+        if (model.data == job.networkModel.data && model.size == job.networkModel.size) {
+            return model.crc;
+        }
+    }
+
+    constexpr auto crc   = Crc();
+    const uint32_t start = tflite::GetCurrentTimeTicks();
+    const uint32_t value = crc.crc32(job.networkModel.data, job.networkModel.size);
+
+    stats.hashCycles += tflite::GetCurrentTimeTicks() - start;
+
+    // Forget the oldest model when full. Its entries stay valid for copies of the model.
+    if (!models.empty() && models.size() >= maxEntries) {
+        models.erase(models.begin());
+    }
+
+    models.push_back({job.networkModel.data, job.networkModel.size, value});
+
+    return value;
+}
+
+ResultCache::Entry *ResultCache::find(const InferenceJob &job, uint32_t modelCrc, uint32_t crc) {
+    for (auto &entry : entries) {
+        if (entry.crc != crc || entry.modelCrc != modelCrc || entry.outputSizes.size() != job.output.size()) {
+            continue;
+        }
+
+        bool match = true;
+        for (size_t i = 0; i < job.output.size(); i++) {
+            match &= entry.outputSizes[i] == job.output[i].size;
+        }
+
+        if (match) {
+            return &entry;
+        }
+    }
+
+    return nullptr;
+}
+
+void ResultCache::evict() {
+    auto victim = std::min_element(entries.begin(), entries.end(), [this](const Entry &a, const Entry &b) {
+        switch (eviction) {
+        case LFU:
+            return a.hits < b.hits || (a.hits == b.hits && a.lastUsed < b.lastUsed);
+        case FIFO:
+            return a.inserted < b.inserted;
+        case LRU:
+        default:
+            return a.lastUsed < b.lastUsed;
+        }
+    });
+
+    bytes -= victim->outputs.size();
+    entries.erase(victim);
+
+    stats.evictions++;
+}
+
+} // namespace InferenceProcess
@@ -0,0 +1,184 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2023 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "tensorflow/lite/micro/arena_allocator/non_persistent_arena_buffer_allocator.h"
+#include "tensorflow/lite/micro/arena_allocator/persistent_arena_buffer_allocator.h"
+#include "tensorflow/lite/micro/memory_helpers.h"
+#include "tensorflow/lite/micro/micro_allocator.h"
+#include "tensorflow/lite/micro/micro_arena_constants.h"
+
+#include "ethosu_log.h"
+#include "tiered_arena.hpp"
+
+#include <limits>
+#include <new>
+
+namespace InferenceProcess {
+
+namespace {
+// Size of an arena after aligning its start to the arena buffer alignment
+size_t alignedSize(uint8_t *arena, size_t size) {
+    const size_t skip = tflite::AlignPointerUp(arena, tflite::MicroArenaBufferAlignment()) - arena;
+
+    return size > skip ? size - skip : 0;
+}
+} // namespace
+
+TieredMemoryPlanner::TieredMemoryPlanner(uint8_t *_fastArena,
+                                         size_t _fastArenaSize,
+                                         ArenaPlacement::Policy policy,
+                                         const uint32_t *operatorTicks,
+                                         size_t numOperators) :
+    fastArena(tflite::AlignPointerUp(_fastArena, tflite::MicroArenaBufferAlignment())),
+    fastArenaSize(alignedSize(_fastArena, _fastArenaSize)),
+    placement(fastArenaSize, policy, operatorTicks, numOperators), persistent(nullptr), nonPersistent(nullptr),
+    spill(nullptr), planned(false), failed(false) {}
+
+tflite::MicroAllocator *TieredMemoryPlanner::createAllocator(uint8_t *slowArena, size_t slowArenaSize) {
+    // The persistent allocator grows downwards from the aligned tail of the slow arena, and is placed in the slow
+    // arena itself. The non persistent allocator hands out the fast arena to the planner.
+    uint8_t *tail = tflite::AlignPointerDown(slowArena + slowArenaSize, tflite::MicroArenaBufferAlignment());
+    tflite::PersistentArenaBufferAllocator tmp(slowArena, tail - slowArena);
+
+    uint8_t *buffer = tmp.AllocatePersistentBuffer(sizeof(tflite::PersistentArenaBufferAllocator),
+                                                   alignof(tflite::PersistentArenaBufferAllocator));
+    if (buffer == nullptr) {
+        LOG_ERR("Slow arena too small: size=%zu", slowArenaSize);
+        return nullptr;
+    }
+
+    persistent = new (buffer) tflite::PersistentArenaBufferAllocator(tmp);
+
+    buffer = persistent->AllocatePersistentBuffer(sizeof(tflite::NonPersistentArenaBufferAllocator),
+                                                  alignof(tflite::NonPersistentArenaBufferAllocator));
+    if (buffer == nullptr) {
+        LOG_ERR("Slow arena too small: size=%zu", slowArenaSize);
+        return nullptr;
+    }
+
+    nonPersistent = new (buffer) tflite::NonPersistentArenaBufferAllocator(fastArena, fastArenaSize);
+
+    return tflite::MicroAllocator::Create(persistent, nonPersistent, this);
+}
+
+TfLiteStatus TieredMemoryPlanner::Init(unsigned char *, int) {
+    placement.clear();
+    spill   = nullptr;
+    planned = false;
+    failed  = false;
+
+    return kTfLiteOk;
+}
+
+TfLiteStatus TieredMemoryPlanner::AddBuffer(int size, int firstTimeUsed, int lastTimeUsed) {
+    return AddBuffer(size, firstTimeUsed, lastTimeUsed, -1);
+}
+
+TfLiteStatus TieredMemoryPlanner::AddBuffer(int size, int firstTimeUsed, int lastTimeUsed, int offlineOffset) {
+    if (planned) {
+        LOG_ERR("Buffer added after planning");
+        return kTfLiteError;
+    }
+
+    placement.addBuffer(size, firstTimeUsed, lastTimeUsed, offlineOffset);
+
+    return kTfLiteOk;
+}
+
+size_t TieredMemoryPlanner::GetMaximumMemorySize() {
+    if (plan()) {
+        // Fail the allocation with an arena size error
+        return std::numeric_limits<size_t>::max();
+    }
+
+    return placement.getFastUsedBytes();
+}
+
+int TieredMemoryPlanner::GetBufferCount() {
+    return placement.getBuffers().size();
+}
+
+TfLiteStatus TieredMemoryPlanner::GetOffsetForBuffer(int bufferIndex, int *offset) {
+    if (plan() || bufferIndex < 0 || bufferIndex >= GetBufferCount()) {
+        return kTfLiteError;
+    }
+
+    const ArenaPlacement::Buffer &buffer = placement.getBuffers()[bufferIndex];
+
+    if (buffer.fast) {
+        *offset = buffer.offset;
+        return kTfLiteOk;
+    }
+
+    // Spilled buffers are addressed relative to the fast arena, which is where the allocator adds the offsets to
+    const ptrdiff_t distance = spill + buffer.offset - fastArena;
+    if (distance < std::numeric_limits<int>::min() || distance > std::numeric_limits<int>::max()) {
+        LOG_ERR("Slow arena out of reach of the fast arena: buffer=%d", bufferIndex);
+        return kTfLiteError;
+    }
+
+    *offset = static_cast<int>(distance);
+
+    return kTfLiteOk;
+}
+
+const ArenaPlacement &TieredMemoryPlanner::getPlacement() const {
+    return placement;
+}
+
+size_t TieredMemoryPlanner::getFastUsedBytes() const {
+    return nonPersistent != nullptr ? nonPersistent->GetNonPersistentUsedBytes() : 0;
+}
+
+size_t TieredMemoryPlanner::getSlowUsedBytes() const {
+    return persistent != nullptr ? persistent->GetPersistentUsedBytes() : 0;
+}
+
+bool TieredMemoryPlanner::plan() {
+    if (planned) {
+        return failed;
+    }
+
+    planned = true;
+    failed  = true;
+
+    if (placement.place()) {
+        LOG_ERR("Offline planned buffers do not fit in fast arena: size=%zu", fastArenaSize);
+        return true;
+    }
+
+    const size_t slowUsed = placement.getSlowUsedBytes();
+    if (slowUsed > 0) {
+        if (persistent == nullptr) {
+            LOG_ERR("Buffers spilled without a slow arena");
+            return true;
+        }
+
+        spill = persistent->AllocatePersistentBuffer(slowUsed, tflite::MicroArenaBufferAlignment());
+        if (spill == nullptr) {
+            LOG_ERR("Slow arena too small for spilled buffers: size=%zu", slowUsed);
+            return true;
+        }
+    }
+
+    failed = false;
+
+    return false;
+}
+
+} // namespace InferenceProcess
@@ -0,0 +1,503 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2023 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Generate the firmware configuration of one or more network models, run on the host at build time by
+ * ethosu_add_model().
+ *
+ * Every model is loaded into a host build of TFLM with all operators of micro_mutable_all_ops.h. The Ethos-U
+ * operator has no kernel on the host, so it is registered without kernel. The tool writes:
+ *
+ *   <name>_resolver.h  A get_resolver() registering only the operators of the models, to be selected with
+ *                      INFERENCE_PROCESS_OPS_RESOLVER.
+ *   <name>.h           The tensor arena size and the input and output tensor sizes of every model.
+ *   <name>.cc          The models and a ModelDescriptor table.
+ *
+ * The arena size is the number of arena bytes used after allocating the tensors on the host, like openSession()
+ * does, plus a margin. Pointers are larger on a 64 bit host, which makes the measurement an upper bound for the
+ * persistent allocations, but the kernels of the target, for example CMSIS-NN or the Ethos-U operator, may request
+ * scratch buffers the reference kernels do not. The margin covers these, and defaults to 4 KiB, which holds the
+ * scratch buffers CMSIS-NN requests for typical convolutions.
+ *
+ * With --partial-jobs the arena of a model with signatures or more than one subgraph also holds the copy of the model
+ * that partial jobs narrow down to their signature or subgraph, see ModelView. The interpreter of a partial job plans
+ * a single subgraph, which never needs more than the measurement of all subgraphs.
+ */
+
+#include "micro_mutable_all_ops.h"
+
+#include "tensorflow/lite/micro/micro_allocator.h"
+#include "tensorflow/lite/micro/micro_interpreter.h"
+#include "tensorflow/lite/micro/micro_resource_variable.h"
+#include "tensorflow/lite/schema/schema_generated.h"
+#include "tensorflow/lite/schema/schema_utils.h"
+
+#include <algorithm>
+#include <ctype.h>
+#include <fstream>
+#include <memory>
+#include <set>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+namespace {
+
+constexpr size_t Alignment = 16;
+
+struct Config {
+    vector<string> models;
+    string outputDir    = ".";
+    string name         = "model_config";
+    string section      = "network_model_sec";
+    size_t arenaMargin  = 4096;
+    size_t maxArenaSize = 64 * 1024 * 1024;
+    bool partialJobs    = false;
+};
+
+struct Model {
+    string name;
+    vector<uint8_t> data;
+    set<string> ops;
+    size_t arenaSize;
+    vector<size_t> inputSizes;
+    vector<size_t> outputSizes;
+};
+
+// Add function of every operator, to find the function registering an operator of a model
+using ProbeResolver = tflite::MicroMutableOpResolver<1>;
+
+struct OpInfo {
+    const char *name;
+    TfLiteStatus (*add)(ProbeResolver &resolver);
+};
+
+#define OP_INFO(op) {#op, [](ProbeResolver &resolver) { return resolver.Add##op(); }},
+const OpInfo allOps[] = {INFERENCE_PROCESS_ALL_OPS(OP_INFO)};
+#undef OP_INFO
+
+const char *const EthosUName = "ethos-u";
+
+// The Ethos-U operator without kernel
+tflite::TFLMRegistration ethosuRegistration = {};
+
+using Buffer = unique_ptr<uint8_t, decltype(&free)>;
+
+size_t alignUp(size_t size) {
+    return (size + Alignment - 1) / Alignment * Alignment;
+}
+
+Buffer allocate(size_t size) {
+    return Buffer(static_cast<uint8_t *>(aligned_alloc(Alignment, alignUp(size))), free);
+}
+
+string toIdentifier(const string &text) {
+    string id;
+
+    for (char c : text) {
+        id += isalnum(static_cast<unsigned char>(c)) ? c : '_';
+    }
+
+    if (id.empty() || isdigit(static_cast<unsigned char>(id[0]))) {
+        id = "model_" + id;
+    }
+
+    return id;
+}
+
+string baseName(const string &path) {
+    const size_t slash = path.find_last_of("/\\");
+    string name        = slash == string::npos ? path : path.substr(slash + 1);
+    const size_t dot   = name.find_last_of('.');
+
+    return dot == string::npos ? name : name.substr(0, dot);
+}
+
+bool readFile(const string &path, vector<uint8_t> &data) {
+    ifstream file(path, ios::binary);
+    if (!file) {
+        fprintf(stderr, "Failed to open %s\n", path.c_str());
+        return true;
+    }
+
+    data.assign(istreambuf_iterator<char>(file), istreambuf_iterator<char>());
+
+    return false;
+}
+
+// Name of the Add function registering an operator
+const char *findOp(tflite::BuiltinOperator code, const char *customName) {
+    if (code == tflite::BuiltinOperator_CUSTOM && strcmp(customName, EthosUName) == 0) {
+        return "EthosU";
+    }
+
+    for (const OpInfo &info : allOps) {
+        ProbeResolver resolver;
+
+        if (info.add(resolver) != kTfLiteOk) {
+            continue;
+        }
+
+        const tflite::TFLMRegistration *registration =
+            code == tflite::BuiltinOperator_CUSTOM ? resolver.FindOp(customName) : resolver.FindOp(code);
+        if (registration != nullptr) {
+            return info.name;
+        }
+    }
+
+    return nullptr;
+}
+
+bool findOps(const tflite::Model *model, Model &m) {
+    for (const tflite::OperatorCode *opcode : *model->operator_codes()) {
+        const tflite::BuiltinOperator code = tflite::GetBuiltinCode(opcode);
+        const char *customName = opcode->custom_code() != nullptr ? opcode->custom_code()->c_str() : "";
+        const char *op         = findOp(code, customName);
+
+        if (op == nullptr) {
+            fprintf(stderr,
+                    "%s: operator not supported: %s\n",
+                    m.name.c_str(),
+                    code == tflite::BuiltinOperator_CUSTOM ? customName : tflite::EnumNameBuiltinOperator(code));
+            return true;
+        }
+
+        m.ops.insert(op);
+    }
+
+    return false;
+}
+
+size_t countOps(const tflite::Model *model, tflite::BuiltinOperator code) {
+    size_t count = 0;
+
+    for (const tflite::SubGraph *subgraph : *model->subgraphs()) {
+        if (subgraph->operators() == nullptr) {
+            continue;
+        }
+
+        for (const tflite::Operator *op : *subgraph->operators()) {
+            if (tflite::GetBuiltinCode(model->operator_codes()->Get(op->opcode_index())) == code) {
+                count++;
+            }
+        }
+    }
+
+    return count;
+}
+
+bool measure(const Config &cfg, const tflite::Model *model, Model &m) {
+    static tflite::MicroMutableOpResolver<kNumberOperators> resolver;
+    static bool populated = false;
+
+    if (!populated) {
+        add_all_ops(resolver);
+
+        if (resolver.FindOp(EthosUName) == nullptr) {
+            resolver.AddCustom(EthosUName, &ethosuRegistration);
+        }
+
+        populated = true;
+    }
+
+    Buffer arena = allocate(cfg.maxArenaSize);
+    if (!arena) {
+        fprintf(stderr, "%s: failed to allocate arena, size=%zu\n", m.name.c_str(), cfg.maxArenaSize);
+        return true;
+    }
+
+    tflite::MicroAllocator *allocator = tflite::MicroAllocator::Create(arena.get(), cfg.maxArenaSize);
+    if (allocator == nullptr) {
+        fprintf(stderr, "%s: failed to create allocator\n", m.name.c_str());
+        return true;
+    }
+
+    // Reserve one resource variable per VAR_HANDLE operator
+    const int numVariables = static_cast<int>(countOps(model, tflite::BuiltinOperator_VAR_HANDLE));
+
+    tflite::MicroResourceVariables *resourceVariables = nullptr;
+    if (numVariables > 0) {
+        resourceVariables = tflite::MicroResourceVariables::Create(allocator, numVariables);
+        if (resourceVariables == nullptr) {
+            fprintf(stderr, "%s: failed to create resource variables\n", m.name.c_str());
+            return true;
+        }
+    }
+
+    tflite::MicroInterpreter interpreter(model, resolver, allocator, resourceVariables);
+
+    if (interpreter.AllocateTensors() != kTfLiteOk) {
+        fprintf(stderr, "%s: failed to allocate tensors, arena=%zu\n", m.name.c_str(), cfg.maxArenaSize);
+        return true;
+    }
+
+    m.arenaSize = alignUp(interpreter.arena_used_bytes() + cfg.arenaMargin);
+
+    // Copy of the model for partial jobs, placed at the first aligned address of the arena
+    const bool partial = model->subgraphs()->size() > 1 ||
+                         (model->signature_defs() != nullptr && model->signature_defs()->size() > 0);
+    if (cfg.partialJobs && partial) {
+        m.arenaSize += alignUp(m.data.size() + Alignment - 1);
+    }
+
+    for (size_t i = 0; i < interpreter.inputs_size(); i++) {
+        m.inputSizes.push_back(interpreter.input(i)->bytes);
+    }
+
+    for (size_t i = 0; i < interpreter.outputs_size(); i++) {
+        m.outputSizes.push_back(interpreter.output(i)->bytes);
+    }
+
+    return false;
+}
+
+bool load(const Config &cfg, const string &path, Model &m) {
+    m.name = toIdentifier(baseName(path));
+
+    if (readFile(path, m.data)) {
+        return true;
+    }
+
+    if (m.data.empty()) {
+        fprintf(stderr, "%s: empty model\n", path.c_str());
+        return true;
+    }
+
+    // Copy to an aligned buffer, the interpreter reads the model in place
+    Buffer aligned = allocate(m.data.size());
+    if (!aligned) {
+        fprintf(stderr, "%s: failed to allocate model, size=%zu\n", path.c_str(), m.data.size());
+        return true;
+    }
+
+    copy(m.data.begin(), m.data.end(), aligned.get());
+
+    flatbuffers::Verifier verifier(aligned.get(), m.data.size());
+    if (!tflite::VerifyModelBuffer(verifier)) {
+        fprintf(stderr, "%s: invalid model\n", path.c_str());
+        return true;
+    }
+
+    const tflite::Model *model = tflite::GetModel(aligned.get());
+    if (model->version() != TFLITE_SCHEMA_VERSION) {
+        fprintf(stderr, "%s: unsupported schema version %u\n", path.c_str(), model->version());
+        return true;
+    }
+
+    return findOps(model, m) || measure(cfg, model, m);
+}
+
+void writeSizes(ofstream &out, const char *name, const vector<size_t> &sizes) {
+    out << "constexpr size_t " << name << "[] = {";
+
+    for (size_t i = 0; i < sizes.size(); i++) {
+        out << (i > 0 ? ", " : "") << sizes[i];
+    }
+
+    // Arrays can not be empty
+    if (sizes.empty()) {
+        out << "0";
+    }
+
+    out << "};\n";
+}
+
+bool writeResolver(const Config &cfg, const vector<Model> &models) {
+    set<string> ops;
+    for (auto &m : models) {
+        ops.insert(m.ops.begin(), m.ops.end());
+    }
+
+    const string path = cfg.outputDir + "/" + cfg.name + "_resolver.h";
+    ofstream out(path);
+
+    out << "// Generated by model_config, do not edit\n\n"
+        << "#pragma once\n\n"
+        << "#include <tensorflow/lite/micro/micro_mutable_op_resolver.h>\n\n"
+        << "constexpr int kNumberOperators = " << ops.size() << ";\n\n"
+        << "inline tflite::MicroMutableOpResolver<kNumberOperators> get_resolver() {\n"
+        << "    tflite::MicroMutableOpResolver<kNumberOperators> micro_op_resolver;\n\n";
+
+    for (auto &op : ops) {
+        out << "    micro_op_resolver.Add" << op << "();\n";
+    }
+
+    out << "\n    return micro_op_resolver;\n}\n";
+
+    return !out;
+}
+
+bool writeHeader(const Config &cfg, const vector<Model> &models) {
+    size_t arenaSize = 0;
+    for (auto &m : models) {
+        arenaSize = max(arenaSize, m.arenaSize);
+    }
+
+    const string path = cfg.outputDir + "/" + cfg.name + ".h";
+    ofstream out(path);
+
+    out << "// Generated by model_config, do not edit\n\n"
+        << "#pragma once\n\n"
+        << "#include \"model_descriptor.hpp\"\n\n"
+        << "#include <stddef.h>\n\n"
+        << "namespace " << cfg.name << " {\n\n"
+        << "// Tensor arena size fitting every model\n"
+        << "constexpr size_t kArenaSize = " << arenaSize << ";\n\n";
+
+    for (auto &m : models) {
+        out << "namespace " << m.name << " {\n"
+            << "constexpr size_t kArenaSize = " << m.arenaSize << ";\n";
+        writeSizes(out, "kInputSizes", m.inputSizes);
+        writeSizes(out, "kOutputSizes", m.outputSizes);
+        out << "} // namespace " << m.name << "\n\n";
+    }
+
+    out << "constexpr size_t kNumModels = " << models.size() << ";\n\n"
+        << "extern const InferenceProcess::ModelDescriptor kModels[kNumModels];\n\n"
+        << "} // namespace " << cfg.name << "\n";
+
+    return !out;
+}
+
+bool writeSource(const Config &cfg, const vector<Model> &models) {
+    const string path = cfg.outputDir + "/" + cfg.name + ".cc";
+    ofstream out(path);
+
+    out << "// Generated by model_config, do not edit\n\n"
+        << "#include \"" << cfg.name << ".h\"\n\n"
+        << "#include <stdint.h>\n\n"
+        << "namespace " << cfg.name << " {\n\n"
+        << "namespace {\n";
+
+    for (auto &m : models) {
+        char line[8];
+
+        out << "const uint8_t " << m.name << "_model[] __attribute__((aligned(16), section(\"" << cfg.section
+            << "\"))) = {";
+
+        for (size_t i = 0; i < m.data.size(); i++) {
+            snprintf(line, sizeof(line), "0x%02x", m.data[i]);
+            out << (i % 16 == 0 ? "\n    " : " ") << line << ",";
+        }
+
+        out << "\n};\n";
+    }
+
+    out << "} // namespace\n\n"
+        << "const InferenceProcess::ModelDescriptor kModels[kNumModels] = {\n";
+
+    for (auto &m : models) {
+        out << "    {\"" << m.name << "\", " << m.name << "_model, sizeof(" << m.name << "_model), " << m.name
+            << "::kArenaSize, " << m.name << "::kInputSizes, " << m.inputSizes.size() << ", " << m.name
+            << "::kOutputSizes, " << m.outputSizes.size() << "},\n";
+    }
+
+    out << "};\n\n"
+        << "} // namespace " << cfg.name << "\n";
+
+    return !out;
+}
+
+void usage(const char *name) {
+    printf("Usage: %s [options] MODEL...\n"
+           "  -o, --output DIR     Output directory\n"
+           "  -n, --name NAME      Name of the generated files and namespace\n"
+           "  -s, --section NAME   Linker section of the models\n"
+           "  --arena-margin N     Bytes added to the measured arena size, default 4096\n"
+           "  --max-arena N        Size of the arena used for the measurement\n"
+           "  --partial-jobs       Add the copy of the model used by partial jobs to the arena size\n",
+           name);
+}
+
+bool parse(int argc, char *argv[], Config &cfg) {
+    for (int i = 1; i < argc; i++) {
+        const string arg = argv[i];
+
+        if (arg[0] != '-') {
+            cfg.models.push_back(arg);
+            continue;
+        }
+
+        if (arg == "--partial-jobs") {
+            cfg.partialJobs = true;
+            continue;
+        }
+
+        if (arg == "--help" || i + 1 >= argc) {
+            return true;
+        }
+
+        if (arg == "-o" || arg == "--output") {
+            cfg.outputDir = argv[++i];
+        } else if (arg == "-n" || arg == "--name") {
+            cfg.name = toIdentifier(argv[++i]);
+        } else if (arg == "-s" || arg == "--section") {
+            cfg.section = argv[++i];
+        } else if (arg == "--arena-margin") {
+            cfg.arenaMargin = strtoul(argv[++i], nullptr, 0);
+        } else if (arg == "--max-arena") {
+            cfg.maxArenaSize = strtoul(argv[++i], nullptr, 0);
+        } else {
+            return true;
+        }
+    }
+
+    return cfg.models.empty() || cfg.maxArenaSize == 0;
+}
+} // namespace
+
+int main(int argc, char *argv[]) {
+    Config cfg;
+    if (parse(argc, argv, cfg)) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    vector<Model> models(cfg.models.size());
+
+    for (size_t i = 0; i < cfg.models.size(); i++) {
+        if (load(cfg, cfg.models[i], models[i])) {
+            return 1;
+        }
+
+        for (size_t j = 0; j < i; j++) {
+            if (models[j].name == models[i].name) {
+                fprintf(stderr, "%s: duplicate model name %s\n", cfg.models[i].c_str(), models[i].name.c_str());
+                return 1;
+            }
+        }
+
+        printf("Model %s: operators=%zu, arena=%zu, inputs=%zu, outputs=%zu\n",
+               models[i].name.c_str(),
+               models[i].ops.size(),
+               models[i].arenaSize,
+               models[i].inputSizes.size(),
+               models[i].outputSizes.size());
+    }
+
+    if (writeResolver(cfg, models) || writeHeader(cfg, models) || writeSource(cfg, models)) {
+        fprintf(stderr, "Failed to write %s to %s\n", cfg.name.c_str(), cfg.outputDir.c_str());
+        return 1;
+    }
+
+    return 0;
+}
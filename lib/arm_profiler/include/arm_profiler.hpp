@@ -31,19 +31,72 @@ public:
     uint32_t BeginEvent(const char *tag);
     void EndEvent(uint32_t event_handle);
     uint64_t GetTotalTicks() const;
+    size_t GetNumEvents() const;
+    uint32_t GetEventTicks(size_t index) const;
     void ReportResults() const;
+    void ClearEvents();
+
+protected:
+    // Use caller provided storage for max_events events
+    ArmProfiler(size_t max_events, const char **tags, int32_t *start_ticks, int32_t *end_ticks);
 
 private:
     size_t max_events_;
-    std::unique_ptr<const char *[]> tags_;
-    std::unique_ptr<int32_t[]> start_ticks_;
-    std::unique_ptr<int32_t[]> end_ticks_;
+    std::unique_ptr<const char *[]> tags_storage_;
+    std::unique_ptr<int32_t[]> start_ticks_storage_;
+    std::unique_ptr<int32_t[]> end_ticks_storage_;
+    const char **tags_;
+    int32_t *start_ticks_;
+    int32_t *end_ticks_;
 
     size_t num_events_;
 
     TF_LITE_REMOVE_VIRTUAL_DELETE;
 };
 
+// Profiler with compile time sized storage, which does not use the heap
+template <size_t MaxEvents>
+class StaticArmProfiler : public ArmProfiler {
+public:
+    StaticArmProfiler() : ArmProfiler(MaxEvents, tags_, start_ticks_, end_ticks_) {}
+
+private:
+    const char *tags_[MaxEvents];
+    int32_t start_ticks_[MaxEvents];
+    int32_t end_ticks_[MaxEvents];
+};
+
+// Pool of reusable profilers. Acquired profilers are cleared and returned to the pool with Release().
+template <size_t MaxEvents, size_t NumProfilers>
+class ArmProfilerPool {
+public:
+    ArmProfilerPool() : used_() {}
+
+    ArmProfiler *Acquire() {
+        for (size_t i = 0; i < NumProfilers; ++i) {
+            if (!used_[i]) {
+                used_[i] = true;
+                profilers_[i].ClearEvents();
+                return &profilers_[i];
+            }
+        }
+
+        return nullptr;
+    }
+
+    void Release(ArmProfiler *profiler) {
+        for (size_t i = 0; i < NumProfilers; ++i) {
+            if (profiler == &profilers_[i]) {
+                used_[i] = false;
+            }
+        }
+    }
+
+private:
+    StaticArmProfiler<MaxEvents> profilers_[NumProfilers];
+    bool used_[NumProfilers];
+};
+
 } // namespace tflite
 
 #endif
@@ -29,11 +29,18 @@
 namespace tflite {
 
 ArmProfiler::ArmProfiler(size_t max_events) : max_events_(max_events), num_events_(0) {
-    tags_        = std::make_unique<const char *[]>(max_events_);
-    start_ticks_ = std::make_unique<int32_t[]>(max_events_);
-    end_ticks_   = std::make_unique<int32_t[]>(max_events_);
+    tags_storage_        = std::make_unique<const char *[]>(max_events_);
+    start_ticks_storage_ = std::make_unique<int32_t[]>(max_events_);
+    end_ticks_storage_   = std::make_unique<int32_t[]>(max_events_);
+
+    tags_        = tags_storage_.get();
+    start_ticks_ = start_ticks_storage_.get();
+    end_ticks_   = end_ticks_storage_.get();
 }
 
+ArmProfiler::ArmProfiler(size_t max_events, const char **tags, int32_t *start_ticks, int32_t *end_ticks) :
+    max_events_(max_events), tags_(tags), start_ticks_(start_ticks), end_ticks_(end_ticks), num_events_(0) {}
+
 uint32_t ArmProfiler::BeginEvent(const char *tag) {
     if (num_events_ == max_events_) {
         MicroPrintf("Profiling event overflow, max: %u events", max_events_);
@@ -62,6 +69,15 @@ uint64_t ArmProfiler::GetTotalTicks() const {
     return ticks;
 }
 
+size_t ArmProfiler::GetNumEvents() const {
+    return num_events_;
+}
+
+uint32_t ArmProfiler::GetEventTicks(size_t index) const {
+    TFLITE_DCHECK(index < num_events_);
+    return end_ticks_[index] - start_ticks_[index];
+}
+
 void ArmProfiler::ReportResults() const {
     MicroPrintf("Profiler report, CPU cycles per operator:");
     for (size_t i = 0; i < num_events_; ++i) {
@@ -69,4 +85,8 @@ void ArmProfiler::ReportResults() const {
     }
 }
 
+void ArmProfiler::ClearEvents() {
+    num_events_ = 0;
+}
+
 } // namespace tflite
@@ -41,31 +41,46 @@
 #define ETHOSU_LOG_SEVERITY ETHOSU_LOG_WARN
 #endif
 
-// Log formatting
+// Log formatting. With ETHOSU_LOG_TOKENIZED defined C++ sources emit tokenized messages, see ethosu_log_tokenized.hpp,
+// and C sources format the messages as text.
 
+#if defined(ETHOSU_LOG_TOKENIZED) && defined(__cplusplus)
+#include "ethosu_log_tokenized.hpp"
+
+#define LOG(f, ...)                  ETHOSU_LOG_ENCODE("L", stdout, f, ##__VA_ARGS__)
+#define ETHOSU_LOG_ERR_OUT(f, ...)   ETHOSU_LOG_ENCODE("E", stderr, f, ##__VA_ARGS__)
+#define ETHOSU_LOG_WARN_OUT(f, ...)  ETHOSU_LOG_ENCODE("W", stdout, f, ##__VA_ARGS__)
+#define ETHOSU_LOG_INFO_OUT(f, ...)  ETHOSU_LOG_ENCODE("I", stdout, f, ##__VA_ARGS__)
+#define ETHOSU_LOG_DEBUG_OUT(f, ...) ETHOSU_LOG_ENCODE("D", stdout, "%s(): " f, __FUNCTION__, ##__VA_ARGS__)
+#else
 #define LOG(f, ...) (void)fprintf(stdout, f, ##__VA_ARGS__)
+#define ETHOSU_LOG_ERR_OUT(f, ...) \
+    (void)fprintf(stderr, "E: " f " (%s:%d)\n", ##__VA_ARGS__, strrchr("/" __FILE__, '/') + 1, __LINE__)
+#define ETHOSU_LOG_WARN_OUT(f, ...)  (void)fprintf(stdout, "W: " f "\n", ##__VA_ARGS__)
+#define ETHOSU_LOG_INFO_OUT(f, ...)  (void)fprintf(stdout, "I: " f "\n", ##__VA_ARGS__)
+#define ETHOSU_LOG_DEBUG_OUT(f, ...) (void)fprintf(stdout, "D: %s(): " f "\n", __FUNCTION__, ##__VA_ARGS__)
+#endif
 
 #if ETHOSU_LOG_SEVERITY >= ETHOSU_LOG_ERR
-#define LOG_ERR(f, ...) \
-    (void)fprintf(stderr, "E: " f " (%s:%d)\n", ##__VA_ARGS__, strrchr("/" __FILE__, '/') + 1, __LINE__)
+#define LOG_ERR(f, ...) ETHOSU_LOG_ERR_OUT(f, ##__VA_ARGS__)
 #else
 #define LOG_ERR(f, ...)
 #endif
 
 #if ETHOSU_LOG_SEVERITY >= ETHOSU_LOG_WARN
-#define LOG_WARN(f, ...) (void)fprintf(stdout, "W: " f "\n", ##__VA_ARGS__)
+#define LOG_WARN(f, ...) ETHOSU_LOG_WARN_OUT(f, ##__VA_ARGS__)
 #else
 #define LOG_WARN(f, ...)
 #endif
 
 #if ETHOSU_LOG_SEVERITY >= ETHOSU_LOG_INFO
-#define LOG_INFO(f, ...) (void)fprintf(stdout, "I: " f "\n", ##__VA_ARGS__)
+#define LOG_INFO(f, ...) ETHOSU_LOG_INFO_OUT(f, ##__VA_ARGS__)
 #else
 #define LOG_INFO(f, ...)
 #endif
 
 #if ETHOSU_LOG_SEVERITY >= ETHOSU_LOG_DEBUG
-#define LOG_DEBUG(f, ...) (void)fprintf(stdout, "D: %s(): " f "\n", __FUNCTION__, ##__VA_ARGS__)
+#define LOG_DEBUG(f, ...) ETHOSU_LOG_DEBUG_OUT(f, ##__VA_ARGS__)
 #else
 #define LOG_DEBUG(f, ...)
 #endif
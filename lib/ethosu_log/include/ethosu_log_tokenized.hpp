@@ -0,0 +1,219 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2023 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ETHOSU_LOG_TOKENIZED_H
+#define ETHOSU_LOG_TOKENIZED_H
+
+/*
+ * Tokenized logging. Every log call site stores its severity, location and format string as an entry in its own
+ * .ethosu_log_strings.* section, so that the entries of inline functions do not conflict. The token of the call site
+ * is the FNV-1a hash of the entry, computed at compile time. At run time only the token and the arguments are
+ * encoded, without any formatting, and written as a line holding a '$' followed by the message in base64. Integers
+ * are zigzag varints, pointers varints, floating point values 32 bit floats and strings a length followed by the
+ * characters. Strings longer than ETHOSU_LOG_TOKENIZED_MAX_STRING are cut.
+ *
+ * ETHOSU_LOG_BASE64() logs binary data as records holding up to MaxBytes bytes each, which the decoder prints in
+ * base64 without line breaks.
+ *
+ * The string section must not be loaded to the device. Place it in a non allocated section in the linker script:
+ *
+ *   .ethosu_log_strings (INFO) : { KEEP(*(.ethosu_log_strings.*)) }
+ *
+ * GCC ignores the section of static variables in function templates, see GCC bug 88061, so messages logged from
+ * function templates are decoded as unknown tokens when built with GCC.
+ *
+ * scripts/ethosu_log_tokens.py extracts the string table from the linked image to a host side file, and decodes the
+ * log lines to text.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <type_traits>
+
+#ifndef ETHOSU_LOG_TOKENIZED_MAX_SIZE
+#define ETHOSU_LOG_TOKENIZED_MAX_SIZE 64
+#endif
+
+#ifndef ETHOSU_LOG_TOKENIZED_MAX_STRING
+#define ETHOSU_LOG_TOKENIZED_MAX_STRING 32
+#endif
+
+#define ETHOSU_LOG_STRINGIFY_IMPL(x) #x
+#define ETHOSU_LOG_STRINGIFY(x)      ETHOSU_LOG_STRINGIFY_IMPL(x)
+
+#define ETHOSU_LOG_SECTION                                                                                           \
+    ".ethosu_log_strings." ETHOSU_LOG_STRINGIFY(__LINE__) "." ETHOSU_LOG_STRINGIFY(__COUNTER__)
+
+#define ETHOSU_LOG_BASE64(stream, bytes, length)                                                                     \
+    do {                                                                                                             \
+        for (size_t ethosu_log_i = 0; ethosu_log_i < (length); ethosu_log_i += EthosuLog::MaxBytes) {                \
+            const size_t ethosu_log_n = (length)-ethosu_log_i;                                                       \
+            ETHOSU_LOG_ENCODE("B",                                                                                   \
+                              stream,                                                                                \
+                              "",                                                                                    \
+                              EthosuLog::Bytes{(bytes) + ethosu_log_i,                                               \
+                                               ethosu_log_n < EthosuLog::MaxBytes ? ethosu_log_n                     \
+                                                                                  : EthosuLog::MaxBytes});           \
+        }                                                                                                            \
+    } while (0)
+
+#define ETHOSU_LOG_ENCODE(level, stream, f, ...)                                                                     \
+    do {                                                                                                             \
+        __attribute__((section(ETHOSU_LOG_SECTION), used)) static constexpr char ethosu_log_entry[] =                \
+            level __FILE__ ":" ETHOSU_LOG_STRINGIFY(__LINE__) "\0" f;                                                \
+        constexpr uint32_t ethosu_log_token = EthosuLog::hash(ethosu_log_entry, sizeof(ethosu_log_entry) - 1);       \
+        EthosuLog::Encoder ethosu_log_encoder(ethosu_log_token);                                                     \
+        ethosu_log_encoder.add(__VA_ARGS__);                                                                         \
+        ethosu_log_encoder.write(stream);                                                                            \
+    } while (0)
+
+namespace EthosuLog {
+
+// Binary data, encoded as a length followed by the bytes
+struct Bytes {
+    const uint8_t *data;
+    size_t size;
+};
+
+// Bytes per base64 record, after the token and a two byte length. A multiple of 3, so that the base64 of the records
+// joins to the base64 of the data.
+constexpr size_t MaxBytes = (ETHOSU_LOG_TOKENIZED_MAX_SIZE - 4 - 2) / 3 * 3;
+
+static_assert(MaxBytes > 0, "ETHOSU_LOG_TOKENIZED_MAX_SIZE too small for binary data");
+
+constexpr uint32_t hash(const char *data, size_t size) {
+    uint32_t h = 2166136261u;
+
+    for (size_t i = 0; i < size; i++) {
+        h ^= static_cast<uint8_t>(data[i]);
+        h *= 16777619u;
+    }
+
+    return h;
+}
+
+class Encoder {
+public:
+    Encoder(uint32_t token) : size(0), truncated(false) {
+        for (size_t i = 0; i < 4; i++) {
+            data[size++] = static_cast<uint8_t>(token >> (i * 8));
+        }
+    }
+
+    void add() {}
+
+    template <typename T, typename... Args>
+    void add(const T &value, const Args &...args) {
+        encode(value);
+        add(args...);
+    }
+
+    void write(FILE *stream) const {
+        static const char alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+        char line[2 + (ETHOSU_LOG_TOKENIZED_MAX_SIZE + 2) / 3 * 4 + 1];
+        size_t n = 0;
+
+        line[n++] = '$';
+
+        for (size_t i = 0; i < size; i += 3) {
+            const uint32_t b = (data[i] << 16) | (i + 1 < size ? data[i + 1] << 8 : 0) |
+                               (i + 2 < size ? data[i + 2] : 0);
+
+            line[n++] = alphabet[(b >> 18) & 0x3f];
+            line[n++] = alphabet[(b >> 12) & 0x3f];
+            line[n++] = i + 1 < size ? alphabet[(b >> 6) & 0x3f] : '=';
+            line[n++] = i + 2 < size ? alphabet[b & 0x3f] : '=';
+        }
+
+        line[n++] = '\n';
+
+        (void)fwrite(line, 1, n, stream);
+    }
+
+private:
+    template <typename T>
+    typename std::enable_if<std::is_integral<T>::value || std::is_enum<T>::value>::type encode(const T &value) {
+        const int64_t v = static_cast<int64_t>(value);
+        varint((static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63));
+    }
+
+    template <typename T>
+    typename std::enable_if<std::is_floating_point<T>::value>::type encode(const T &value) {
+        const float f = static_cast<float>(value);
+        uint8_t bytes[sizeof(f)];
+
+        memcpy(bytes, &f, sizeof(f));
+        put(bytes, sizeof(bytes));
+    }
+
+    void encode(const char *value) {
+        const char *s       = value != nullptr ? value : "(null)";
+        const size_t length = strnlen(s, ETHOSU_LOG_TOKENIZED_MAX_STRING);
+
+        varint(length);
+        put(reinterpret_cast<const uint8_t *>(s), length);
+    }
+
+    void encode(char *value) {
+        encode(static_cast<const char *>(value));
+    }
+
+    void encode(const Bytes &value) {
+        varint(value.size);
+        put(value.data, value.size);
+    }
+
+    template <typename T>
+    void encode(T *value) {
+        varint(reinterpret_cast<uintptr_t>(value));
+    }
+
+    void varint(uint64_t value) {
+        uint8_t bytes[10];
+        size_t n = 0;
+
+        do {
+            bytes[n] = value & 0x7f;
+            value >>= 7;
+            bytes[n++] |= value != 0 ? 0x80 : 0;
+        } while (value != 0);
+
+        put(bytes, n);
+    }
+
+    // Arguments that do not fit are dropped, and the decoder marks the message as truncated
+    void put(const uint8_t *bytes, size_t n) {
+        if (truncated || size + n > sizeof(data)) {
+            truncated = true;
+            return;
+        }
+
+        memcpy(&data[size], bytes, n);
+        size += n;
+    }
+
+    uint8_t data[ETHOSU_LOG_TOKENIZED_MAX_SIZE];
+    size_t size;
+    bool truncated;
+};
+
+} // namespace EthosuLog
+
+#endif
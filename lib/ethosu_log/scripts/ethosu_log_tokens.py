@@ -0,0 +1,303 @@
+#!/usr/bin/env python3
+#
+# SPDX-FileCopyrightText: Copyright 2023 Arm Limited and/or its affiliates <open-source-office@arm.com>
+# SPDX-License-Identifier: Apache-2.0
+#
+# Licensed under the Apache License, Version 2.0 (the License); you may
+# not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+# www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an AS IS BASIS, WITHOUT
+# WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+
+
+"""
+Extract the string table of tokenized logging and decode tokenized log lines.
+
+  extract  Read the .ethosu_log_strings sections of a linked ELF image and
+           write the string table to a host side file.
+  decode   Replace every tokenized log line, a '$' followed by the message
+           in base64, with the formatted text. Other lines are passed
+           through unchanged.
+
+The token of a log call site is the 32 bit FNV-1a hash of its entry, which
+holds the severity, the location and the format string.
+"""
+
+import argparse
+import base64
+import binascii
+import csv
+import os
+import re
+import struct
+import sys
+
+SECTION = '.ethosu_log_strings'
+
+FORMAT_SPEC = re.compile(r'%([-+ #0]*)(\d+|\*)?(\.(?:\d+|\*))?(hh|h|ll|l|j|z|t|L)?([diouxXeEfFgGaAcspn%])')
+
+PREFIX = {'L': '', 'E': 'E: ', 'W': 'W: ', 'I': 'I: ', 'D': 'D: '}
+
+
+def fnv1a(data):
+    h = 2166136261
+    for byte in data:
+        h = ((h ^ byte) * 16777619) & 0xffffffff
+    return h
+
+
+def elf_sections(path, name):
+    """Return the contents of the sections of an ELF file named name or starting with name followed by a dot."""
+    with open(path, 'rb') as f:
+        elf = f.read()
+
+    if elf[:4] != b'\x7fELF':
+        raise ValueError(f'{path} is not an ELF file')
+
+    is64 = elf[4] == 2
+    endian = '<' if elf[5] == 1 else '>'
+
+    if is64:
+        shoff, = struct.unpack_from(endian + 'Q', elf, 0x28)
+        shentsize, shnum, shstrndx = struct.unpack_from(endian + 'HHH', elf, 0x3a)
+        header = struct.Struct(endian + 'IIQQQQIIQQ')
+    else:
+        shoff, = struct.unpack_from(endian + 'I', elf, 0x20)
+        shentsize, shnum, shstrndx = struct.unpack_from(endian + 'HHH', elf, 0x2e)
+        header = struct.Struct(endian + 'IIIIIIIIII')
+
+    sections = [header.unpack_from(elf, shoff + i * shentsize) for i in range(shnum)]
+    names = sections[shstrndx]
+    strtab = elf[names[4]:names[4] + names[5]]
+
+    data = bytearray()
+    found = False
+
+    for section in sections:
+        section_name = strtab[section[0]:strtab.index(b'\0', section[0])].decode()
+        if section_name == name or section_name.startswith(name + '.'):
+            data += elf[section[4]:section[4] + section[5]] + b'\0'
+            found = True
+
+    if not found:
+        raise ValueError(f'{path} has no section {name}')
+
+    return bytes(data)
+
+
+def parse_entries(data):
+    """Split the section into entries. Each entry is a severity and a location, and a format string."""
+    entries = {}
+    fields = data.split(b'\0')
+    i = 0
+
+    while i < len(fields):
+        # Skip padding between entries
+        if not fields[i]:
+            i += 1
+            continue
+
+        location, fmt = fields[i], fields[i + 1] if i + 1 < len(fields) else b''
+        token = fnv1a(location + b'\0' + fmt)
+        entries[token] = (location[:1].decode(), location[1:].decode(), fmt.decode())
+        i += 2
+
+    return entries
+
+
+def write_table(path, entries):
+    with open(path, 'w', newline='') as f:
+        writer = csv.writer(f)
+        for token, (level, location, fmt) in sorted(entries.items()):
+            writer.writerow([f'{token:08x}', level, location, fmt])
+
+
+def read_table(path):
+    entries = {}
+
+    with open(path, newline='') as f:
+        for token, level, location, fmt in csv.reader(f):
+            entries[int(token, 16)] = (level, location, fmt)
+
+    return entries
+
+
+class Reader:
+    def __init__(self, data):
+        self.data = data
+        self.pos = 0
+
+    def varint(self):
+        value = 0
+        shift = 0
+
+        while True:
+            if self.pos >= len(self.data):
+                raise EOFError
+            byte = self.data[self.pos]
+            self.pos += 1
+            value |= (byte & 0x7f) << shift
+            shift += 7
+            if not byte & 0x80:
+                return value
+
+    def integer(self):
+        value = self.varint()
+        return (value >> 1) ^ -(value & 1)
+
+    def float(self):
+        if self.pos + 4 > len(self.data):
+            raise EOFError
+        value, = struct.unpack_from('<f', self.data, self.pos)
+        self.pos += 4
+        return value
+
+    def bytes(self):
+        length = self.varint()
+        if self.pos + length > len(self.data):
+            raise EOFError
+        value = self.data[self.pos:self.pos + length]
+        self.pos += length
+        return value
+
+    def string(self):
+        return self.bytes().decode(errors='replace')
+
+
+def hex_float(value, upper):
+    """Format like the C %a conversion, which omits trailing zeros of the mantissa."""
+    text = float.hex(value)
+
+    if 'p' in text:
+        mantissa, exponent = text.split('p')
+        text = mantissa.rstrip('0').rstrip('.') + 'p' + exponent
+
+    return text.upper() if upper else text
+
+
+def format_message(fmt, reader, long_bits=32):
+    """Format the message with the arguments read in the order of the format specifiers."""
+    out = []
+    last = 0
+    truncated = False
+
+    for match in FORMAT_SPEC.finditer(fmt):
+        out.append(fmt[last:match.start()])
+        last = match.end()
+        flags, width, precision, length, conversion = match.groups()
+
+        if conversion == '%':
+            out.append('%')
+            continue
+
+        try:
+            # Width and precision given as arguments
+            if width == '*':
+                width = str(reader.integer())
+            if precision == '.*':
+                precision = '.' + str(reader.integer())
+
+            spec = '%' + flags + (width or '') + (precision or '')
+
+            if conversion in 'di':
+                out.append((spec + 'd') % reader.integer())
+            elif conversion in 'ouxX':
+                bits = 64 if length in ('ll', 'j') else long_bits if length in ('l', 'z', 't') else 32
+                out.append((spec + conversion) % (reader.integer() & ((1 << bits) - 1)))
+            elif conversion == 'c':
+                out.append((spec + 'c') % chr(reader.integer() & 0xff))
+            elif conversion == 's':
+                out.append((spec + 's') % reader.string())
+            elif conversion == 'p':
+                out.append((spec + 's') % hex(reader.varint()))
+            elif conversion in 'aA':
+                out.append((spec + 's') % hex_float(reader.float(), conversion == 'A'))
+            elif conversion == 'n':
+                pass
+            else:
+                out.append((spec + conversion.replace('F', 'f')) % reader.float())
+        except EOFError:
+            truncated = True
+            out.append(match.group(0))
+
+    out.append(fmt[last:])
+
+    return ''.join(out), truncated
+
+
+def decode_line(line, entries, long_bits=32):
+    try:
+        data = base64.b64decode(line[1:].strip(), validate=True)
+    except binascii.Error:
+        return line
+
+    if len(data) < 4:
+        return line
+
+    token, = struct.unpack_from('<I', data)
+    if token not in entries:
+        return f'<unknown token {token:08x}>\n'
+
+    level, location, fmt = entries[token]
+
+    # Binary data, joined with the following records
+    if level == 'B':
+        try:
+            return base64.b64encode(Reader(data[4:]).bytes()).decode()
+        except EOFError:
+            return '<truncated>'
+
+    message, truncated = format_message(fmt, Reader(data[4:]), long_bits)
+
+    if truncated:
+        message += ' <truncated>'
+
+    if level == 'L':
+        return message if not truncated else message + '\n'
+
+    if level == 'E':
+        return f'E: {message} ({os.path.basename(location)})\n'
+
+    return f'{PREFIX.get(level, "")}{message}\n'
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    subparsers = parser.add_subparsers(dest='command', required=True)
+
+    extract = subparsers.add_parser('extract', help='Extract the string table from an ELF image')
+    extract.add_argument('elf', help='Linked ELF image')
+    extract.add_argument('-o', '--output', required=True, help='String table file')
+
+    decode = subparsers.add_parser('decode', help='Decode tokenized log lines')
+    source = decode.add_mutually_exclusive_group(required=True)
+    source.add_argument('-t', '--table', help='String table file')
+    source.add_argument('-e', '--elf', help='Linked ELF image')
+    decode.add_argument('--long-bits', type=int, default=32, help='Size of long and size_t on the device')
+    decode.add_argument('input', nargs='?', help='Log file, defaults to stdin')
+
+    args = parser.parse_args()
+
+    if args.command == 'extract':
+        entries = parse_entries(elf_sections(args.elf, SECTION))
+        write_table(args.output, entries)
+        print(f'Extracted {len(entries)} log strings to {args.output}')
+        return
+
+    entries = read_table(args.table) if args.table else parse_entries(elf_sections(args.elf, SECTION))
+
+    with open(args.input, errors='replace') if args.input else sys.stdin as f:
+        for line in f:
+            sys.stdout.write(decode_line(line, entries, args.long_bits) if line.startswith('$') else line)
+            sys.stdout.flush()
+
+
+if __name__ == '__main__':
+    main()
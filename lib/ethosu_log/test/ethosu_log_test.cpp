@@ -0,0 +1,113 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2023 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Log every conversion of the decoder, as text or tokenized depending on ETHOSU_LOG_TOKENIZED.
+ */
+
+#include "ethosu_log.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace {
+
+void printBase64(const uint8_t *data, size_t len) {
+#ifdef ETHOSU_LOG_TOKENIZED
+    ETHOSU_LOG_BASE64(stdout, data, len);
+#else
+    static const char alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+    for (size_t i = 0; i < len; i += 3) {
+        const uint32_t b = (data[i] << 16) | (i + 1 < len ? data[i + 1] << 8 : 0) | (i + 2 < len ? data[i + 2] : 0);
+
+        LOG("%c%c%c%c",
+            alphabet[(b >> 18) & 0x3f],
+            alphabet[(b >> 12) & 0x3f],
+            i + 1 < len ? alphabet[(b >> 6) & 0x3f] : '=',
+            i + 2 < len ? alphabet[b & 0x3f] : '=');
+    }
+#endif
+}
+
+// Same as InferenceProcess::tfluDebugLog()
+void logString(const char *s) {
+#ifdef ETHOSU_LOG_TOKENIZED
+    for (size_t i = 0, n = strlen(s); i < n; i += ETHOSU_LOG_TOKENIZED_MAX_STRING) {
+        LOG("%s", s + i);
+    }
+#else
+    LOG("%s", s);
+#endif
+}
+
+void logDebug(int value) {
+    LOG_DEBUG("value=%d", value);
+}
+
+} // namespace
+
+int main() {
+    LOG("signed: %d %i %d %hhd %hd %ld %lld\n",
+        0,
+        -1,
+        INT32_MIN,
+        -128,
+        32767,
+        -123456789L,
+        static_cast<long long>(INT64_MIN));
+    LOG("unsigned: %u %o %x %X %lu %llx %zu\n",
+        3000000000u,
+        0755u,
+        0xdeadbeefu,
+        0xabcu,
+        4000000000ul,
+        ~0ull,
+        sizeof(int));
+    LOG("negative unsigned: %x %u\n", -1, -2);
+    LOG("char: %c%c%c\n", 'a', '!', '~');
+    LOG("string: %s '%10s' '%-6s' '%.3s'\n", "text", "right", "left", "truncate");
+    LOG("pointer: %p %p\n", reinterpret_cast<void *>(0x1234), reinterpret_cast<void *>(0x80000000u));
+    LOG("float: %f %.2f %e %E %g %G\n", 1.5, -0.25, 1024.0, 0.125, 100000.0, 1e-5f);
+    LOG("hex float: %a %A %a %a\n", 1.0, -0.75, 0.0, 3.0);
+    LOG("width: %5d|%-5d|%05d|%+d|%*d|%.*f\n", 42, 42, 42, 42, 6, -7, 3, 2.5);
+    LOG("percent: 100%%\n");
+    LOG("no newline, ");
+    LOG("joined\n");
+
+    logString("A message longer than the tokenized string limit is split over records and joined again\n");
+
+    LOG_ERR("error: code=%d", -5);
+    LOG_WARN("warning: %s", "low memory");
+    LOG_INFO("info: %u jobs", 3u);
+    logDebug(7);
+
+    uint8_t data[200];
+    for (size_t i = 0; i < sizeof(data); i++) {
+        data[i] = static_cast<uint8_t>(i * 37 + 11);
+    }
+
+    const size_t lengths[] = {0, 1, 2, 3, 57, 58, 200};
+    for (size_t len : lengths) {
+        LOG("base64 %zu: ", len);
+        printBase64(data, len);
+        LOG("\n");
+    }
+
+    return 0;
+}
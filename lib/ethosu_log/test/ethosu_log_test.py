@@ -0,0 +1,62 @@
+#!/usr/bin/env python3
+#
+# SPDX-FileCopyrightText: Copyright 2023 Arm Limited and/or its affiliates <open-source-office@arm.com>
+# SPDX-License-Identifier: Apache-2.0
+#
+# Licensed under the Apache License, Version 2.0 (the License); you may
+# not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+# www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an AS IS BASIS, WITHOUT
+# WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+
+
+"""
+Run the text and the tokenized build of the log test, decode the tokenized
+output and compare it with the text output.
+
+  ethosu_log_test.py <text executable> <tokenized executable> <ethosu_log_tokens.py>
+"""
+
+import difflib
+import struct
+import subprocess
+import sys
+
+
+def decode(script, elf, data, long_bits):
+    return subprocess.run([sys.executable, script, 'decode', '-e', elf, '--long-bits', str(long_bits)],
+                          input=data, capture_output=True, text=True, check=True).stdout
+
+
+def main():
+    text, tokenized, script = sys.argv[1:4]
+    long_bits = struct.calcsize('l') * 8
+
+    expected = subprocess.run([text], capture_output=True, text=True, check=True)
+    actual = subprocess.run([tokenized], capture_output=True, text=True, check=True)
+
+    failed = False
+
+    for name, want, encoded in (('stdout', expected.stdout, actual.stdout), ('stderr', expected.stderr, actual.stderr)):
+        got = decode(script, tokenized, encoded, long_bits)
+
+        if got != want:
+            failed = True
+            sys.stdout.writelines(difflib.unified_diff(want.splitlines(True), got.splitlines(True),
+                                                       f'{name} text', f'{name} decoded'))
+
+    if failed:
+        sys.exit(1)
+
+    print('Decoded output matches the text output')
+
+
+if __name__ == '__main__':
+    main()
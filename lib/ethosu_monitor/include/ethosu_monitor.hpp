@@ -27,10 +27,46 @@
 #include <stdint.h>
 #include <vector>
 
+#ifndef ETHOSU_MONITOR_MAX_OPERATORS
+#define ETHOSU_MONITOR_MAX_OPERATORS 32
+#endif
+
+#ifndef ETHOSU_MONITOR_MAX_REGIONS
+#define ETHOSU_MONITOR_MAX_REGIONS 16
+#endif
+
 class EthosUMonitor {
 
 public:
-    enum Backend { PRINTF, EVENT_RECORDER };
+    /**
+     * PRINTF and EVENT_RECORDER output a record of the PMU counters for every sample. HISTOGRAM only counts the
+     * samples per operator and per region of its command stream on the device, see setHistogram().
+     */
+    enum Backend { PRINTF, EVENT_RECORDER, HISTOGRAM };
+
+    /**
+     * Returns the handle of the operator executing when a sample is taken, or -1 if no operator is executing, and
+     * sets tag to its name. Every operator of an inference must have its own handle. Called from monitorSample(), so
+     * it must be safe to call from an interrupt handler.
+     */
+    using ActiveOperator = int32_t (*)(void *arg, const char **tag);
+
+    struct Histogram {
+        // Samples of an operator, and of the regions of its command stream while the NPU was running
+        struct Operator {
+            int32_t event;
+            const char *tag;
+            uint32_t samples;
+            uint32_t overflowSamples;
+            uint32_t regions[ETHOSU_MONITOR_MAX_REGIONS];
+        };
+
+        uint32_t samples;
+        uint32_t idleSamples;
+        uint32_t otherSamples;
+        size_t numOperators;
+        Operator operators[ETHOSU_MONITOR_MAX_OPERATORS];
+    };
 
     /**
      * @param backend   Select which backend to output performance data to.
@@ -71,7 +107,32 @@ public:
 
     size_t getMergeCount() const;
 
+    /**
+     * Configure the HISTOGRAM backend. Every sample is counted for the operator returned by activeOperator, for example
+     * the active event of a LayerByLayerProfiler, and for the region of the operator's command stream holding the
+     * QREAD position of the NPU. Every Ethos-U operator has its own command stream, so the regions are counted per
+     * operator. The command stream is split into regions of regionSize bytes. Samples taken while the NPU is stopped
+     * are counted as idle. Operators are identified by their handle, so clear the histogram before profiling another
+     * network. Clears the histogram.
+     *
+     * The handles of a LayerByLayerProfiler keep counting over inferences until the profiler is cleared, so the
+     * operators of later inferences would get handles of their own. Either clear the profiler before every inference,
+     * or set operatorsPerInference to the number of operators invoked per inference, for example
+     * MicroInterpreter::operators_size(), and the handles are reduced modulo operatorsPerInference. The latter requires
+     * the number of profiler events to be a multiple of operatorsPerInference, as the profiler restarts its handles at
+     * 0 when it overflows.
+     */
+    void setHistogram(uint32_t regionSize,
+                      ActiveOperator activeOperator = nullptr,
+                      void *arg                     = nullptr,
+                      size_t operatorsPerInference  = 0);
+    void clearHistogram();
+    const Histogram &getHistogram() const;
+    void reportHistogram() const;
+
 private:
+    void sampleHistogram(ethosu_driver *drv);
+
     struct EthosuEventRecord {
         uint64_t cycleCount;
         uint32_t qread;
@@ -90,6 +151,11 @@ private:
     const bool merge;
     size_t mergeCount;
     EthosuEventRecord prevRecord;
+    uint32_t regionSize;
+    ActiveOperator activeOperator;
+    void *activeOperatorArg;
+    size_t operatorsPerInference;
+    Histogram histogram;
 };
 
 #endif
@@ -1,5 +1,5 @@
 /*
- * SPDX-FileCopyrightText: Copyright 2021-2022 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ * SPDX-FileCopyrightText: Copyright 2021-2023 Arm Limited and/or its affiliates <open-source-office@arm.com>
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -20,8 +20,22 @@
 #include "ethosu_log.h"
 #include <inttypes.h>
 #include <stdio.h>
+#include <string.h>
 
-EthosUMonitor::EthosUMonitor(Backend __backend, bool _merge) : backend(__backend), merge(_merge) {}
+namespace {
+// STATUS.state, set while the NPU is running a command stream
+constexpr uint32_t StatusRunning = 1u << 0;
+
+uint32_t perMille(uint32_t samples, uint32_t total) {
+    return total > 0 ? static_cast<uint32_t>(static_cast<uint64_t>(samples) * 1000 / total) : 0;
+}
+} // namespace
+
+EthosUMonitor::EthosUMonitor(Backend __backend, bool _merge) :
+    backend(__backend), merge(_merge), regionSize(0), activeOperator(nullptr), activeOperatorArg(nullptr),
+    operatorsPerInference(0) {
+    clearHistogram();
+}
 
 void EthosUMonitor::monitorSample(ethosu_driver *drv) {
     switch (backend) {
@@ -46,6 +60,9 @@ void EthosUMonitor::monitorSample(ethosu_driver *drv) {
         EventRecordData(EventID(EventLevelDetail, EthosuEventComponentNo, 0), &record, sizeof(record));
         break;
     }
+    case HISTOGRAM:
+        sampleHistogram(drv);
+        break;
     case PRINTF:
     default:
         for (size_t i = 0; i < numEvents; i++) {
@@ -61,3 +78,117 @@ void EthosUMonitor::release(ethosu_driver *drv) {
 size_t EthosUMonitor::getMergeCount() const {
     return mergeCount;
 }
+
+void EthosUMonitor::setHistogram(uint32_t _regionSize,
+                                 ActiveOperator _activeOperator,
+                                 void *arg,
+                                 size_t _operatorsPerInference) {
+    regionSize            = _regionSize;
+    activeOperator        = _activeOperator;
+    activeOperatorArg     = arg;
+    operatorsPerInference = _operatorsPerInference;
+    clearHistogram();
+}
+
+void EthosUMonitor::clearHistogram() {
+    memset(&histogram, 0, sizeof(histogram));
+}
+
+const EthosUMonitor::Histogram &EthosUMonitor::getHistogram() const {
+    return histogram;
+}
+
+void EthosUMonitor::sampleHistogram(ethosu_driver *drv) {
+    const char *tag    = nullptr;
+    int32_t event      = activeOperator != nullptr ? activeOperator(activeOperatorArg, &tag) : -1;
+    const bool running = (ETHOSU_PMU_Get_STATUS(drv) & StatusRunning) != 0;
+
+    // Operators of consecutive inferences share the entry of their index in the inference
+    if (event >= 0 && operatorsPerInference > 0) {
+        event = static_cast<int32_t>(static_cast<size_t>(event) % operatorsPerInference);
+    }
+
+    histogram.samples++;
+
+    if (!running) {
+        histogram.idleSamples++;
+    }
+
+    // Operators are matched on the event handle, which differs for operators sharing a tag
+    size_t i = 0;
+    while (i < histogram.numOperators && histogram.operators[i].event != event) {
+        i++;
+    }
+
+    if (i == ETHOSU_MONITOR_MAX_OPERATORS) {
+        histogram.otherSamples++;
+        return;
+    }
+
+    Histogram::Operator &op = histogram.operators[i];
+    if (i == histogram.numOperators) {
+        op.event = event;
+        op.tag   = tag;
+        histogram.numOperators++;
+    }
+
+    op.samples++;
+
+    if (!running) {
+        return;
+    }
+
+    // QREAD is the position in the command stream of the running operator
+    const uint32_t region = regionSize > 0 ? ETHOSU_PMU_Get_QREAD(drv) / regionSize : 0;
+    if (region < ETHOSU_MONITOR_MAX_REGIONS) {
+        op.regions[region]++;
+    } else {
+        op.overflowSamples++;
+    }
+}
+
+void EthosUMonitor::reportHistogram() const {
+    const uint32_t total = histogram.samples;
+
+    LOG("Sampling profiler: samples=%" PRIu32 ", npu idle=%" PRIu32 ", region size=%" PRIu32 "\n",
+        total,
+        histogram.idleSamples,
+        regionSize);
+
+    for (size_t i = 0; i < histogram.numOperators; i++) {
+        const Histogram::Operator &op = histogram.operators[i];
+        const uint32_t share          = perMille(op.samples, total);
+
+        LOG("Operator %" PRId32 " %s: samples=%" PRIu32 " (%" PRIu32 ".%" PRIu32 "%%)\n",
+            op.event,
+            op.tag != nullptr ? op.tag : "<none>",
+            op.samples,
+            share / 10,
+            share % 10);
+
+        for (size_t j = 0; j < ETHOSU_MONITOR_MAX_REGIONS; j++) {
+            if (op.regions[j] == 0) {
+                continue;
+            }
+
+            const uint32_t regionShare = perMille(op.regions[j], op.samples);
+
+            LOG("  Command stream 0x%08" PRIx32 "-0x%08" PRIx32 ": samples=%" PRIu32 " (%" PRIu32 ".%" PRIu32 "%%)\n",
+                static_cast<uint32_t>(j * regionSize),
+                static_cast<uint32_t>((j + 1) * regionSize),
+                op.regions[j],
+                regionShare / 10,
+                regionShare % 10);
+        }
+
+        if (op.overflowSamples > 0) {
+            LOG("  Command stream beyond 0x%08" PRIx32 ": samples=%" PRIu32 "\n",
+                static_cast<uint32_t>(ETHOSU_MONITOR_MAX_REGIONS * regionSize),
+                op.overflowSamples);
+        }
+    }
+
+    if (histogram.otherSamples > 0) {
+        LOG("Operator <other>: samples=%" PRIu32 "\n", histogram.otherSamples);
+    }
+}
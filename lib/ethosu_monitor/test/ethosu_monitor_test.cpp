@@ -0,0 +1,134 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2023 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Run several inferences with a profiler that is not cleared between them, as when TFLM invokes an interpreter
+ * repeatedly, and check that the histogram counts the samples of every inference on the same operators.
+ */
+
+#include "ethosu_monitor.hpp"
+
+#include <stdio.h>
+
+namespace {
+
+constexpr size_t Operators          = 12;
+constexpr size_t Inferences         = 4;
+constexpr size_t SamplesPerOperator = 3;
+constexpr uint32_t RegionSize       = 64;
+
+// Hands out event handles like a LayerByLayerProfiler, counting over inferences
+struct Profiler {
+    int32_t numEvents   = 0;
+    int32_t activeEvent = -1;
+};
+
+int32_t activeOperator(void *arg, const char **tag) {
+    *tag = "ethos-u";
+    return static_cast<Profiler *>(arg)->activeEvent;
+}
+
+void runInferences(EthosUMonitor &monitor, ethosu_driver &drv, Profiler &profiler) {
+    for (size_t i = 0; i < Inferences; i++) {
+        for (size_t j = 0; j < Operators; j++) {
+            profiler.activeEvent = profiler.numEvents++;
+            drv.status           = 1;
+
+            for (size_t k = 0; k < SamplesPerOperator; k++) {
+                drv.qread = static_cast<uint32_t>(k * RegionSize);
+                monitor.monitorSample(&drv);
+            }
+
+            profiler.activeEvent = -1;
+        }
+    }
+
+    // Idle sample between the inferences
+    drv.status = 0;
+    monitor.monitorSample(&drv);
+}
+
+bool check(bool condition, const char *message) {
+    if (!condition) {
+        fprintf(stderr, "FAIL: %s\n", message);
+    }
+
+    return !condition;
+}
+
+bool testOperatorsPerInference() {
+    EthosUMonitor monitor(EthosUMonitor::HISTOGRAM);
+    ethosu_driver drv = {};
+    Profiler profiler;
+
+    monitor.setHistogram(RegionSize, activeOperator, &profiler, Operators);
+    runInferences(monitor, drv, profiler);
+    monitor.reportHistogram();
+
+    const EthosUMonitor::Histogram &histogram = monitor.getHistogram();
+    bool failed                               = false;
+
+    failed |= check(histogram.samples == Inferences * Operators * SamplesPerOperator + 1, "total samples");
+    failed |= check(histogram.idleSamples == 1, "idle samples");
+    failed |= check(histogram.otherSamples == 0, "no samples beyond the operator table");
+    failed |= check(histogram.numOperators == Operators + 1, "one entry per operator and one for no operator");
+
+    for (size_t i = 0; i < Operators; i++) {
+        const EthosUMonitor::Histogram::Operator &op = histogram.operators[i];
+
+        failed |= check(op.event == static_cast<int32_t>(i), "operator index");
+        failed |= check(op.samples == Inferences * SamplesPerOperator, "operator samples of every inference");
+
+        for (size_t j = 0; j < SamplesPerOperator; j++) {
+            failed |= check(op.regions[j] == Inferences, "region samples of every inference");
+        }
+    }
+
+    return failed;
+}
+
+bool testHandlesOverflowTable() {
+    EthosUMonitor monitor(EthosUMonitor::HISTOGRAM);
+    ethosu_driver drv = {};
+    Profiler profiler;
+
+    // Without the number of operators every inference adds new operators until the table is full
+    monitor.setHistogram(RegionSize, activeOperator, &profiler);
+    runInferences(monitor, drv, profiler);
+
+    const EthosUMonitor::Histogram &histogram = monitor.getHistogram();
+    bool failed                               = false;
+
+    failed |= check(histogram.numOperators == ETHOSU_MONITOR_MAX_OPERATORS, "operator table full");
+    failed |= check(histogram.otherSamples > 0, "samples beyond the operator table");
+
+    return failed;
+}
+
+} // namespace
+
+int main() {
+    bool failed = false;
+
+    failed |= testOperatorsPerInference();
+    failed |= testHandlesOverflowTable();
+
+    printf("%s\n", failed ? "FAILED" : "PASSED");
+
+    return failed ? 1 : 0;
+}
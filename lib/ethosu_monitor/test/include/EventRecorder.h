@@ -0,0 +1,33 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2023 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Host fake of the EventRecorder API, dropping the records.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#define EventLevelDetail 0U
+
+#define EventID(level, comp_no, msg_no) ((level) | ((comp_no) << 8) | (msg_no))
+
+static inline uint32_t EventRecordData(uint32_t, const void *, uint32_t) {
+    return 0;
+}
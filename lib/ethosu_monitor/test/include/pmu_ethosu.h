@@ -0,0 +1,57 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2023 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Host fake of the Ethos-U PMU API. QREAD and STATUS are read from the fake driver, the counters are 0.
+ */
+
+#pragma once
+
+#include "ethosu_driver.h"
+
+#include <stdint.h>
+
+#define ETHOSU_PMU_NCOUNTERS 4
+#define ETHOSU_PMU_CCNT_Msk  (1UL << 31)
+
+enum ethosu_pmu_event_type {
+    ETHOSU_PMU_NO_EVENT = 0,
+};
+
+static inline void ETHOSU_PMU_Enable(struct ethosu_driver *) {}
+static inline void ETHOSU_PMU_Disable(struct ethosu_driver *) {}
+static inline void ETHOSU_PMU_Set_EVTYPER(struct ethosu_driver *, uint32_t, enum ethosu_pmu_event_type) {}
+static inline void ETHOSU_PMU_CYCCNT_Reset(struct ethosu_driver *) {}
+static inline void ETHOSU_PMU_EVCNTR_ALL_Reset(struct ethosu_driver *) {}
+static inline void ETHOSU_PMU_CNTR_Enable(struct ethosu_driver *, uint32_t) {}
+
+static inline uint64_t ETHOSU_PMU_Get_CCNTR(struct ethosu_driver *) {
+    return 0;
+}
+
+static inline uint32_t ETHOSU_PMU_Get_EVCNTR(struct ethosu_driver *, uint32_t) {
+    return 0;
+}
+
+static inline uint32_t ETHOSU_PMU_Get_QREAD(struct ethosu_driver *drv) {
+    return drv->qread;
+}
+
+static inline uint32_t ETHOSU_PMU_Get_STATUS(struct ethosu_driver *drv) {
+    return drv->status;
+}
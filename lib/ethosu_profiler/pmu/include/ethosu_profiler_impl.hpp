@@ -0,0 +1,127 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2023 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <ethosu_driver.h>
+#include <pmu_ethosu.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifndef ETHOSU_PROFILER_MAX_OPERATORS
+#define ETHOSU_PROFILER_MAX_OPERATORS 64
+#endif
+
+/**
+ * Ethos-U profiler context measuring every Ethos-U custom operator of an inference with the NPU PMU.
+ *
+ * ethosu_profiler_start() programs the event counters and ethosu_profiler_end() adds the cycle and event counts to
+ * the running operator. The PMU has fewer event counters than there are metrics, so the counters are multiplexed:
+ * every inference, started by ethosu_profiler_reset(), measures the next group of metrics. Running the same network
+ * for as many inferences as there are groups covers all metrics, and every metric is averaged over the inferences
+ * that measured it.
+ *
+ * The driver hooks can not tell where an inference starts. Either set the number of Ethos-U operators per inference
+ * with setOperatorsPerInference(), after which the hooks reset the context when the next inference starts, or call
+ * ethosu_profiler_reset() before every inference.
+ *
+ * ethosu_profiler_report() prints the achieved AXI bandwidth, the MAC utilization and the stall breakdown of every
+ * operator, and a roofline summary classifying every operator as memory bound or compute bound. An operator is memory
+ * bound when its bandwidth is closer to the peak bandwidth of the SoC than its MAC utilization is to the MAC roof.
+ */
+struct ethosu_profiler_context {
+    enum Metric {
+        AXI0_READ,
+        AXI0_WRITE,
+        AXI1_READ,
+        MAC_ACTIVE,
+        NPU_IDLE,
+        MAC_STALLED_BY_WD,
+        MAC_STALLED_BY_ACC,
+        MAC_STALLED_BY_IB,
+        NUM_METRICS
+    };
+
+    struct Operator {
+        uint64_t cycles;
+        uint32_t runs;
+        uint64_t counts[NUM_METRICS];
+        uint32_t countRuns[NUM_METRICS];
+    };
+
+    /**
+     * Derived statistics of an operator. Bandwidth is in bytes per 100 NPU cycles, ratios in per mille.
+     */
+    struct Summary {
+        uint64_t cycles;
+        uint64_t bytes;
+        uint32_t bandwidth;
+        uint32_t bandwidthUtilization;
+        uint32_t macUtilization;
+        uint32_t idle;
+        uint32_t stalledByWeights;
+        uint32_t stalledByAccumulator;
+        uint32_t stalledByInput;
+        bool memoryBound;
+    };
+
+    /**
+     * beatBytes is the width of the AXI data bus, 8 bytes on Ethos-U55 and 16 bytes on Ethos-U65. peakBandwidth is
+     * the bandwidth the SoC can sustain towards the NPU, in bytes per NPU cycle.
+     */
+    ethosu_profiler_context(uint32_t beatBytes = 8, uint32_t peakBandwidth = 16);
+
+    void clear();
+
+    /**
+     * Number of Ethos-U custom operators in the network, for example from InferenceParser::parseModelInfo(). Zero
+     * leaves the reset to the application.
+     */
+    void setOperatorsPerInference(size_t count);
+
+    /**
+     * Number of inferences needed to measure every metric once.
+     */
+    static constexpr size_t getNumGroups();
+
+    size_t getNumOperators() const;
+    const Operator &getOperator(size_t index) const;
+    void getSummary(const Operator &op, Summary &summary) const;
+
+    /**
+     * Context used by the Ethos-U driver hooks.
+     */
+    static void setActive(ethosu_profiler_context *ctx);
+    static ethosu_profiler_context *getActive();
+
+    static const enum ethosu_pmu_event_type events[NUM_METRICS];
+
+    struct ethosu_driver *drv;
+    uint32_t beatBytes;
+    uint32_t peakBandwidth;
+    size_t firstMetric;
+    size_t numOperators;
+    size_t operatorsPerInference;
+    size_t current;
+    uint32_t inferences;
+    Operator operators[ETHOSU_PROFILER_MAX_OPERATORS];
+};
+
+constexpr size_t ethosu_profiler_context::getNumGroups() {
+    return (NUM_METRICS + ETHOSU_PMU_NCOUNTERS - 1) / ETHOSU_PMU_NCOUNTERS;
+}
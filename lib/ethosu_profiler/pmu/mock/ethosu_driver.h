@@ -0,0 +1,40 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2023 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Mock of the Ethos-U driver for host builds of the PMU profiler. The driver only holds the state of a mock PMU.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#define ETHOSU_PMU_NCOUNTERS 4
+
+struct ethosu_driver {
+    bool pmuEnabled;
+    uint32_t counterEnabled;
+    uint64_t ccnt;
+    uint32_t evtyper[ETHOSU_PMU_NCOUNTERS];
+    uint32_t evcntr[ETHOSU_PMU_NCOUNTERS];
+};
+
+extern "C" {
+void ethosu_inference_begin(struct ethosu_driver *drv, void *user_arg);
+void ethosu_inference_end(struct ethosu_driver *drv, void *user_arg);
+}
@@ -0,0 +1,132 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2023 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Drive the PMU profiler with a mock PMU. A network of Ethos-U operators with known cycle and event counts is run
+ * through the Ethos-U driver hooks for as many inferences as it takes to measure every metric. The derived statistics
+ * of every operator are checked against the programmed counts, and the report is printed.
+ */
+
+#include "ethosu_profiler.hpp"
+
+#include <stdio.h>
+
+namespace {
+
+struct Operator {
+    const char *name;
+    uint64_t cycles;
+    uint32_t events[ETHOSU_PMU_SENTINEL];
+};
+
+Operator createOperator(const char *name,
+                        uint64_t cycles,
+                        uint32_t axi0Read,
+                        uint32_t axi0Write,
+                        uint32_t axi1Read,
+                        uint32_t macActive,
+                        uint32_t idle,
+                        uint32_t stalledByWeights) {
+    Operator op = {name, cycles, {}};
+
+    op.events[ETHOSU_PMU_AXI0_RD_DATA_BEAT_RECEIVED] = axi0Read;
+    op.events[ETHOSU_PMU_AXI0_WR_DATA_BEAT_WRITTEN]  = axi0Write;
+    op.events[ETHOSU_PMU_AXI1_RD_DATA_BEAT_RECEIVED] = axi1Read;
+    op.events[ETHOSU_PMU_MAC_ACTIVE]                 = macActive;
+    op.events[ETHOSU_PMU_NPU_IDLE]                   = idle;
+    op.events[ETHOSU_PMU_MAC_STALLED_BY_WD]          = stalledByWeights;
+
+    return op;
+}
+
+bool check(const char *name, const char *field, uint64_t value, uint64_t expected) {
+    if (value != expected) {
+        printf("%s: %s=%llu, expected=%llu\n",
+               name,
+               field,
+               static_cast<unsigned long long>(value),
+               static_cast<unsigned long long>(expected));
+        return true;
+    }
+
+    return false;
+}
+
+bool verify(const ethosu_profiler_context &ctx, const Operator &op, size_t index, uint32_t beatBytes) {
+    ethosu_profiler_context::Summary summary;
+    ctx.getSummary(ctx.getOperator(index), summary);
+
+    const uint64_t beats = op.events[ETHOSU_PMU_AXI0_RD_DATA_BEAT_RECEIVED] +
+                           op.events[ETHOSU_PMU_AXI0_WR_DATA_BEAT_WRITTEN] +
+                           op.events[ETHOSU_PMU_AXI1_RD_DATA_BEAT_RECEIVED];
+    const uint64_t bytes = beats * beatBytes;
+
+    bool failed = false;
+    failed |= check(op.name, "cycles", summary.cycles, op.cycles);
+    failed |= check(op.name, "bytes", summary.bytes, bytes);
+    failed |= check(op.name, "bandwidth", summary.bandwidth, bytes * 100 / op.cycles);
+    failed |= check(op.name, "mac", summary.macUtilization, op.events[ETHOSU_PMU_MAC_ACTIVE] * 1000ULL / op.cycles);
+    failed |= check(op.name, "idle", summary.idle, op.events[ETHOSU_PMU_NPU_IDLE] * 1000ULL / op.cycles);
+    failed |= check(op.name,
+                    "stall wd",
+                    summary.stalledByWeights,
+                    op.events[ETHOSU_PMU_MAC_STALLED_BY_WD] * 1000ULL / op.cycles);
+
+    return failed;
+}
+} // namespace
+
+int main() {
+    constexpr uint32_t beatBytes     = 8;
+    constexpr uint32_t peakBandwidth = 16;
+
+    // Convolutions are compute bound, the depthwise and elementwise operators stream their tensors
+    const Operator ops[] = {
+        createOperator("conv2d", 200000, 40000, 10000, 30000, 180000, 2000, 5000),
+        createOperator("depthwise", 80000, 90000, 60000, 10000, 20000, 1000, 40000),
+        createOperator("conv2d", 400000, 60000, 20000, 100000, 360000, 0, 10000),
+        createOperator("add", 50000, 70000, 35000, 0, 5000, 500, 0),
+    };
+    constexpr size_t numOps = sizeof(ops) / sizeof(ops[0]);
+
+    ethosu_driver drv = {};
+    ethosu_profiler_context ctx(beatBytes, peakBandwidth);
+    ctx.setOperatorsPerInference(numOps);
+    ethosu_profiler_context::setActive(&ctx);
+
+    // The hooks start the next group of metrics when an inference has run all operators
+    for (size_t i = 0; i < ethosu_profiler_context::getNumGroups(); i++) {
+        for (auto &op : ops) {
+            ethosu_inference_begin(&drv, nullptr);
+            mock_pmu_run(&drv, op.cycles, op.events);
+            ethosu_inference_end(&drv, nullptr);
+        }
+    }
+
+    ethosu_profiler_context::setActive(nullptr);
+    ethosu_profiler_report(&ctx);
+
+    bool failed = ctx.getNumOperators() != numOps;
+    for (size_t i = 0; i < numOps && !failed; i++) {
+        failed |= verify(ctx, ops[i], i, beatBytes);
+    }
+
+    printf("%s\n", failed ? "FAILED" : "PASSED");
+
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,75 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2023 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "pmu_ethosu.h"
+
+#include <string.h>
+
+void ETHOSU_PMU_Enable(struct ethosu_driver *drv) {
+    drv->pmuEnabled = true;
+}
+
+void ETHOSU_PMU_Disable(struct ethosu_driver *drv) {
+    drv->pmuEnabled = false;
+}
+
+void ETHOSU_PMU_Set_EVTYPER(struct ethosu_driver *drv, uint32_t num, enum ethosu_pmu_event_type type) {
+    if (num < ETHOSU_PMU_NCOUNTERS) {
+        drv->evtyper[num] = type;
+    }
+}
+
+void ETHOSU_PMU_CYCCNT_Reset(struct ethosu_driver *drv) {
+    drv->ccnt = 0;
+}
+
+void ETHOSU_PMU_EVCNTR_ALL_Reset(struct ethosu_driver *drv) {
+    memset(drv->evcntr, 0, sizeof(drv->evcntr));
+}
+
+void ETHOSU_PMU_CNTR_Enable(struct ethosu_driver *drv, uint32_t mask) {
+    drv->counterEnabled |= mask;
+}
+
+void ETHOSU_PMU_CNTR_Disable(struct ethosu_driver *drv, uint32_t mask) {
+    drv->counterEnabled &= ~mask;
+}
+
+uint64_t ETHOSU_PMU_Get_CCNTR(struct ethosu_driver *drv) {
+    return drv->ccnt;
+}
+
+uint32_t ETHOSU_PMU_Get_EVCNTR(struct ethosu_driver *drv, uint32_t num) {
+    return num < ETHOSU_PMU_NCOUNTERS ? drv->evcntr[num] : 0;
+}
+
+void mock_pmu_run(struct ethosu_driver *drv, uint64_t cycles, const uint32_t events[ETHOSU_PMU_SENTINEL]) {
+    if (!drv->pmuEnabled) {
+        return;
+    }
+
+    if (drv->counterEnabled & ETHOSU_PMU_CCNT_Msk) {
+        drv->ccnt += cycles;
+    }
+
+    for (uint32_t i = 0; i < ETHOSU_PMU_NCOUNTERS; i++) {
+        if ((drv->counterEnabled & (1U << i)) && drv->evtyper[i] < ETHOSU_PMU_SENTINEL) {
+            drv->evcntr[i] += events[drv->evtyper[i]];
+        }
+    }
+}
@@ -0,0 +1,56 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2023 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Mock of the Ethos-U PMU API for host builds of the PMU profiler. mock_pmu_run() advances the enabled counters as if
+ * the NPU had run for a number of cycles and generated the given number of events of every type.
+ */
+
+#pragma once
+
+#include "ethosu_driver.h"
+
+#include <stdint.h>
+
+#define ETHOSU_PMU_CCNT_Msk (1UL << 31)
+
+enum ethosu_pmu_event_type {
+    ETHOSU_PMU_NO_EVENT = 0,
+    ETHOSU_PMU_CYCLE,
+    ETHOSU_PMU_NPU_IDLE,
+    ETHOSU_PMU_MAC_ACTIVE,
+    ETHOSU_PMU_MAC_STALLED_BY_WD,
+    ETHOSU_PMU_MAC_STALLED_BY_ACC,
+    ETHOSU_PMU_MAC_STALLED_BY_IB,
+    ETHOSU_PMU_AXI0_RD_DATA_BEAT_RECEIVED,
+    ETHOSU_PMU_AXI0_WR_DATA_BEAT_WRITTEN,
+    ETHOSU_PMU_AXI1_RD_DATA_BEAT_RECEIVED,
+    ETHOSU_PMU_SENTINEL
+};
+
+void ETHOSU_PMU_Enable(struct ethosu_driver *drv);
+void ETHOSU_PMU_Disable(struct ethosu_driver *drv);
+void ETHOSU_PMU_Set_EVTYPER(struct ethosu_driver *drv, uint32_t num, enum ethosu_pmu_event_type type);
+void ETHOSU_PMU_CYCCNT_Reset(struct ethosu_driver *drv);
+void ETHOSU_PMU_EVCNTR_ALL_Reset(struct ethosu_driver *drv);
+void ETHOSU_PMU_CNTR_Enable(struct ethosu_driver *drv, uint32_t mask);
+void ETHOSU_PMU_CNTR_Disable(struct ethosu_driver *drv, uint32_t mask);
+uint64_t ETHOSU_PMU_Get_CCNTR(struct ethosu_driver *drv);
+uint32_t ETHOSU_PMU_Get_EVCNTR(struct ethosu_driver *drv, uint32_t num);
+
+void mock_pmu_run(struct ethosu_driver *drv, uint64_t cycles, const uint32_t events[ETHOSU_PMU_SENTINEL]);
@@ -0,0 +1,56 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2023 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Ethos-U driver hooks measuring every Ethos-U custom operator with the active profiler context. The hooks are built
+ * by the ethosu_profiler_hooks target. Applications that implement these hooks for other purposes, for example weight
+ * staging, link ethosu_profiler_pmu only and call ethosu_profiler_start() and ethosu_profiler_end() from their own
+ * hooks.
+ */
+
+#include "ethosu_profiler.hpp"
+
+#include <ethosu_driver.h>
+
+extern "C" {
+
+void ethosu_inference_begin(struct ethosu_driver *drv, void *user_arg) {
+    (void)user_arg;
+
+    ethosu_profiler_context *ctx = ethosu_profiler_context::getActive();
+    if (ctx != nullptr) {
+        // The previous inference has run all its operators
+        if (ctx->operatorsPerInference > 0 && ctx->current >= ctx->operatorsPerInference) {
+            ethosu_profiler_reset(ctx);
+        }
+
+        ctx->drv = drv;
+        ethosu_profiler_start(ctx);
+    }
+}
+
+void ethosu_inference_end(struct ethosu_driver *drv, void *user_arg) {
+    (void)drv;
+    (void)user_arg;
+
+    ethosu_profiler_context *ctx = ethosu_profiler_context::getActive();
+    if (ctx != nullptr) {
+        ethosu_profiler_end(ctx);
+    }
+}
+}
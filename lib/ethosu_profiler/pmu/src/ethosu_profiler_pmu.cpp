@@ -0,0 +1,300 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2023 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ethosu_profiler.hpp"
+
+#include "ethosu_log.h"
+
+#include <inttypes.h>
+#include <string.h>
+
+namespace {
+constexpr size_t NumCounters = ETHOSU_PMU_NCOUNTERS < ethosu_profiler_context::NUM_METRICS
+                                   ? ETHOSU_PMU_NCOUNTERS
+                                   : ethosu_profiler_context::NUM_METRICS;
+
+ethosu_profiler_context *active = nullptr;
+
+// Number of counters measuring the current group, the last group may be smaller
+size_t getGroupSize(const ethosu_profiler_context *ctx) {
+    const size_t left = ethosu_profiler_context::NUM_METRICS - ctx->firstMetric;
+    return left < NumCounters ? left : NumCounters;
+}
+
+uint32_t getCounterMask(const ethosu_profiler_context *ctx) {
+    return ETHOSU_PMU_CCNT_Msk | ((1U << getGroupSize(ctx)) - 1);
+}
+
+uint64_t average(const ethosu_profiler_context::Operator &op, ethosu_profiler_context::Metric metric) {
+    return op.countRuns[metric] > 0 ? op.counts[metric] / op.countRuns[metric] : 0;
+}
+
+uint32_t perMille(uint64_t value, uint64_t total) {
+    return total > 0 ? static_cast<uint32_t>(value * 1000 / total) : 0;
+}
+} // namespace
+
+/****************************************************************************
+ * ethosu_profiler_context
+ ****************************************************************************/
+
+const enum ethosu_pmu_event_type ethosu_profiler_context::events[NUM_METRICS] = {
+    ETHOSU_PMU_AXI0_RD_DATA_BEAT_RECEIVED,
+    ETHOSU_PMU_AXI0_WR_DATA_BEAT_WRITTEN,
+    ETHOSU_PMU_AXI1_RD_DATA_BEAT_RECEIVED,
+    ETHOSU_PMU_MAC_ACTIVE,
+    ETHOSU_PMU_NPU_IDLE,
+    ETHOSU_PMU_MAC_STALLED_BY_WD,
+    ETHOSU_PMU_MAC_STALLED_BY_ACC,
+    ETHOSU_PMU_MAC_STALLED_BY_IB,
+};
+
+ethosu_profiler_context::ethosu_profiler_context(uint32_t _beatBytes, uint32_t _peakBandwidth) :
+    drv(nullptr), beatBytes(_beatBytes), peakBandwidth(_peakBandwidth), operatorsPerInference(0) {
+    clear();
+}
+
+void ethosu_profiler_context::clear() {
+    firstMetric  = 0;
+    numOperators = 0;
+    current      = 0;
+    inferences   = 0;
+    memset(operators, 0, sizeof(operators));
+}
+
+void ethosu_profiler_context::setOperatorsPerInference(size_t count) {
+    operatorsPerInference = count;
+}
+
+size_t ethosu_profiler_context::getNumOperators() const {
+    return numOperators;
+}
+
+const ethosu_profiler_context::Operator &ethosu_profiler_context::getOperator(size_t index) const {
+    return operators[index];
+}
+
+void ethosu_profiler_context::getSummary(const Operator &op, Summary &summary) const {
+    summary        = Summary();
+    summary.cycles = op.runs > 0 ? op.cycles / op.runs : 0;
+    summary.bytes  = (average(op, AXI0_READ) + average(op, AXI0_WRITE) + average(op, AXI1_READ)) * beatBytes;
+
+    if (summary.cycles == 0) {
+        return;
+    }
+
+    summary.bandwidth            = static_cast<uint32_t>(summary.bytes * 100 / summary.cycles);
+    summary.bandwidthUtilization = perMille(summary.bytes, summary.cycles * peakBandwidth);
+    summary.macUtilization       = perMille(average(op, MAC_ACTIVE), summary.cycles);
+    summary.idle                 = perMille(average(op, NPU_IDLE), summary.cycles);
+    summary.stalledByWeights     = perMille(average(op, MAC_STALLED_BY_WD), summary.cycles);
+    summary.stalledByAccumulator = perMille(average(op, MAC_STALLED_BY_ACC), summary.cycles);
+    summary.stalledByInput       = perMille(average(op, MAC_STALLED_BY_IB), summary.cycles);
+    summary.memoryBound          = summary.bandwidthUtilization > summary.macUtilization;
+}
+
+void ethosu_profiler_context::setActive(ethosu_profiler_context *ctx) {
+    active = ctx;
+}
+
+ethosu_profiler_context *ethosu_profiler_context::getActive() {
+    return active;
+}
+
+/****************************************************************************
+ * Profiler hooks
+ ****************************************************************************/
+
+void ethosu_profiler_start(struct ethosu_profiler_context *ctx) {
+    if (ctx == nullptr || ctx->drv == nullptr || ctx->current >= ETHOSU_PROFILER_MAX_OPERATORS) {
+        return;
+    }
+
+    ETHOSU_PMU_Enable(ctx->drv);
+
+    for (size_t i = 0; i < getGroupSize(ctx); i++) {
+        ETHOSU_PMU_Set_EVTYPER(ctx->drv, i, ethosu_profiler_context::events[ctx->firstMetric + i]);
+    }
+
+    ETHOSU_PMU_CYCCNT_Reset(ctx->drv);
+    ETHOSU_PMU_EVCNTR_ALL_Reset(ctx->drv);
+    ETHOSU_PMU_CNTR_Enable(ctx->drv, getCounterMask(ctx));
+}
+
+void ethosu_profiler_end(struct ethosu_profiler_context *ctx) {
+    if (ctx == nullptr || ctx->drv == nullptr || ctx->current >= ETHOSU_PROFILER_MAX_OPERATORS) {
+        return;
+    }
+
+    ETHOSU_PMU_CNTR_Disable(ctx->drv, getCounterMask(ctx));
+
+    ethosu_profiler_add_to_pmu_cycles(ctx, ETHOSU_PMU_Get_CCNTR(ctx->drv));
+
+    for (size_t i = 0; i < getGroupSize(ctx); i++) {
+        ethosu_profiler_add_to_pmu_event(ctx, ctx->firstMetric + i, ETHOSU_PMU_Get_EVCNTR(ctx->drv, i));
+    }
+
+    ctx->current++;
+    if (ctx->current > ctx->numOperators) {
+        ctx->numOperators = ctx->current;
+    }
+}
+
+void ethosu_profiler_reset(struct ethosu_profiler_context *ctx) {
+    if (ctx == nullptr) {
+        return;
+    }
+
+    // Measure the next group of metrics if the previous inference ran any operator
+    if (ctx->current > 0) {
+        ctx->inferences++;
+        ctx->firstMetric += NumCounters;
+        if (ctx->firstMetric >= ethosu_profiler_context::NUM_METRICS) {
+            ctx->firstMetric = 0;
+        }
+    }
+
+    ctx->current = 0;
+}
+
+uint64_t ethosu_profiler_get_pmu_cycles(struct ethosu_profiler_context *ctx) {
+    uint64_t cycles = 0;
+
+    if (ctx == nullptr) {
+        return cycles;
+    }
+
+    for (size_t i = 0; i < ctx->numOperators; i++) {
+        const ethosu_profiler_context::Operator &op = ctx->operators[i];
+
+        if (op.runs > 0) {
+            cycles += op.cycles / op.runs;
+        }
+    }
+
+    return cycles;
+}
+
+void ethosu_profiler_add_to_pmu_cycles(struct ethosu_profiler_context *ctx, uint64_t cycles) {
+    if (ctx == nullptr || ctx->current >= ETHOSU_PROFILER_MAX_OPERATORS) {
+        return;
+    }
+
+    ethosu_profiler_context::Operator &op = ctx->operators[ctx->current];
+    op.cycles += cycles;
+    op.runs++;
+}
+
+void ethosu_profiler_add_to_pmu_event(struct ethosu_profiler_context *ctx, uint32_t index, uint32_t value) {
+    if (ctx == nullptr || ctx->current >= ETHOSU_PROFILER_MAX_OPERATORS ||
+        index >= ethosu_profiler_context::NUM_METRICS) {
+        return;
+    }
+
+    ethosu_profiler_context::Operator &op = ctx->operators[ctx->current];
+    op.counts[index] += value;
+    op.countRuns[index]++;
+}
+
+void ethosu_profiler_report(struct ethosu_profiler_context *ctx) {
+    if (ctx == nullptr) {
+        return;
+    }
+
+    // Count the inference in progress
+    const uint32_t inferences = ctx->inferences + (ctx->current > 0 ? 1 : 0);
+    if (inferences < ethosu_profiler_context::getNumGroups()) {
+        LOG_WARN("Ethos-U PMU report incomplete: inferences=%" PRIu32 ", required=%zu",
+                 inferences,
+                 ethosu_profiler_context::getNumGroups());
+    }
+
+    uint64_t totalCycles   = 0;
+    uint64_t totalBytes    = 0;
+    uint64_t macCycles     = 0;
+    uint64_t memoryCycles  = 0;
+    uint64_t computeCycles = 0;
+
+    LOG("Ethos-U PMU report: operators=%zu, inferences=%" PRIu32 ", beat=%" PRIu32 " bytes, peak=%" PRIu32
+        " bytes/cycle\n",
+        ctx->numOperators,
+        inferences,
+        ctx->beatBytes,
+        ctx->peakBandwidth);
+
+    for (size_t i = 0; i < ctx->numOperators; i++) {
+        ethosu_profiler_context::Summary summary;
+        ctx->getSummary(ctx->operators[i], summary);
+
+        LOG("Operator %zu: cycles=%" PRIu64 ", bytes=%" PRIu64 ", bandwidth=%" PRIu32 ".%02" PRIu32
+            " bytes/cycle (%" PRIu32 ".%" PRIu32 "%%), mac=%" PRIu32 ".%" PRIu32 "%%, idle=%" PRIu32 ".%" PRIu32
+            "%%, stall wd=%" PRIu32 ".%" PRIu32 "%% acc=%" PRIu32 ".%" PRIu32 "%% ib=%" PRIu32 ".%" PRIu32
+            "%%, %s bound\n",
+            i,
+            summary.cycles,
+            summary.bytes,
+            summary.bandwidth / 100,
+            summary.bandwidth % 100,
+            summary.bandwidthUtilization / 10,
+            summary.bandwidthUtilization % 10,
+            summary.macUtilization / 10,
+            summary.macUtilization % 10,
+            summary.idle / 10,
+            summary.idle % 10,
+            summary.stalledByWeights / 10,
+            summary.stalledByWeights % 10,
+            summary.stalledByAccumulator / 10,
+            summary.stalledByAccumulator % 10,
+            summary.stalledByInput / 10,
+            summary.stalledByInput % 10,
+            summary.memoryBound ? "memory" : "compute");
+
+        totalCycles += summary.cycles;
+        totalBytes += summary.bytes;
+        macCycles += static_cast<uint64_t>(summary.macUtilization) * summary.cycles / 1000;
+
+        if (summary.memoryBound) {
+            memoryCycles += summary.cycles;
+        } else {
+            computeCycles += summary.cycles;
+        }
+    }
+
+    const uint32_t bandwidth = totalCycles > 0 ? static_cast<uint32_t>(totalBytes * 100 / totalCycles) : 0;
+    const uint32_t bwUtil    = perMille(totalBytes, totalCycles * ctx->peakBandwidth);
+    const uint32_t macUtil   = perMille(macCycles, totalCycles);
+    const uint32_t memory    = perMille(memoryCycles, totalCycles);
+    const uint32_t compute   = perMille(computeCycles, totalCycles);
+
+    LOG("Roofline: cycles=%" PRIu64 ", bytes=%" PRIu64 ", bandwidth=%" PRIu32 ".%02" PRIu32 " bytes/cycle (%" PRIu32
+        ".%" PRIu32 "%% of peak), mac=%" PRIu32 ".%" PRIu32 "%%, memory bound=%" PRIu32 ".%" PRIu32
+        "%% of cycles, compute bound=%" PRIu32 ".%" PRIu32 "%% of cycles, network is %s bound\n",
+        totalCycles,
+        totalBytes,
+        bandwidth / 100,
+        bandwidth % 100,
+        bwUtil / 10,
+        bwUtil % 10,
+        macUtil / 10,
+        macUtil % 10,
+        memory / 10,
+        memory % 10,
+        compute / 10,
+        compute % 10,
+        memoryCycles > computeCycles ? "memory" : "compute");
+}
@@ -0,0 +1,142 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2023 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ETHOSU_RUNTIME_STATS_H
+#define ETHOSU_RUNTIME_STATS_H
+
+#include "job_stats.hpp"
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifndef ETHOSU_RUNTIME_STATS_MAX_TASKS
+#define ETHOSU_RUNTIME_STATS_MAX_TASKS 8
+#endif
+
+#ifndef ETHOSU_RUNTIME_STATS_MAX_SAMPLED_TASKS
+#define ETHOSU_RUNTIME_STATS_MAX_SAMPLED_TASKS 32
+#endif
+
+/**
+ * Runtime statistics for FreeRTOS based inference applications.
+ *
+ * Samples the per task run time with uxTaskGetSystemState() together with the inference job statistics, and exports
+ * them as one snapshot. CPU load is calculated over the interval since the previous snapshot, in per mille of the
+ * run time counter. Task run time requires configGENERATE_RUN_TIME_STATS, which is enabled with the
+ * FREERTOS_RUN_TIME_STATS build option. Without it the task load is reported as 0.
+ *
+ * Up to ETHOSU_RUNTIME_STATS_MAX_SAMPLED_TASKS tasks are sampled, and the snapshot holds the
+ * ETHOSU_RUNTIME_STATS_MAX_TASKS tasks with the highest load over the interval. Set the object as the JobStats of an
+ * InferenceTask to record its jobs.
+ */
+class EthosURuntimeStats : public InferenceProcess::JobStats {
+public:
+    static constexpr uint32_t SnapshotMagic   = 0x54535452; // "RTST"
+    static constexpr uint32_t SnapshotVersion = 2;
+    static constexpr size_t MaxTaskName       = 12;
+
+    struct TaskStats {
+        char name[MaxTaskName];
+        uint32_t runTime;
+        uint16_t load;
+        uint16_t stackFree;
+        uint8_t priority;
+        uint8_t state;
+    };
+
+    struct InferenceStats {
+        uint32_t jobs;
+        uint32_t failedJobs;
+        uint64_t cpuCycles;
+        uint64_t lastCpuCycles;
+        uint32_t queueDepth;
+        uint32_t maxQueueDepth;
+        uint32_t arenaSize;
+        uint32_t arenaUsed;
+    };
+
+    struct Snapshot {
+        uint32_t interval;
+        // Tasks in the snapshot, and tasks in the system
+        uint32_t numTasks;
+        uint16_t totalTasks;
+        uint16_t idleLoad;
+        InferenceStats inference;
+        TaskStats tasks[ETHOSU_RUNTIME_STATS_MAX_TASKS];
+    };
+
+    EthosURuntimeStats();
+
+    /**
+     * Record a completed inference job. Called from the task running the job.
+     */
+    void recordJob(const InferenceProcess::InferenceJob &job,
+                   bool failed,
+                   const InferenceProcess::InferenceProcess &process) override;
+
+    /**
+     * Record the number of jobs waiting to be processed.
+     */
+    void recordQueueDepth(size_t depth) override;
+
+    /**
+     * Sample the tasks and the inference statistics. If there are more than ETHOSU_RUNTIME_STATS_MAX_SAMPLED_TASKS
+     * tasks, the snapshot holds no task statistics and true is returned. totalTasks holds the number of tasks either
+     * way.
+     */
+    bool sample(Snapshot &snapshot);
+
+    /**
+     * Print a snapshot to the log.
+     */
+    static void log(const Snapshot &snapshot);
+
+    /**
+     * Serialize a snapshot into a compact little endian message, for example to be sent with rpmsg_send(). Returns the
+     * message size, or 0 if the buffer is too small.
+     */
+    static size_t serialize(const Snapshot &snapshot, uint8_t *buf, size_t size);
+
+    static size_t getSerializedSize(const Snapshot &snapshot);
+
+    // Serialized size of the header, the inference statistics and a task
+    static constexpr size_t HeaderSize    = 20;
+    static constexpr size_t InferenceSize = 40;
+    static constexpr size_t TaskSize      = 24;
+
+    static constexpr size_t MaxSerializedSize = HeaderSize + InferenceSize + ETHOSU_RUNTIME_STATS_MAX_TASKS * TaskSize;
+
+private:
+    struct TaskRunTime {
+        TaskHandle_t handle;
+        uint32_t runTime;
+    };
+
+    uint32_t getPreviousRunTime(TaskHandle_t handle) const;
+
+    InferenceStats inference;
+    TaskStatus_t status[ETHOSU_RUNTIME_STATS_MAX_SAMPLED_TASKS];
+    TaskRunTime previous[ETHOSU_RUNTIME_STATS_MAX_SAMPLED_TASKS];
+    size_t numPrevious;
+    uint32_t previousTotal;
+};
+
+#endif
@@ -0,0 +1,32 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2023 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ETHOSU_RUNTIME_STATS_RPMSG_H
+#define ETHOSU_RUNTIME_STATS_RPMSG_H
+
+#include "ethosu_runtime_stats.hpp"
+
+#include <openamp/rpmsg.h>
+
+/**
+ * Send a snapshot as one rpmsg message on the endpoint, serialized with EthosURuntimeStats::serialize(). The receiver
+ * identifies the message by SnapshotMagic. Returns true on failure.
+ */
+bool ethosu_runtime_stats_send(struct rpmsg_endpoint *ept, const EthosURuntimeStats::Snapshot &snapshot);
+
+#endif
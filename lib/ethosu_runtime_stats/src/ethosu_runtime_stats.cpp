@@ -0,0 +1,219 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2023 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ethosu_runtime_stats.hpp"
+#include "ethosu_log.h"
+#include "inference_process.hpp"
+#include "stats_message.hpp"
+
+#include <algorithm>
+#include <inttypes.h>
+#include <string.h>
+
+#ifndef configIDLE_TASK_NAME
+#define configIDLE_TASK_NAME "IDLE"
+#endif
+
+namespace {
+uint16_t perMille(uint32_t value, uint32_t total) {
+    if (total == 0) {
+        return 0;
+    }
+
+    return static_cast<uint16_t>((static_cast<uint64_t>(value) * 1000) / total);
+}
+} // namespace
+
+EthosURuntimeStats::EthosURuntimeStats() : inference(), numPrevious(0), previousTotal(0) {}
+
+void EthosURuntimeStats::recordJob(const InferenceProcess::InferenceJob &job,
+                                   bool failed,
+                                   const InferenceProcess::InferenceProcess &process) {
+    taskENTER_CRITICAL();
+
+    inference.jobs++;
+    inference.failedJobs += failed ? 1 : 0;
+    inference.cpuCycles += job.cpuCycles;
+    inference.lastCpuCycles = job.cpuCycles;
+    inference.arenaSize     = process.getArenaSize();
+    inference.arenaUsed     = process.getArenaUsedBytes();
+
+    taskEXIT_CRITICAL();
+}
+
+void EthosURuntimeStats::recordQueueDepth(size_t depth) {
+    taskENTER_CRITICAL();
+
+    inference.queueDepth    = depth;
+    inference.maxQueueDepth = std::max<uint32_t>(inference.maxQueueDepth, depth);
+
+    taskEXIT_CRITICAL();
+}
+
+uint32_t EthosURuntimeStats::getPreviousRunTime(TaskHandle_t handle) const {
+    for (size_t i = 0; i < numPrevious; i++) {
+        if (previous[i].handle == handle) {
+            return previous[i].runTime;
+        }
+    }
+
+    return 0;
+}
+
+bool EthosURuntimeStats::sample(Snapshot &snapshot) {
+    taskENTER_CRITICAL();
+    snapshot.inference = inference;
+    taskEXIT_CRITICAL();
+
+    uint32_t total    = 0;
+    UBaseType_t count = uxTaskGetSystemState(status, ETHOSU_RUNTIME_STATS_MAX_SAMPLED_TASKS, &total);
+
+    snapshot.interval   = total - previousTotal;
+    snapshot.numTasks   = 0;
+    snapshot.totalTasks = count;
+    snapshot.idleLoad   = 0;
+
+    if (count == 0) {
+        snapshot.totalTasks = uxTaskGetNumberOfTasks();
+
+        LOG_WARN("Too many tasks for runtime stats: tasks=%u, max=%d",
+                 snapshot.totalTasks,
+                 ETHOSU_RUNTIME_STATS_MAX_SAMPLED_TASKS);
+        return true;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        const TaskStatus_t &task = status[i];
+        TaskStats stats;
+
+        strncpy(stats.name, task.pcTaskName, MaxTaskName - 1);
+        stats.name[MaxTaskName - 1] = '\0';
+
+        stats.runTime   = task.ulRunTimeCounter - getPreviousRunTime(task.xHandle);
+        stats.load      = perMille(stats.runTime, snapshot.interval);
+        stats.stackFree = task.usStackHighWaterMark;
+        stats.priority  = task.uxCurrentPriority;
+        stats.state     = task.eCurrentState;
+
+        if (strncmp(task.pcTaskName, configIDLE_TASK_NAME, MaxTaskName) == 0) {
+            snapshot.idleLoad = stats.load;
+        }
+
+        // Keep the tasks sorted by run time, dropping the task with the lowest run time when full
+        size_t j = snapshot.numTasks;
+        if (j == ETHOSU_RUNTIME_STATS_MAX_TASKS) {
+            if (snapshot.tasks[j - 1].runTime >= stats.runTime) {
+                continue;
+            }
+
+            j--;
+        } else {
+            snapshot.numTasks++;
+        }
+
+        for (; j > 0 && snapshot.tasks[j - 1].runTime < stats.runTime; j--) {
+            snapshot.tasks[j] = snapshot.tasks[j - 1];
+        }
+
+        snapshot.tasks[j] = stats;
+    }
+
+    // Remember the run time counters for the next interval
+    for (size_t i = 0; i < count; i++) {
+        previous[i].handle  = status[i].xHandle;
+        previous[i].runTime = status[i].ulRunTimeCounter;
+    }
+
+    numPrevious   = count;
+    previousTotal = total;
+
+    return false;
+}
+
+void EthosURuntimeStats::log(const Snapshot &snapshot) {
+    const InferenceStats &inference = snapshot.inference;
+
+    LOG("Runtime stats: interval=%" PRIu32 ", idle=%u.%u%%, tasks=%" PRIu32 "/%u\n",
+        snapshot.interval,
+        snapshot.idleLoad / 10,
+        snapshot.idleLoad % 10,
+        snapshot.numTasks,
+        snapshot.totalTasks);
+    LOG("Inference: jobs=%" PRIu32 ", failed=%" PRIu32 ", cycles=%" PRIu64 ", last=%" PRIu64 ", queue=%" PRIu32
+        ", max_queue=%" PRIu32 ", arena=%" PRIu32 "/%" PRIu32 "\n",
+        inference.jobs,
+        inference.failedJobs,
+        inference.cpuCycles,
+        inference.lastCpuCycles,
+        inference.queueDepth,
+        inference.maxQueueDepth,
+        inference.arenaUsed,
+        inference.arenaSize);
+
+    for (size_t i = 0; i < snapshot.numTasks; i++) {
+        const TaskStats &task = snapshot.tasks[i];
+
+        LOG("Task: %-*.*s load=%u.%u%%, run_time=%" PRIu32 ", stack_free=%u, priority=%u, state=%u\n",
+            static_cast<int>(MaxTaskName),
+            static_cast<int>(MaxTaskName),
+            task.name,
+            task.load / 10,
+            task.load % 10,
+            task.runTime,
+            task.stackFree,
+            task.priority,
+            task.state);
+    }
+}
+
+size_t EthosURuntimeStats::getSerializedSize(const Snapshot &snapshot) {
+    return HeaderSize + InferenceSize + snapshot.numTasks * TaskSize;
+}
+
+size_t EthosURuntimeStats::serialize(const Snapshot &snapshot, uint8_t *buf, size_t size) {
+    const InferenceStats &inference = snapshot.inference;
+    InferenceProcess::StatsMessage msg(buf, size, getSerializedSize(snapshot), SnapshotMagic, SnapshotVersion);
+
+    msg.put(snapshot.interval, 4);
+    msg.put(snapshot.numTasks, 4);
+    msg.put(snapshot.idleLoad, 2);
+    msg.put(snapshot.totalTasks, 2);
+
+    msg.put(inference.jobs, 4);
+    msg.put(inference.failedJobs, 4);
+    msg.put(inference.cpuCycles, 8);
+    msg.put(inference.lastCpuCycles, 8);
+    msg.put(inference.queueDepth, 4);
+    msg.put(inference.maxQueueDepth, 4);
+    msg.put(inference.arenaSize, 4);
+    msg.put(inference.arenaUsed, 4);
+
+    for (size_t i = 0; i < snapshot.numTasks; i++) {
+        const TaskStats &task = snapshot.tasks[i];
+
+        msg.putBytes(task.name, MaxTaskName);
+        msg.put(task.runTime, 4);
+        msg.put(task.load, 2);
+        msg.put(task.stackFree, 2);
+        msg.put(task.priority, 1);
+        msg.put(task.state, 1);
+        msg.put(0, 2);
+    }
+
+    return msg.size();
+}
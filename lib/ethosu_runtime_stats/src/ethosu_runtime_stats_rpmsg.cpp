@@ -0,0 +1,38 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2023 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ethosu_runtime_stats_rpmsg.hpp"
+#include "ethosu_log.h"
+
+bool ethosu_runtime_stats_send(struct rpmsg_endpoint *ept, const EthosURuntimeStats::Snapshot &snapshot) {
+    uint8_t buf[EthosURuntimeStats::MaxSerializedSize];
+
+    const size_t size = EthosURuntimeStats::serialize(snapshot, buf, sizeof(buf));
+    if (size == 0) {
+        LOG_ERR("Failed to serialize runtime stats");
+        return true;
+    }
+
+    const int ret = rpmsg_send(ept, buf, static_cast<int>(size));
+    if (ret < 0) {
+        LOG_ERR("Failed to send runtime stats: ret=%d", ret);
+        return true;
+    }
+
+    return false;
+}
@@ -0,0 +1,164 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2023 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Record jobs through the JobStats interface of InferenceTask, and sample a fake FreeRTOS system with more tasks than
+ * a snapshot holds.
+ */
+
+#include "ethosu_runtime_stats.hpp"
+#include "inference_process.hpp"
+
+#include <stdio.h>
+#include <string.h>
+
+TaskStatus_t fakeTasks[ETHOSU_RUNTIME_STATS_MAX_SAMPLED_TASKS + 1];
+UBaseType_t fakeNumTasks;
+uint32_t fakeTotalRunTime;
+
+namespace {
+
+constexpr size_t NumTasks = ETHOSU_RUNTIME_STATS_MAX_TASKS + 4;
+
+char names[ETHOSU_RUNTIME_STATS_MAX_SAMPLED_TASKS + 1][EthosURuntimeStats::MaxTaskName];
+
+bool check(bool condition, const char *message) {
+    if (!condition) {
+        fprintf(stderr, "FAIL: %s\n", message);
+    }
+
+    return !condition;
+}
+
+// Tasks with run time i * step, the idle task has the lowest run time
+void setTasks(size_t count, uint32_t step) {
+    fakeNumTasks     = count;
+    fakeTotalRunTime = 0;
+
+    for (size_t i = 0; i < count; i++) {
+        TaskStatus_t &task = fakeTasks[i];
+
+        snprintf(names[i], sizeof(names[i]), i == 0 ? "IDLE" : "task%zu", i);
+
+        task.xHandle           = reinterpret_cast<TaskHandle_t>(i + 1);
+        task.pcTaskName        = names[i];
+        task.eCurrentState     = eReady;
+        task.uxCurrentPriority = i;
+        task.ulRunTimeCounter += (i + 1) * step;
+
+        fakeTotalRunTime += task.ulRunTimeCounter;
+    }
+}
+
+bool testJobStats() {
+    EthosURuntimeStats runtimeStats;
+    InferenceProcess::JobStats &stats = runtimeStats;
+    InferenceProcess::InferenceProcess process;
+    InferenceProcess::InferenceJob job;
+    EthosURuntimeStats::Snapshot snapshot;
+    bool failed = false;
+
+    process.arenaSize      = 1000;
+    process.arenaUsedBytes = 600;
+
+    stats.recordQueueDepth(3);
+    job.cpuCycles = 100;
+    stats.recordJob(job, false, process);
+
+    stats.recordQueueDepth(1);
+    job.cpuCycles = 50;
+    stats.recordJob(job, true, process);
+
+    setTasks(2, 10);
+    failed |= check(!runtimeStats.sample(snapshot), "sample");
+
+    failed |= check(snapshot.inference.jobs == 2, "jobs");
+    failed |= check(snapshot.inference.failedJobs == 1, "failed jobs");
+    failed |= check(snapshot.inference.cpuCycles == 150, "cycles");
+    failed |= check(snapshot.inference.lastCpuCycles == 50, "last cycles");
+    failed |= check(snapshot.inference.queueDepth == 1, "queue depth");
+    failed |= check(snapshot.inference.maxQueueDepth == 3, "max queue depth");
+    failed |= check(snapshot.inference.arenaSize == 1000 && snapshot.inference.arenaUsed == 600, "arena");
+
+    return failed;
+}
+
+bool testTruncate() {
+    EthosURuntimeStats stats;
+    EthosURuntimeStats::Snapshot snapshot;
+    bool failed = false;
+
+    memset(fakeTasks, 0, sizeof(fakeTasks));
+
+    // The second interval has run time (i + 1) * 20 per task
+    setTasks(NumTasks, 10);
+    failed |= check(!stats.sample(snapshot), "first sample");
+
+    setTasks(NumTasks, 20);
+    failed |= check(!stats.sample(snapshot), "second sample");
+
+    failed |= check(snapshot.numTasks == ETHOSU_RUNTIME_STATS_MAX_TASKS, "tasks in snapshot");
+    failed |= check(snapshot.totalTasks == NumTasks, "tasks in system");
+    failed |= check(snapshot.interval == NumTasks * (NumTasks + 1) / 2 * 20, "interval");
+    failed |= check(snapshot.idleLoad > 0, "idle load of a task not in the snapshot");
+
+    // The busiest tasks, in order of run time
+    for (size_t i = 0; i < snapshot.numTasks; i++) {
+        const EthosURuntimeStats::TaskStats &task = snapshot.tasks[i];
+
+        failed |= check(task.runTime == (NumTasks - i) * 20, "task run time");
+        failed |= check(strcmp(task.name, names[NumTasks - 1 - i]) == 0, "task name");
+    }
+
+    uint8_t buf[EthosURuntimeStats::MaxSerializedSize];
+    const size_t size = EthosURuntimeStats::serialize(snapshot, buf, sizeof(buf));
+
+    failed |= check(size == EthosURuntimeStats::MaxSerializedSize, "serialized size");
+    failed |= check(buf[4] == EthosURuntimeStats::SnapshotVersion, "serialized version");
+    failed |= check(buf[18] == NumTasks && buf[19] == 0, "serialized tasks in system");
+
+    return failed;
+}
+
+bool testTooManyTasks() {
+    EthosURuntimeStats stats;
+    EthosURuntimeStats::Snapshot snapshot;
+    bool failed = false;
+
+    setTasks(ETHOSU_RUNTIME_STATS_MAX_SAMPLED_TASKS + 1, 10);
+
+    failed |= check(stats.sample(snapshot), "sample fails");
+    failed |= check(snapshot.numTasks == 0, "no tasks in snapshot");
+    failed |= check(snapshot.totalTasks == ETHOSU_RUNTIME_STATS_MAX_SAMPLED_TASKS + 1, "tasks in system");
+
+    return failed;
+}
+
+} // namespace
+
+int main() {
+    bool failed = false;
+
+    failed |= testJobStats();
+    failed |= testTruncate();
+    failed |= testTooManyTasks();
+
+    printf("%s\n", failed ? "FAILED" : "PASSED");
+
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,48 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2023 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Host fake of InferenceProcess, with the parts used by EthosURuntimeStats.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace InferenceProcess {
+
+struct InferenceJob {
+    uint64_t cpuCycles{0};
+};
+
+class InferenceProcess {
+public:
+    size_t getArenaSize() const {
+        return arenaSize;
+    }
+
+    size_t getArenaUsedBytes() const {
+        return arenaUsedBytes;
+    }
+
+    size_t arenaSize{0};
+    size_t arenaUsedBytes{0};
+};
+
+} // namespace InferenceProcess
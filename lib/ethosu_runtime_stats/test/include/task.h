@@ -0,0 +1,63 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2023 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Host fake of the FreeRTOS task API. The system state is the task table of the test.
+ */
+
+#pragma once
+
+#include "FreeRTOS.h"
+
+#include <stddef.h>
+#include <string.h>
+
+typedef struct tskTaskControlBlock *TaskHandle_t;
+
+typedef enum { eRunning = 0, eReady, eBlocked, eSuspended, eDeleted, eInvalid } eTaskState;
+
+typedef struct {
+    TaskHandle_t xHandle;
+    const char *pcTaskName;
+    UBaseType_t xTaskNumber;
+    eTaskState eCurrentState;
+    UBaseType_t uxCurrentPriority;
+    UBaseType_t uxBasePriority;
+    uint32_t ulRunTimeCounter;
+    configSTACK_DEPTH_TYPE usStackHighWaterMark;
+} TaskStatus_t;
+
+// Tasks of the fake system, and its total run time
+extern TaskStatus_t fakeTasks[];
+extern UBaseType_t fakeNumTasks;
+extern uint32_t fakeTotalRunTime;
+
+static inline UBaseType_t uxTaskGetNumberOfTasks(void) {
+    return fakeNumTasks;
+}
+
+static inline UBaseType_t uxTaskGetSystemState(TaskStatus_t *status, UBaseType_t size, uint32_t *totalRunTime) {
+    if (fakeNumTasks > size) {
+        return 0;
+    }
+
+    memcpy(status, fakeTasks, fakeNumTasks * sizeof(TaskStatus_t));
+    *totalRunTime = fakeTotalRunTime;
+
+    return fakeNumTasks;
+}
@@ -1,5 +1,5 @@
 /*
- * SPDX-FileCopyrightText: Copyright 2021-2022 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ * SPDX-FileCopyrightText: Copyright 2021-2023 Arm Limited and/or its affiliates <open-source-office@arm.com>
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -22,7 +22,9 @@
 #include "EventRecorder.h"
 #include "tensorflow/lite/micro/compatibility.h"
 #include "tensorflow/lite/micro/micro_profiler_interface.h"
+#include <atomic>
 #include <memory>
+#include <stdint.h>
 #include <vector>
 
 // NOTE: This profiler only works on systems with 1 NPU due to the use of
@@ -32,28 +34,89 @@ class LayerByLayerProfiler : public MicroProfilerInterface {
 public:
     enum Backend { PRINTF, EVENT_RECORDER };
 
+    // IMMEDIATE emits every event from EndEvent(). DEFERRED only takes timestamps while the interpreter runs, and the
+    // events are emitted by Flush(), so that the output does not disturb the measurements.
+    enum Output { IMMEDIATE, DEFERRED };
+
     LayerByLayerProfiler(size_t max_events = 200,
                          Backend backend   = PRINTF,
-                         int32_t event_id  = EventID(EventLevelError, EvtStatistics_No, EventRecordNone));
+                         int32_t event_id  = EventID(EventLevelError, EvtStatistics_No, EventRecordNone),
+                         Output output     = IMMEDIATE);
 
     uint32_t BeginEvent(const char *tag);
     void EndEvent(uint32_t event_handle);
     int32_t GetTotalTicks() const;
     void Log() const;
+    void ClearEvents();
+
+    // Emit up to max_events ended events that have not been emitted, in order. Call after Invoke(), or to stream the
+    // events while the interpreter runs, from one other task. Only events published by EndEvent() are read, so the
+    // timestamps are never read while being written. Events that overflow while streaming may be lost. Returns the
+    // number of events emitted, which is always 0 in IMMEDIATE mode.
+    size_t Flush(size_t max_events = SIZE_MAX);
+
+    // Measure the ticks an empty event reports, which are then subtracted from all events. Returns the residual
+    // overhead, the mean ticks an empty event reports after the subtraction. Clears the events.
+    uint32_t Calibrate(size_t iterations = 100);
+    uint32_t GetOverhead() const;
+
+    // Handle of the event that began last and has not ended, or -1 between events, and its tag. Every operator of an
+    // inference has its own handle, also when several operators share a tag. Safe to call from an interrupt handler,
+    // for example to attribute the samples of a sampling profiler.
+    int32_t GetActiveEvent(const char **tag = nullptr) const;
+    const char *GetActiveTag() const;
+
+protected:
+    // Use caller provided storage for max_events events
+    LayerByLayerProfiler(size_t max_events,
+                         Backend backend,
+                         int32_t event_id,
+                         Output output,
+                         const char **tags,
+                         uint64_t *start_ticks,
+                         uint64_t *end_ticks);
 
 private:
-    std::unique_ptr<const char *[]> tags_;
-    std::unique_ptr<uint64_t[]> start_ticks_;
-    std::unique_ptr<uint64_t[]> end_ticks_;
+    uint64_t GetEventTicks(size_t event_handle) const;
+    void Emit(size_t event_handle) const;
+
+    std::unique_ptr<const char *[]> tags_storage_;
+    std::unique_ptr<uint64_t[]> start_ticks_storage_;
+    std::unique_ptr<uint64_t[]> end_ticks_storage_;
+    const char **tags_;
+    uint64_t *start_ticks_;
+    uint64_t *end_ticks_;
 
     size_t max_events_;
     Backend backend;
     int32_t event_id;
+    Output output;
     size_t num_events_;
+    // Events before this index have ended, published by EndEvent() for Flush()
+    std::atomic<size_t> num_ended_;
+    size_t num_flushed_;
+    uint32_t overhead_;
+    bool calibrating_;
+    volatile int32_t active_event_;
 
     TF_LITE_REMOVE_VIRTUAL_DELETE;
 };
 
+// Profiler with compile time sized storage, which does not use the heap
+template <size_t MaxEvents>
+class StaticLayerByLayerProfiler : public LayerByLayerProfiler {
+public:
+    StaticLayerByLayerProfiler(Backend backend  = PRINTF,
+                               int32_t event_id = EventID(EventLevelError, EvtStatistics_No, EventRecordNone),
+                               Output output    = IMMEDIATE) :
+        LayerByLayerProfiler(MaxEvents, backend, event_id, output, tags_, start_ticks_, end_ticks_) {}
+
+private:
+    const char *tags_[MaxEvents];
+    uint64_t start_ticks_[MaxEvents];
+    uint64_t end_ticks_[MaxEvents];
+};
+
 } // namespace tflite
 
 #endif
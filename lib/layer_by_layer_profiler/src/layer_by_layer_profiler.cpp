@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2021-2022 Arm Limited. All rights reserved.
+ * Copyright (c) 2021-2023 Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -21,6 +21,7 @@
 #include "tensorflow/lite/micro/micro_profiler.h"
 #include "tensorflow/lite/micro/micro_time.h"
 
+#include <algorithm>
 #include <string.h>
 
 #include "ethosu_log.h"
@@ -30,25 +31,47 @@
 
 namespace tflite {
 
-LayerByLayerProfiler::LayerByLayerProfiler(size_t max_events, Backend _backend, int32_t _event_id) :
-    max_events_(max_events), backend(_backend), event_id(_event_id), num_events_(0) {
+namespace {
+// End ticks of an event that has not ended
+constexpr uint64_t NotEnded = UINT64_MAX;
+} // namespace
 
-    tags_        = std::make_unique<const char *[]>(max_events);
-    start_ticks_ = std::make_unique<uint64_t[]>(max_events);
-    end_ticks_   = std::make_unique<uint64_t[]>(max_events);
+LayerByLayerProfiler::LayerByLayerProfiler(size_t max_events, Backend _backend, int32_t _event_id, Output _output) :
+    max_events_(max_events), backend(_backend), event_id(_event_id), output(_output), num_events_(0), num_ended_(0),
+    num_flushed_(0), overhead_(0), calibrating_(false), active_event_(-1) {
+
+    tags_storage_        = std::make_unique<const char *[]>(max_events);
+    start_ticks_storage_ = std::make_unique<uint64_t[]>(max_events);
+    end_ticks_storage_   = std::make_unique<uint64_t[]>(max_events);
+
+    tags_        = tags_storage_.get();
+    start_ticks_ = start_ticks_storage_.get();
+    end_ticks_   = end_ticks_storage_.get();
 }
 
+LayerByLayerProfiler::LayerByLayerProfiler(size_t max_events,
+                                           Backend _backend,
+                                           int32_t _event_id,
+                                           Output _output,
+                                           const char **tags,
+                                           uint64_t *start_ticks,
+                                           uint64_t *end_ticks) :
+    tags_(tags), start_ticks_(start_ticks), end_ticks_(end_ticks), max_events_(max_events), backend(_backend),
+    event_id(_event_id), output(_output), num_events_(0), num_ended_(0), num_flushed_(0), overhead_(0),
+    calibrating_(false), active_event_(-1) {}
+
 // NOTE: THIS PROFILER ONLY WORKS ON SYSTEMS WITH 1 NPU
 uint32_t LayerByLayerProfiler::BeginEvent(const char *tag) {
     if (num_events_ == max_events_) {
         MicroPrintf("Profiling event overflow, max: %u events", max_events_);
         num_events_ = 0;
+        num_ended_.store(0, std::memory_order_release);
     }
 
     tags_[num_events_]        = tag;
+    end_ticks_[num_events_]   = NotEnded; // NOTE: In case an EndEvent() doesn't trigger, cycles reports as 0
+    active_event_             = static_cast<int32_t>(num_events_);
     start_ticks_[num_events_] = GetCurrentTimeTicks();
-    end_ticks_[num_events_] =
-        start_ticks_[num_events_]; // NOTE: In case an EndEvent() doesn't trigger, cycles reports as 0
 
     return num_events_++;
 }
@@ -58,13 +81,18 @@ void LayerByLayerProfiler::EndEvent(uint32_t event_handle) {
     TFLITE_DCHECK(event_handle < max_events_);
 
     end_ticks_[event_handle] = GetCurrentTimeTicks();
+    active_event_            = -1;
 
-    if (backend == PRINTF) {
-        LOG("%s : cycle_cnt : %" PRIu64 " cycles\n",
-            tags_[event_handle],
-            end_ticks_[event_handle] - start_ticks_[event_handle]);
-    } else {
-        EventRecord2(event_id, (int32_t)event_handle, end_ticks_[event_handle] - start_ticks_[event_handle]);
+    // Publish the events that have ended in order
+    size_t ended = num_ended_.load(std::memory_order_relaxed);
+    while (ended < num_events_ && end_ticks_[ended] != NotEnded) {
+        ended++;
+    }
+
+    num_ended_.store(ended, std::memory_order_release);
+
+    if (output == IMMEDIATE && !calibrating_) {
+        Emit(event_handle);
     }
 }
 
@@ -72,18 +100,119 @@ int32_t LayerByLayerProfiler::GetTotalTicks() const {
     int32_t ticks = 0;
 
     for (size_t i = 0; i < num_events_; ++i) {
-        ticks += static_cast<int32_t>(end_ticks_[i] - start_ticks_[i]);
+        ticks += static_cast<int32_t>(GetEventTicks(i));
     }
 
     return ticks;
 }
 
+void LayerByLayerProfiler::ClearEvents() {
+    num_events_ = 0;
+    num_ended_.store(0, std::memory_order_release);
+    num_flushed_ = 0;
+}
+
+size_t LayerByLayerProfiler::Flush(size_t max_events) {
+    size_t count = 0;
+
+    // Events are emitted by EndEvent()
+    if (output == IMMEDIATE) {
+        return 0;
+    }
+
+    const size_t ended = num_ended_.load(std::memory_order_acquire);
+
+    // The events have overflowed and started over
+    if (num_flushed_ > ended) {
+        num_flushed_ = 0;
+    }
+
+    while (count < max_events && num_flushed_ < ended) {
+        Emit(num_flushed_++);
+        count++;
+    }
+
+    return count;
+}
+
+uint32_t LayerByLayerProfiler::Calibrate(size_t iterations) {
+    uint64_t minimum = UINT64_MAX;
+
+    calibrating_ = true;
+    overhead_    = 0;
+
+    // The overhead is the minimum, so that interrupts during the calibration are not subtracted from all events
+    for (size_t i = 0; i < iterations; ++i) {
+        ClearEvents();
+        EndEvent(BeginEvent("calibration"));
+        minimum = std::min(minimum, GetEventTicks(0));
+    }
+
+    overhead_ = iterations > 0 ? static_cast<uint32_t>(minimum) : 0;
+
+    uint64_t residual = 0;
+    for (size_t i = 0; i < iterations; ++i) {
+        ClearEvents();
+        EndEvent(BeginEvent("calibration"));
+        residual += GetEventTicks(0);
+    }
+
+    residual = iterations > 0 ? residual / iterations : 0;
+
+    ClearEvents();
+    calibrating_ = false;
+
+    LOG_INFO("Profiler overhead: %" PRIu32 " cycles, residual: %" PRIu64 " cycles", overhead_, residual);
+
+    return static_cast<uint32_t>(residual);
+}
+
+uint32_t LayerByLayerProfiler::GetOverhead() const {
+    return overhead_;
+}
+
+int32_t LayerByLayerProfiler::GetActiveEvent(const char **tag) const {
+    const int32_t event = active_event_;
+
+    if (tag != nullptr) {
+        *tag = event >= 0 ? tags_[event] : nullptr;
+    }
+
+    return event;
+}
+
+const char *LayerByLayerProfiler::GetActiveTag() const {
+    const char *tag;
+
+    GetActiveEvent(&tag);
+
+    return tag;
+}
+
+uint64_t LayerByLayerProfiler::GetEventTicks(size_t event_handle) const {
+    if (end_ticks_[event_handle] == NotEnded) {
+        return 0;
+    }
+
+    const uint64_t ticks = end_ticks_[event_handle] - start_ticks_[event_handle];
+
+    return ticks > overhead_ ? ticks - overhead_ : 0;
+}
+
+void LayerByLayerProfiler::Emit(size_t event_handle) const {
+    if (backend == PRINTF) {
+        LOG("%s : cycle_cnt : %" PRIu64 " cycles\n", tags_[event_handle], GetEventTicks(event_handle));
+    } else {
+        EventRecord2(event_id, (int32_t)event_handle, GetEventTicks(event_handle));
+    }
+}
+
 void LayerByLayerProfiler::Log() const {
 
 #if !defined(TF_LITE_STRIP_ERROR_STRINGS)
     if (backend == PRINTF) {
         for (size_t i = 0; i < num_events_; ++i) {
-            uint64_t ticks = end_ticks_[i] - start_ticks_[i];
+            uint64_t ticks = GetEventTicks(i);
             LOG("%s took %" PRIu64 " cycles", tags_[i], ticks);
         }
     }
@@ -0,0 +1,116 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2023 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Compare an uncompressed model with its packed container: flash size, time to load the model into the SRAM region,
+ * and the cost of reloading after the region has been reused. Once loaded, the model is a plain flatbuffer in SRAM,
+ * so the per inference overhead is zero unless the region is shared and the model must be reloaded.
+ */
+
+#include "model_loader.hpp"
+
+#include <chrono>
+#include <fstream>
+#include <iterator>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+using namespace std;
+using namespace ModelLoader;
+
+namespace {
+vector<uint8_t> readFile(const char *path) {
+    ifstream file(path, ios::binary);
+    return vector<uint8_t>(istreambuf_iterator<char>(file), istreambuf_iterator<char>());
+}
+
+template <typename F>
+double measure(size_t iterations, F &&func) {
+    auto begin = chrono::steady_clock::now();
+
+    for (size_t i = 0; i < iterations; i++) {
+        func();
+    }
+
+    chrono::duration<double, micro> elapsed = chrono::steady_clock::now() - begin;
+    return elapsed.count() / iterations;
+}
+} // namespace
+
+int main(int argc, char *argv[]) {
+    if (argc < 3) {
+        printf("Usage: %s <model.tflite> <model.eucm> [iterations]\n", argv[0]);
+        return 1;
+    }
+
+    const vector<uint8_t> model = readFile(argv[1]);
+    const size_t iterations     = argc > 3 ? strtoul(argv[3], nullptr, 0) : 100;
+
+    // Copy the container to 32 bit aligned storage
+    const vector<uint8_t> file = readFile(argv[2]);
+    vector<uint32_t> storage((file.size() + 3) / 4);
+    memcpy(storage.data(), file.data(), file.size());
+
+    CompressedModel compressed(storage.data(), file.size());
+    if (compressed.verify()) {
+        return 1;
+    }
+
+    vector<uint8_t> region(compressed.getSize());
+    Loader loader(region.data(), region.size(), false);
+    Loader verifyingLoader(region.data(), region.size(), true);
+
+    const void *data;
+    size_t size;
+
+    if (verifyingLoader.load(compressed, data, size) || size != model.size() ||
+        memcmp(data, model.data(), size) != 0) {
+        printf("Decompressed model does not match the original model\n");
+        return 1;
+    }
+
+    const double copy = measure(iterations, [&]() { memcpy(region.data(), model.data(), model.size()); });
+
+    const double load = measure(iterations, [&]() {
+        loader.invalidate();
+        loader.load(compressed, data, size);
+    });
+
+    const double loadCrc = measure(iterations, [&]() {
+        verifyingLoader.invalidate();
+        verifyingLoader.load(compressed, data, size);
+    });
+
+    const double cached = measure(iterations, [&]() { loader.load(compressed, data, size); });
+
+    const double block = measure(iterations, [&]() {
+        compressed.decompress(region.data(), region.size(), compressed.getNumBlocks() / 2, 1);
+    });
+
+    printf("Flash size:          uncompressed=%zu, compressed=%zu, ratio=%.3f\n",
+           model.size(),
+           file.size(),
+           static_cast<double>(file.size()) / model.size());
+    printf("Load time:           copy=%.1f us, decompress=%.1f us, decompress+crc=%.1f us\n", copy, load, loadCrc);
+    printf("Throughput:          %.1f MB/s\n", model.size() / load);
+    printf("Per inference:       loaded=%.3f us, reload=%.1f us\n", cached, load);
+    printf("Block decompression: block_size=%zu, %.1f us\n", compressed.getBlockSize(), block);
+
+    return 0;
+}
@@ -0,0 +1,141 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2023 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MODEL_LOADER_H
+#define MODEL_LOADER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace ModelLoader {
+
+/**
+ * Compressed model container, as produced by scripts/model_packer.py.
+ *
+ * The model is split into blocks of blockSize bytes, which are compressed independently so that any block can be
+ * decompressed on its own. The header is followed by numBlocks + 1 offsets of the compressed blocks, relative to the
+ * end of the offset table, and by the compressed data. A block whose compressed size equals its decompressed size is
+ * stored uncompressed. All fields are little endian.
+ */
+struct CompressedModelHeader {
+    static constexpr uint32_t Magic   = 0x4d435545; // "EUCM"
+    static constexpr uint16_t Version = 1;
+
+    enum Codec : uint16_t {
+        STORED = 0,
+        LZ4    = 1
+    };
+
+    uint32_t magic;
+    uint16_t version;
+    uint16_t codec;
+    uint32_t size;
+    uint32_t crc;
+    uint32_t blockSize;
+    uint32_t numBlocks;
+    uint32_t reserved[2];
+};
+
+class CompressedModel {
+public:
+    CompressedModel(const void *data = nullptr, size_t size = 0);
+
+    /**
+     * Check the header and the block table. Returns true if the container is invalid.
+     */
+    bool verify() const;
+
+    const void *getData() const;
+
+    // Size of the decompressed model
+    size_t getSize() const;
+    size_t getBlockSize() const;
+    size_t getNumBlocks() const;
+    uint32_t getCrc() const;
+
+    /**
+     * Decompress count blocks starting at block first. dst points at the start of the decompressed model, and the
+     * blocks are written to their offsets in the model.
+     */
+    bool decompress(void *dst, size_t dstSize, size_t first, size_t count) const;
+
+private:
+    const CompressedModelHeader *header;
+    const uint32_t *offsets;
+    const uint8_t *blocks;
+    size_t containerSize;
+};
+
+/**
+ * Decompress models on demand into a caller supplied memory region, typically SRAM.
+ *
+ * The loader remembers which model the region holds, so loading the same model again is free. Large models can be
+ * loaded in steps with begin() and step(), for example to decompress the next model while the NPU is busy with the
+ * current one.
+ */
+class Loader {
+public:
+    Loader(void *region, size_t regionSize, bool verifyCrc = true);
+
+    /**
+     * Load a model into the region. On success model and modelSize describe the decompressed flatbuffer, ready to be
+     * used as network model for an inference job.
+     */
+    bool load(const CompressedModel &compressed, const void *&model, size_t &modelSize);
+
+    /**
+     * Start a stepwise load. Returns true if the model does not fit in the region.
+     */
+    bool begin(const CompressedModel &compressed);
+
+    /**
+     * Decompress up to maxBlocks blocks of the model being loaded. done is set once the whole model has been loaded
+     * and verified.
+     */
+    bool step(size_t maxBlocks, bool &done);
+
+    /**
+     * Forget the loaded model, for example after the region has been used for something else.
+     */
+    void invalidate();
+
+    /**
+     * Container data of the loaded model, or nullptr if no model is loaded.
+     */
+    const void *getLoaded() const;
+
+private:
+    bool finish();
+
+    uint8_t *region;
+    size_t regionSize;
+    bool verifyCrc;
+    CompressedModel current;
+    const void *loaded;
+    size_t nextBlock;
+};
+
+/**
+ * Decompress one LZ4 block. Returns the number of bytes written to dst, or -1 if the block is corrupt or does not
+ * fit.
+ */
+int lz4Decompress(const uint8_t *src, size_t srcSize, uint8_t *dst, size_t dstSize);
+
+} // namespace ModelLoader
+
+#endif
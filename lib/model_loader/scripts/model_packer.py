@@ -0,0 +1,157 @@
+#!/usr/bin/env python3
+#
+# SPDX-FileCopyrightText: Copyright 2023 Arm Limited and/or its affiliates <open-source-office@arm.com>
+# SPDX-License-Identifier: Apache-2.0
+#
+# Licensed under the Apache License, Version 2.0 (the License); you may
+# not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+# www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an AS IS BASIS, WITHOUT
+# WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+
+
+"""
+Pack a network model into the compressed container read by ModelLoader.
+
+The model is split into fixed size blocks that are LZ4 compressed
+independently. Blocks that do not shrink are stored uncompressed. The
+container is written as a binary file, or as a C source file if the output
+file name ends with '.c' or '.cc'.
+"""
+
+import argparse
+import struct
+import zlib
+
+MAGIC = 0x4d435545
+VERSION = 1
+CODEC_STORED = 0
+CODEC_LZ4 = 1
+HEADER = struct.Struct('<IHHIIII8x')
+
+MIN_MATCH = 4
+# The last match must start at least 12 bytes before the end of the block, and the last 5 bytes are always literals
+MF_LIMIT = 12
+LAST_LITERALS = 5
+MAX_OFFSET = 65535
+
+
+def lz4_length(length):
+    out = bytearray()
+    while length >= 255:
+        out.append(255)
+        length -= 255
+    out.append(length)
+    return out
+
+
+def lz4_sequence(out, literals, offset=None, match=0):
+    lit = len(literals)
+    token = min(lit, 15) << 4
+    if offset is not None:
+        token |= min(match - MIN_MATCH, 15)
+
+    out.append(token)
+    if lit >= 15:
+        out += lz4_length(lit - 15)
+    out += literals
+
+    if offset is not None:
+        out += struct.pack('<H', offset)
+        if match - MIN_MATCH >= 15:
+            out += lz4_length(match - MIN_MATCH - 15)
+
+
+def lz4_compress(data):
+    """Greedy LZ4 block compressor."""
+    out = bytearray()
+    table = {}
+    anchor = 0
+    pos = 0
+    limit = len(data) - MF_LIMIT
+    end = len(data) - LAST_LITERALS
+
+    while pos < limit:
+        key = data[pos:pos + MIN_MATCH]
+        candidate = table.get(key)
+        table[key] = pos
+
+        if candidate is None or pos - candidate > MAX_OFFSET:
+            pos += 1
+            continue
+
+        length = MIN_MATCH
+        while pos + length < end and data[candidate + length] == data[pos + length]:
+            length += 1
+
+        lz4_sequence(out, data[anchor:pos], pos - candidate, length)
+        pos += length
+        anchor = pos
+
+    lz4_sequence(out, data[anchor:])
+    return bytes(out)
+
+
+def pack(model, block_size, codec):
+    blocks = []
+    for offset in range(0, len(model), block_size):
+        block = model[offset:offset + block_size]
+        compressed = lz4_compress(block) if codec == CODEC_LZ4 else block
+        blocks.append(compressed if len(compressed) < len(block) else block)
+
+    offsets = [0]
+    for block in blocks:
+        offsets.append(offsets[-1] + len(block))
+
+    header = HEADER.pack(MAGIC, VERSION, codec, len(model), zlib.crc32(model), block_size, len(blocks))
+    table = struct.pack(f'<{len(offsets)}I', *offsets)
+
+    return header + table + b''.join(blocks)
+
+
+def write_source(container, path, name, section):
+    with open(path, 'w') as f:
+        f.write('#include <stddef.h>\n#include <stdint.h>\n\n')
+        f.write(f'const uint8_t {name}[] __attribute__((aligned(16), section("{section}"))) = {{\n')
+
+        for i in range(0, len(container), 16):
+            f.write('    ' + ', '.join(f'0x{b:02x}' for b in container[i:i + 16]) + ',\n')
+
+        f.write('};\n\n')
+        f.write(f'const size_t {name}_size = sizeof({name});\n')
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Pack a network model into a compressed model container')
+    parser.add_argument('input', help='Network model (.tflite)')
+    parser.add_argument('-o', '--output', required=True, help='Output container, binary or C source')
+    parser.add_argument('-b', '--block-size', type=int, default=4096, help='Decompressed block size')
+    parser.add_argument('--stored', action='store_true', help='Store blocks uncompressed')
+    parser.add_argument('-n', '--name', default='network_model', help='Name of the C array')
+    parser.add_argument('-s', '--section', default='network_model_sec', help='Linker section')
+    args = parser.parse_args()
+
+    with open(args.input, 'rb') as f:
+        model = f.read()
+
+    container = pack(model, args.block_size, CODEC_STORED if args.stored else CODEC_LZ4)
+
+    if args.output.endswith(('.c', '.cc')):
+        write_source(container, args.output, args.name, args.section)
+    else:
+        with open(args.output, 'wb') as f:
+            f.write(container)
+
+    print(f'Packed model: size={len(model)}, packed={len(container)}, '
+          f'ratio={len(container) / max(len(model), 1):.3f}, blocks={(len(model) + args.block_size - 1) // args.block_size}')
+
+
+if __name__ == '__main__':
+    main()
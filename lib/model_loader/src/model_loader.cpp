@@ -0,0 +1,332 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2023 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "model_loader.hpp"
+
+#include "crc.hpp"
+#include "ethosu_log.h"
+
+#include <algorithm>
+#include <inttypes.h>
+#include <string.h>
+
+namespace ModelLoader {
+
+/****************************************************************************
+ * LZ4
+ ****************************************************************************/
+
+namespace {
+constexpr size_t Lz4MinMatch = 4;
+
+// Read an LZ4 length extension. Returns true if the input is truncated.
+bool lz4Length(const uint8_t *&src, const uint8_t *end, size_t &length) {
+    uint8_t byte;
+
+    do {
+        if (src >= end) {
+            return true;
+        }
+
+        byte = *src++;
+        length += byte;
+    } while (byte == 255);
+
+    return false;
+}
+} // namespace
+
+int lz4Decompress(const uint8_t *src, size_t srcSize, uint8_t *dst, size_t dstSize) {
+    const uint8_t *srcEnd = src + srcSize;
+    uint8_t *const start  = dst;
+    uint8_t *const dstEnd = dst + dstSize;
+
+    while (src < srcEnd) {
+        const uint8_t token = *src++;
+
+        // Literals
+        size_t length = token >> 4;
+        if (length == 15 && lz4Length(src, srcEnd, length)) {
+            return -1;
+        }
+
+        if (length > static_cast<size_t>(srcEnd - src) || length > static_cast<size_t>(dstEnd - dst)) {
+            return -1;
+        }
+
+        memcpy(dst, src, length);
+        src += length;
+        dst += length;
+
+        // The last sequence only holds literals
+        if (src == srcEnd) {
+            break;
+        }
+
+        // Match
+        if (srcEnd - src < 2) {
+            return -1;
+        }
+
+        const size_t offset = src[0] | (src[1] << 8);
+        src += 2;
+
+        if (offset == 0 || offset > static_cast<size_t>(dst - start)) {
+            return -1;
+        }
+
+        length = token & 0xf;
+        if (length == 15 && lz4Length(src, srcEnd, length)) {
+            return -1;
+        }
+
+        length += Lz4MinMatch;
+        if (length > static_cast<size_t>(dstEnd - dst)) {
+            return -1;
+        }
+
+        // Matches may overlap the output, so copy byte by byte
+        const uint8_t *match = dst - offset;
+        while (length--) {
+            *dst++ = *match++;
+        }
+    }
+
+    return dst - start;
+}
+
+/****************************************************************************
+ * CompressedModel
+ ****************************************************************************/
+
+namespace {
+// Size of the header and the block offsets, computed in 64 bits so that no block count wraps it
+uint64_t getTableSize(const CompressedModelHeader *header) {
+    return sizeof(CompressedModelHeader) + (static_cast<uint64_t>(header->numBlocks) + 1) * sizeof(uint32_t);
+}
+} // namespace
+
+CompressedModel::CompressedModel(const void *data, size_t size) :
+    header(static_cast<const CompressedModelHeader *>(data)), offsets(nullptr), blocks(nullptr), containerSize(size) {
+    // The block data is only located if the offset table fits in the container
+    if (header != nullptr && containerSize >= sizeof(CompressedModelHeader)) {
+        offsets = reinterpret_cast<const uint32_t *>(header + 1);
+
+        if (getTableSize(header) <= containerSize) {
+            blocks = reinterpret_cast<const uint8_t *>(offsets + header->numBlocks + 1);
+        }
+    }
+}
+
+bool CompressedModel::verify() const {
+    if (header == nullptr || offsets == nullptr || reinterpret_cast<uintptr_t>(header) % alignof(uint32_t) != 0) {
+        LOG_ERR("Invalid compressed model: data=%p, size=%zu", static_cast<const void *>(header), containerSize);
+        return true;
+    }
+
+    if (header->magic != CompressedModelHeader::Magic || header->version != CompressedModelHeader::Version) {
+        LOG_ERR("Compressed model magic or version mismatch: magic=0x%08" PRIx32 ", version=%u",
+                header->magic,
+                header->version);
+        return true;
+    }
+
+    if (header->codec != CompressedModelHeader::STORED && header->codec != CompressedModelHeader::LZ4) {
+        LOG_ERR("Unsupported compressed model codec: codec=%u", header->codec);
+        return true;
+    }
+
+    if (header->blockSize == 0) {
+        LOG_ERR("Invalid compressed model block size");
+        return true;
+    }
+
+    const uint64_t tableSize = getTableSize(header);
+    const uint64_t expected  = (static_cast<uint64_t>(header->size) + header->blockSize - 1) / header->blockSize;
+    if (header->numBlocks != expected || tableSize > containerSize || blocks == nullptr) {
+        LOG_ERR("Invalid compressed model block table: blocks=%" PRIu32 ", block_size=%" PRIu32,
+                header->numBlocks,
+                header->blockSize);
+        return true;
+    }
+
+    for (size_t i = 0; i < header->numBlocks; i++) {
+        if (offsets[i] > offsets[i + 1]) {
+            LOG_ERR("Invalid compressed model block offset: block=%zu", i);
+            return true;
+        }
+    }
+
+    if (offsets[0] != 0 || offsets[header->numBlocks] > containerSize - tableSize) {
+        LOG_ERR("Compressed model truncated: size=%zu", containerSize);
+        return true;
+    }
+
+    return false;
+}
+
+const void *CompressedModel::getData() const {
+    return header;
+}
+
+size_t CompressedModel::getSize() const {
+    return header->size;
+}
+
+size_t CompressedModel::getBlockSize() const {
+    return header->blockSize;
+}
+
+size_t CompressedModel::getNumBlocks() const {
+    return header->numBlocks;
+}
+
+uint32_t CompressedModel::getCrc() const {
+    return header->crc;
+}
+
+bool CompressedModel::decompress(void *dst, size_t dstSize, size_t first, size_t count) const {
+    if (dstSize < header->size || first + count > header->numBlocks) {
+        LOG_ERR("Invalid decompress request: size=%zu, first=%zu, count=%zu", dstSize, first, count);
+        return true;
+    }
+
+    for (size_t i = first; i < first + count; i++) {
+        const size_t offset  = i * header->blockSize;
+        const size_t size    = std::min<size_t>(header->blockSize, header->size - offset);
+        const uint8_t *src   = blocks + offsets[i];
+        const size_t srcSize = offsets[i + 1] - offsets[i];
+        uint8_t *out         = static_cast<uint8_t *>(dst) + offset;
+
+        if (header->codec == CompressedModelHeader::STORED || srcSize == size) {
+            if (srcSize != size) {
+                LOG_ERR("Stored block size mismatch: block=%zu", i);
+                return true;
+            }
+
+            memcpy(out, src, size);
+            continue;
+        }
+
+        if (lz4Decompress(src, srcSize, out, size) != static_cast<int>(size)) {
+            LOG_ERR("Failed to decompress block: block=%zu", i);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/****************************************************************************
+ * Loader
+ ****************************************************************************/
+
+Loader::Loader(void *_region, size_t _regionSize, bool _verifyCrc) :
+    region(static_cast<uint8_t *>(_region)), regionSize(_regionSize), verifyCrc(_verifyCrc), loaded(nullptr),
+    nextBlock(0) {}
+
+bool Loader::load(const CompressedModel &compressed, const void *&model, size_t &modelSize) {
+    if (loaded != compressed.getData()) {
+        bool done = false;
+
+        if (begin(compressed) || step(compressed.getNumBlocks(), done)) {
+            return true;
+        }
+    }
+
+    model     = region;
+    modelSize = compressed.getSize();
+
+    return false;
+}
+
+bool Loader::begin(const CompressedModel &compressed) {
+    invalidate();
+
+    if (compressed.verify()) {
+        return true;
+    }
+
+    if (compressed.getSize() > regionSize) {
+        LOG_ERR("Model does not fit in region: size=%zu, region=%zu", compressed.getSize(), regionSize);
+        return true;
+    }
+
+    current   = compressed;
+    nextBlock = 0;
+
+    return false;
+}
+
+bool Loader::step(size_t maxBlocks, bool &done) {
+    done = false;
+
+    if (current.getData() == nullptr) {
+        LOG_ERR("No model being loaded");
+        return true;
+    }
+
+    const size_t count = std::min(maxBlocks, current.getNumBlocks() - nextBlock);
+    if (current.decompress(region, regionSize, nextBlock, count)) {
+        current = CompressedModel();
+        return true;
+    }
+
+    nextBlock += count;
+
+    if (nextBlock < current.getNumBlocks()) {
+        return false;
+    }
+
+    if (finish()) {
+        return true;
+    }
+
+    done = true;
+
+    return false;
+}
+
+bool Loader::finish() {
+    if (verifyCrc) {
+        constexpr auto crc = Crc();
+
+        if (crc.crc32(region, current.getSize()) != current.getCrc()) {
+            LOG_ERR("Decompressed model CRC mismatch");
+            current = CompressedModel();
+            return true;
+        }
+    }
+
+    loaded  = current.getData();
+    current = CompressedModel();
+
+    return false;
+}
+
+void Loader::invalidate() {
+    loaded    = nullptr;
+    current   = CompressedModel();
+    nextBlock = 0;
+}
+
+const void *Loader::getLoaded() const {
+    return loaded;
+}
+
+} // namespace ModelLoader
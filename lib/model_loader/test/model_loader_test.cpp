@@ -0,0 +1,160 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2023 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Verify well formed and malformed compressed model containers.
+ */
+
+#include "model_loader.hpp"
+
+#include "crc.hpp"
+
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+using namespace ModelLoader;
+
+namespace {
+
+constexpr uint32_t BlockSize = 16;
+constexpr uint32_t NumBlocks = 3;
+constexpr uint32_t ModelSize = BlockSize * NumBlocks - 4;
+
+// Container words, so that the header is aligned
+struct Container {
+    std::vector<uint32_t> words;
+
+    CompressedModelHeader &header() {
+        return *reinterpret_cast<CompressedModelHeader *>(words.data());
+    }
+
+    uint32_t *offsets() {
+        return reinterpret_cast<uint32_t *>(&header() + 1);
+    }
+
+    CompressedModel model(size_t size) const {
+        return CompressedModel(words.data(), size);
+    }
+
+    size_t size() const {
+        return words.size() * sizeof(uint32_t);
+    }
+};
+
+// A container holding the stored blocks of a model with byte i set to i
+Container makeContainer(uint8_t *model) {
+    Container c;
+
+    for (size_t i = 0; i < ModelSize; i++) {
+        model[i] = static_cast<uint8_t>(i);
+    }
+
+    const size_t tableWords = sizeof(CompressedModelHeader) / sizeof(uint32_t) + NumBlocks + 1;
+    c.words.resize(tableWords + (ModelSize + 3) / 4);
+
+    CompressedModelHeader &header = c.header();
+    header.magic                  = CompressedModelHeader::Magic;
+    header.version                = CompressedModelHeader::Version;
+    header.codec                  = CompressedModelHeader::STORED;
+    header.size                   = ModelSize;
+    header.crc                    = Crc().crc32(model, ModelSize);
+    header.blockSize              = BlockSize;
+    header.numBlocks              = NumBlocks;
+
+    for (uint32_t i = 0; i <= NumBlocks; i++) {
+        c.offsets()[i] = i < NumBlocks ? i * BlockSize : ModelSize;
+    }
+
+    memcpy(&c.words[tableWords], model, ModelSize);
+
+    return c;
+}
+
+bool check(bool condition, const char *message) {
+    if (!condition) {
+        fprintf(stderr, "FAIL: %s\n", message);
+    }
+
+    return !condition;
+}
+
+bool testValid() {
+    uint8_t model[ModelSize];
+    uint8_t out[ModelSize] = {};
+    Container c            = makeContainer(model);
+    bool failed            = false;
+
+    failed |= check(!c.model(c.size()).verify(), "valid container");
+    failed |= check(!c.model(c.size()).decompress(out, sizeof(out), 0, NumBlocks), "decompress");
+    failed |= check(memcmp(out, model, ModelSize) == 0, "decompressed model");
+
+    return failed;
+}
+
+bool testMalformed() {
+    uint8_t model[ModelSize];
+    bool failed = false;
+
+    // The offset table size wraps in 32 bits, and the header is consistent with a 4 GiB model of 1 byte blocks
+    Container c            = makeContainer(model);
+    c.header().size        = UINT32_MAX;
+    c.header().blockSize   = 1;
+    c.header().numBlocks   = UINT32_MAX;
+    failed |= check(c.model(c.size()).verify(), "block count overflowing the offset table");
+
+    c                    = makeContainer(model);
+    c.header().numBlocks = NumBlocks + 1;
+    failed |= check(c.model(c.size()).verify(), "block count not matching the model size");
+
+    c = makeContainer(model);
+    failed |= check(c.model(sizeof(CompressedModelHeader) + 2 * sizeof(uint32_t)).verify(), "truncated offset table");
+    failed |= check(c.model(c.size() - 1).verify(), "truncated block data");
+    failed |= check(c.model(sizeof(CompressedModelHeader) - 1).verify(), "truncated header");
+
+    c                    = makeContainer(model);
+    c.header().blockSize = 0;
+    failed |= check(c.model(c.size()).verify(), "zero block size");
+
+    c               = makeContainer(model);
+    c.header().magic = 0;
+    failed |= check(c.model(c.size()).verify(), "magic");
+
+    c              = makeContainer(model);
+    c.offsets()[1] = 2 * BlockSize + 1;
+    failed |= check(c.model(c.size()).verify(), "decreasing block offsets");
+
+    c              = makeContainer(model);
+    c.offsets()[0] = 1;
+    failed |= check(c.model(c.size()).verify(), "first block offset");
+
+    return failed;
+}
+
+} // namespace
+
+int main() {
+    bool failed = false;
+
+    failed |= testValid();
+    failed |= testMalformed();
+
+    printf("%s\n", failed ? "FAILED" : "PASSED");
+
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,113 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2023 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "inference_process.hpp"
+
+#include <metal/io.h>
+#include <openamp/rpmsg.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Cache maintenance operates on whole cache lines of this size
+#ifndef RPMSG_ZERO_COPY_CACHE_LINE_SIZE
+#if defined(__DCACHE_PRESENT) && (__DCACHE_PRESENT == 1U)
+#define RPMSG_ZERO_COPY_CACHE_LINE_SIZE 32
+#else
+#define RPMSG_ZERO_COPY_CACHE_LINE_SIZE 1
+#endif
+#endif
+
+namespace InferenceProcess {
+
+/**
+ * Inference job received over rpmsg. The rpmsg buffer carrying the request is held until the job has completed.
+ */
+struct RpmsgInferenceJob {
+    InferenceJob job;
+    void *rxBuffer;
+    size_t rxLength;
+
+    RpmsgInferenceJob();
+};
+
+/**
+ * Zero copy receive path from rpmsg to InferenceProcess.
+ *
+ * Payload inside rpmsg buffers and data in the shared memory carve-out are wrapped as DataPtr instead of being
+ * copied into job buffers. The remote processor owns the data until hold() is called from the endpoint callback.
+ * Input ranges are invalidated when they are wrapped, output ranges are cleaned in complete(), after which the rpmsg
+ * buffer is returned to the virtqueue.
+ *
+ * Invalidation discards whole cache lines, including the bytes of the first and last line outside of the range. This
+ * core never writes rx buffers, so the lines around a range in an rx buffer hold no dirty data, provided the rpmsg
+ * buffers are cache line aligned. Ranges of the carve-out must start and end on a cache line boundary, or dirty data
+ * of their neighbours would be lost.
+ */
+class RpmsgZeroCopy {
+public:
+    /**
+     * bytesWrapped counts the payload wrapped without copying. bytesCopied counts the bytes runJob() copied between
+     * the wrapped buffers and the tensor arena, see InferenceJob::bytesCopied.
+     */
+    struct Stats {
+        uint32_t requests;
+        uint64_t bytesWrapped;
+        uint64_t bytesCopied;
+    };
+
+    /**
+     * @param ept   Endpoint the requests are received on
+     * @param shm   IO region of the shared memory carve-out, or nullptr if only rpmsg buffers are used
+     */
+    RpmsgZeroCopy(struct rpmsg_endpoint *ept, struct metal_io_region *shm = nullptr);
+
+    /**
+     * Take ownership of an rpmsg rx buffer. Must be called from the endpoint callback, with the data and the length
+     * passed to the callback.
+     */
+    void hold(RpmsgInferenceJob &job, void *rxBuffer, size_t rxLength);
+
+    /**
+     * Wrap a range inside the received payload of the held rx buffer.
+     */
+    bool wrapBuffer(const RpmsgInferenceJob &job, void *data, size_t size, DataPtr &ptr);
+
+    /**
+     * Wrap a range of the shared memory carve-out given by its physical address. The range must be cache line
+     * aligned, see RPMSG_ZERO_COPY_CACHE_LINE_SIZE.
+     */
+    bool wrapShared(metal_phys_addr_t pa, size_t size, DataPtr &ptr);
+
+    /**
+     * Hand the output back to the remote processor and release the rx buffer to the virtqueue. Must be called once
+     * runJob() has returned.
+     */
+    void complete(RpmsgInferenceJob &job);
+
+    const Stats &getStats() const;
+    void resetStats();
+
+private:
+    struct rpmsg_endpoint *ept;
+    struct metal_io_region *shm;
+    Stats stats;
+};
+
+} // namespace InferenceProcess
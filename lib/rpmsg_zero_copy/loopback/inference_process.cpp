@@ -0,0 +1,78 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2023 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "inference_process.hpp"
+
+#include <string.h>
+
+namespace InferenceProcess {
+
+Traffic &getTraffic() {
+    static Traffic traffic;
+    return traffic;
+}
+
+void countedCopy(void *dst, const void *src, size_t size) {
+    memcpy(dst, src, size);
+    getTraffic().bytesCopied += size;
+}
+
+DataPtr::DataPtr(void *_data, size_t _size) : data(_data), size(_size) {}
+
+void DataPtr::invalidate() {
+    getTraffic().invalidates++;
+}
+
+void DataPtr::clean() {
+    getTraffic().cleans++;
+}
+
+char *DataPtr::begin() const {
+    return static_cast<char *>(data);
+}
+
+char *DataPtr::end() const {
+    return static_cast<char *>(data) + size;
+}
+
+InferenceProcess::InferenceProcess(uint8_t *_tensorArena, size_t _tensorArenaSize) :
+    tensorArena(_tensorArena), tensorArenaSize(_tensorArenaSize) {}
+
+bool InferenceProcess::runJob(InferenceJob &job) {
+    if (job.input.size() != 1 || job.output.size() != 1 || job.input[0].size == 0 ||
+        job.input[0].size + job.output[0].size > tensorArenaSize) {
+        return true;
+    }
+
+    const size_t inputSize  = job.input[0].size;
+    const size_t outputSize = job.output[0].size;
+    uint8_t *input          = tensorArena;
+    uint8_t *output         = tensorArena + inputSize;
+
+    countedCopy(input, job.input[0].data, inputSize);
+
+    for (size_t i = 0; i < outputSize; i++) {
+        output[i] = ~input[i % inputSize];
+    }
+
+    countedCopy(job.output[0].data, output, outputSize);
+    job.bytesCopied = inputSize + outputSize;
+
+    return false;
+}
+
+} // namespace InferenceProcess
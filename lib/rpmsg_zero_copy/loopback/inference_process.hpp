@@ -0,0 +1,81 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2023 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+/*
+ * Mock of the InferenceProcess interface used by RpmsgZeroCopy. Every copy and every cache maintenance operation is
+ * counted, so that the loopback can compare the measured traffic with the statistics of RpmsgZeroCopy.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace InferenceProcess {
+
+struct Traffic {
+    uint64_t bytesCopied;
+    uint32_t invalidates;
+    uint32_t cleans;
+};
+
+Traffic &getTraffic();
+
+// memcpy counted in the traffic
+void countedCopy(void *dst, const void *src, size_t size);
+
+struct DataPtr {
+    void *data;
+    size_t size;
+
+    DataPtr(void *data = nullptr, size_t size = 0);
+
+    void invalidate();
+    void clean();
+
+    char *begin() const;
+    char *end() const;
+};
+
+struct InferenceJob {
+    std::string name;
+    DataPtr networkModel;
+    std::vector<DataPtr> input;
+    std::vector<DataPtr> output;
+    uint64_t cpuCycles{0};
+    size_t bytesCopied{0};
+};
+
+/**
+ * Runs a network with one input and one output tensor in the tensor arena. Every byte of the output is the inverse of
+ * the input byte at the same index, modulo the input size. Like the real runJob(), the input is copied into the
+ * arena and the output out of it.
+ */
+class InferenceProcess {
+public:
+    InferenceProcess(uint8_t *tensorArena, size_t tensorArenaSize);
+
+    bool runJob(InferenceJob &job);
+
+private:
+    uint8_t *tensorArena;
+    size_t tensorArenaSize;
+};
+
+} // namespace InferenceProcess
@@ -0,0 +1,424 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2023 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Loopback test of the rpmsg receive path on the Linux port of libmetal.
+ *
+ * A host thread sends inference requests over rpmsg to a remote, which runs them on an inference task. The input is
+ * in the request and the output is written to a shared memory carve-out. Requests are run twice:
+ *
+ * - copy: the remote copies the input into a job buffer and releases the rx buffer. The output is copied from a job
+ *   buffer into the response.
+ * - zero copy: the remote wraps the input in the held rx buffer and the output in the carve-out with RpmsgZeroCopy.
+ *
+ * Every memcpy on the remote, including the copies of runJob() into and out of the tensor arena, is counted. The test
+ * fails if the outputs are wrong, if the bytes copied per request differ from the expected, or if the bytes copied
+ * reported by RpmsgZeroCopy differ from the measured.
+ */
+
+#include "inference_process.hpp"
+#include "rpmsg_zero_copy.hpp"
+#include "virtio_loopback.h"
+
+#include <metal/sys.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <sys/mman.h>
+#include <thread>
+
+using namespace std;
+using namespace InferenceProcess;
+
+namespace {
+
+enum Mode : uint32_t {
+    COPY,
+    ZERO_COPY
+};
+
+struct Request {
+    uint32_t seq;
+    uint32_t mode;
+    uint32_t inputSize;
+    uint32_t outputSize;
+    uint64_t outputPa;
+};
+
+struct Response {
+    uint32_t seq;
+    uint32_t status;
+};
+
+struct Config {
+    uint32_t requests   = 1000;
+    uint32_t inputSize  = 256;
+    uint32_t outputSize = 64;
+};
+
+constexpr const char *CarveOutName = "/rpmsg_zero_copy_carveout";
+constexpr size_t CarveOutSize      = 4096;
+
+uint8_t getInput(uint32_t seq, size_t i) {
+    return static_cast<uint8_t>(seq + i);
+}
+
+bool checkOutput(const Request &request, const uint8_t *output) {
+    for (size_t i = 0; i < request.outputSize; i++) {
+        if (output[i] != static_cast<uint8_t>(~getInput(request.seq, i % request.inputSize))) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/*
+ * Remote side. The endpoint callback runs on the interrupt thread and hands the jobs to the inference task.
+ */
+class Remote {
+public:
+    Remote(struct rpmsg_device *rdev, struct metal_io_region *carveOut) :
+        zeroCopy(&ept, carveOut), process(arena, sizeof(arena)), running(true) {
+        rpmsg_create_ept(&ept,
+                         rdev,
+                         "rpmsg-zero-copy",
+                         VIRTIO_LOOPBACK_REMOTE_ADDR,
+                         VIRTIO_LOOPBACK_HOST_ADDR,
+                         callback,
+                         nullptr);
+        ept.priv = this;
+        task     = thread([this] { run(); });
+    }
+
+    ~Remote() {
+        {
+            lock_guard<mutex> lock(mtx);
+            running = false;
+        }
+
+        cv.notify_one();
+        task.join();
+        rpmsg_destroy_ept(&ept);
+    }
+
+    RpmsgZeroCopy zeroCopy;
+
+private:
+    struct Job {
+        RpmsgInferenceJob rpmsg;
+        Request request;
+        uint8_t inputBuffer[RPMSG_BUFFER_SIZE];
+        uint8_t outputBuffer[RPMSG_BUFFER_SIZE];
+    };
+
+    static int callback(struct rpmsg_endpoint *ept, void *data, size_t len, uint32_t src, void *priv) {
+        (void)src;
+        (void)priv;
+
+        static_cast<Remote *>(ept->priv)->receive(data, len);
+        return RPMSG_SUCCESS;
+    }
+
+    void receive(void *data, size_t len) {
+        Job &job = jobs[next++ % 2];
+        memcpy(&job.request, data, sizeof(job.request));
+
+        uint8_t *payload = static_cast<uint8_t *>(data) + sizeof(Request);
+        bool failed      = len < sizeof(Request) + job.request.inputSize;
+
+        // The output of the copy path must fit in the response
+        failed = failed || job.request.outputSize > sizeof(job.outputBuffer) - sizeof(Response);
+
+        job.rpmsg.job.input.assign(1, DataPtr());
+        job.rpmsg.job.output.assign(1, DataPtr());
+
+        if (!failed && job.request.mode == ZERO_COPY) {
+            zeroCopy.hold(job.rpmsg, data, len);
+            failed = zeroCopy.wrapBuffer(job.rpmsg, payload, job.request.inputSize, job.rpmsg.job.input[0]) ||
+                     zeroCopy.wrapShared(job.request.outputPa, job.request.outputSize, job.rpmsg.job.output[0]);
+        } else if (!failed) {
+            countedCopy(job.inputBuffer, payload, job.request.inputSize);
+            job.rpmsg.job.input[0]  = DataPtr(job.inputBuffer, job.request.inputSize);
+            job.rpmsg.job.output[0] = DataPtr(job.outputBuffer, job.request.outputSize);
+        }
+
+        if (failed) {
+            printf("Invalid request: seq=%u\n", job.request.seq);
+            job.rpmsg.job.input.clear();
+        }
+
+        {
+            lock_guard<mutex> lock(mtx);
+            queue.push_back(&job);
+        }
+
+        cv.notify_one();
+    }
+
+    void run() {
+        while (true) {
+            Job *job;
+
+            {
+                unique_lock<mutex> lock(mtx);
+                cv.wait(lock, [this] { return !queue.empty() || !running; });
+
+                if (queue.empty()) {
+                    return;
+                }
+
+                job = queue.front();
+                queue.pop_front();
+            }
+
+            Response response = {job->request.seq, process.runJob(job->rpmsg.job)};
+
+            if (job->request.mode == ZERO_COPY) {
+                zeroCopy.complete(job->rpmsg);
+                rpmsg_send(&ept, &response, sizeof(response));
+                continue;
+            }
+
+            // Copy the output from the job buffer into the response
+            uint32_t length;
+            uint8_t *buffer = static_cast<uint8_t *>(rpmsg_get_tx_payload_buffer(&ept, &length, 1));
+            memcpy(buffer, &response, sizeof(response));
+            countedCopy(buffer + sizeof(response), job->outputBuffer, job->request.outputSize);
+            rpmsg_send_nocopy(&ept, buffer, sizeof(response) + job->request.outputSize);
+        }
+    }
+
+    struct rpmsg_endpoint ept;
+    uint8_t arena[2 * RPMSG_BUFFER_SIZE];
+    ::InferenceProcess::InferenceProcess process;
+    Job jobs[2];
+    size_t next = 0;
+    mutex mtx;
+    condition_variable cv;
+    deque<Job *> queue;
+    bool running;
+    thread task;
+};
+
+/*
+ * Host side, sending one request at a time.
+ */
+class Host {
+public:
+    Host(struct rpmsg_device *rdev, uint8_t *_carveOutVa, metal_phys_addr_t _carveOutPa) :
+        carveOutVa(_carveOutVa), carveOutPa(_carveOutPa), received(false), failed(false) {
+        rpmsg_create_ept(&ept,
+                         rdev,
+                         "rpmsg-zero-copy",
+                         VIRTIO_LOOPBACK_HOST_ADDR,
+                         VIRTIO_LOOPBACK_REMOTE_ADDR,
+                         callback,
+                         nullptr);
+        ept.priv = this;
+    }
+
+    ~Host() {
+        rpmsg_destroy_ept(&ept);
+    }
+
+    bool run(const Config &cfg, Mode mode) {
+        for (uint32_t seq = 0; seq < cfg.requests; seq++) {
+            uint32_t length;
+            uint8_t *buffer = static_cast<uint8_t *>(rpmsg_get_tx_payload_buffer(&ept, &length, 1));
+            if (buffer == nullptr || length < sizeof(Request) + cfg.inputSize) {
+                printf("Request does not fit in rpmsg buffer: size=%zu\n", sizeof(Request) + cfg.inputSize);
+                return true;
+            }
+
+            request = {seq, mode, cfg.inputSize, cfg.outputSize, carveOutPa};
+            memcpy(buffer, &request, sizeof(request));
+
+            for (size_t i = 0; i < cfg.inputSize; i++) {
+                buffer[sizeof(request) + i] = getInput(seq, i);
+            }
+
+            received = false;
+            rpmsg_send_nocopy(&ept, buffer, sizeof(request) + cfg.inputSize);
+
+            while (!received) {
+                sched_yield();
+            }
+
+            if (failed) {
+                printf("Wrong output: mode=%s, seq=%u\n", mode == COPY ? "copy" : "zero copy", seq);
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+private:
+    static int callback(struct rpmsg_endpoint *ept, void *data, size_t len, uint32_t src, void *priv) {
+        (void)src;
+        (void)priv;
+
+        static_cast<Host *>(ept->priv)->receive(static_cast<const uint8_t *>(data), len);
+        return RPMSG_SUCCESS;
+    }
+
+    void receive(const uint8_t *data, size_t len) {
+        Response response;
+        memcpy(&response, data, sizeof(response));
+
+        const uint8_t *output = request.mode == COPY ? data + sizeof(response) : carveOutVa;
+        const size_t size     = request.mode == COPY ? len - sizeof(response) : request.outputSize;
+
+        failed = response.status != 0 || response.seq != request.seq || size != request.outputSize;
+        failed = failed || checkOutput(request, output);
+
+        received = true;
+    }
+
+    struct rpmsg_endpoint ept;
+    uint8_t *carveOutVa;
+    metal_phys_addr_t carveOutPa;
+    Request request;
+    atomic<bool> received;
+    atomic<bool> failed;
+};
+
+bool check(const char *name, uint64_t value, uint64_t expected) {
+    if (value != expected) {
+        printf("%s: %llu, expected=%llu\n",
+               name,
+               static_cast<unsigned long long>(value),
+               static_cast<unsigned long long>(expected));
+        return true;
+    }
+
+    return false;
+}
+
+bool measure(const Config &cfg, Mode mode, Host &host, Remote &remote) {
+    getTraffic() = Traffic();
+    remote.zeroCopy.resetStats();
+
+    if (host.run(cfg, mode)) {
+        return true;
+    }
+
+    const Traffic traffic             = getTraffic();
+    const RpmsgZeroCopy::Stats &stats = remote.zeroCopy.getStats();
+    const uint64_t payload            = cfg.inputSize + cfg.outputSize;
+
+    printf("%-10s requests=%u, copied=%llu bytes/request, invalidated=%u, cleaned=%u\n",
+           mode == COPY ? "copy" : "zero copy",
+           cfg.requests,
+           static_cast<unsigned long long>(traffic.bytesCopied / cfg.requests),
+           traffic.invalidates,
+           traffic.cleans);
+
+    // Both paths copy into and out of the tensor arena, the copy path also into and out of the job buffers
+    if (mode == COPY) {
+        return check("Bytes copied", traffic.bytesCopied, 2 * payload * cfg.requests);
+    }
+
+    return check("Bytes copied", traffic.bytesCopied, payload * cfg.requests) ||
+           check("Reported bytes copied", stats.bytesCopied, traffic.bytesCopied) ||
+           check("Reported bytes wrapped", stats.bytesWrapped, payload * cfg.requests) ||
+           check("Requests", stats.requests, cfg.requests) ||
+           check("Invalidated ranges", traffic.invalidates, 2 * cfg.requests) ||
+           check("Cleaned ranges", traffic.cleans, cfg.requests);
+}
+
+void usage(const char *name) {
+    printf("Usage: %s [options]\n"
+           "  --requests N      Number of requests of each mode\n"
+           "  --input N         Input size in bytes\n"
+           "  --output N        Output size in bytes\n",
+           name);
+}
+
+bool parse(int argc, char *argv[], Config &cfg) {
+    for (int i = 1; i < argc; i++) {
+        const string arg = argv[i];
+
+        if (arg == "--help" || i + 1 >= argc) {
+            return true;
+        }
+
+        if (arg == "--requests") {
+            cfg.requests = strtoul(argv[++i], nullptr, 0);
+        } else if (arg == "--input") {
+            cfg.inputSize = strtoul(argv[++i], nullptr, 0);
+        } else if (arg == "--output") {
+            cfg.outputSize = strtoul(argv[++i], nullptr, 0);
+        } else {
+            return true;
+        }
+    }
+
+    return cfg.requests == 0 || cfg.inputSize == 0 || cfg.outputSize > CarveOutSize;
+}
+} // namespace
+
+int main(int argc, char *argv[]) {
+    Config cfg;
+    if (parse(argc, argv, cfg)) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    struct virtio_loopback lb;
+    if (virtio_loopback_init(&lb, "/rpmsg_zero_copy_shm", "/rpmsg_zero_copy_irq")) {
+        printf("Failed to initialize loopback\n");
+        return 1;
+    }
+
+    // Carve-out the outputs are written to, mapped 1:1
+    uint8_t *carveOutVa = static_cast<uint8_t *>(sys_linux_shm_map(CarveOutName, CarveOutSize));
+    if (carveOutVa == nullptr) {
+        printf("Failed to map carve-out\n");
+        virtio_loopback_deinit(&lb);
+        return 1;
+    }
+
+    const metal_phys_addr_t carveOutPa = reinterpret_cast<uintptr_t>(carveOutVa);
+    struct metal_io_region carveOut;
+    metal_io_init(&carveOut, carveOutVa, &carveOutPa, CarveOutSize, static_cast<unsigned int>(-1), 0, nullptr);
+
+    bool failed;
+
+    {
+        Remote remote(virtio_loopback_remote(&lb), &carveOut);
+        Host host(virtio_loopback_host(&lb), carveOutVa, carveOutPa);
+
+        failed = measure(cfg, COPY, host, remote) || measure(cfg, ZERO_COPY, host, remote);
+    }
+
+    sys_linux_shm_unmap(carveOutVa, CarveOutSize);
+    shm_unlink(CarveOutName);
+    virtio_loopback_deinit(&lb);
+
+    printf("Loopback test %s\n", failed ? "failed" : "passed");
+
+    return failed ? 1 : 0;
+}
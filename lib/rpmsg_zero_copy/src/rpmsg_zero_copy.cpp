@@ -0,0 +1,109 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2023 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "rpmsg_zero_copy.hpp"
+#include "ethosu_log.h"
+
+namespace InferenceProcess {
+
+RpmsgInferenceJob::RpmsgInferenceJob() : rxBuffer(nullptr), rxLength(0) {}
+
+RpmsgZeroCopy::RpmsgZeroCopy(struct rpmsg_endpoint *_ept, struct metal_io_region *_shm) :
+    ept(_ept), shm(_shm), stats() {}
+
+void RpmsgZeroCopy::hold(RpmsgInferenceJob &job, void *rxBuffer, size_t rxLength) {
+    rpmsg_hold_rx_buffer(ept, rxBuffer);
+    job.rxBuffer = rxBuffer;
+    job.rxLength = rxLength;
+}
+
+bool RpmsgZeroCopy::wrapBuffer(const RpmsgInferenceJob &job, void *data, size_t size, DataPtr &ptr) {
+    if (job.rxBuffer == nullptr) {
+        LOG_ERR("No rx buffer held for job");
+        return true;
+    }
+
+    // The range must be located inside the received payload, checked without overflowing
+    const uintptr_t begin = reinterpret_cast<uintptr_t>(job.rxBuffer);
+    const uintptr_t addr  = reinterpret_cast<uintptr_t>(data);
+    const size_t length   = job.rxLength;
+
+    if (addr < begin || size > length || addr - begin > length - size) {
+        LOG_ERR("Data outside of rx buffer: data=%p, size=%zu", data, size);
+        return true;
+    }
+
+    ptr = DataPtr(data, size);
+    ptr.invalidate();
+    stats.bytesWrapped += size;
+
+    return false;
+}
+
+bool RpmsgZeroCopy::wrapShared(metal_phys_addr_t pa, size_t size, DataPtr &ptr) {
+    if (shm == nullptr || size == 0) {
+        LOG_ERR("No shared memory region");
+        return true;
+    }
+
+    void *first = metal_io_phys_to_virt(shm, pa);
+    void *last  = metal_io_phys_to_virt(shm, pa + size - 1);
+
+    if (first == nullptr || last == nullptr) {
+        LOG_ERR("Data outside of shared memory: pa=0x%lx, size=%zu", static_cast<unsigned long>(pa), size);
+        return true;
+    }
+
+    // Invalidating a partial cache line would discard the dirty data of the neighbours in the line
+    if (reinterpret_cast<uintptr_t>(first) % RPMSG_ZERO_COPY_CACHE_LINE_SIZE != 0 ||
+        size % RPMSG_ZERO_COPY_CACHE_LINE_SIZE != 0) {
+        LOG_ERR("Shared memory range not cache line aligned: pa=0x%lx, size=%zu", static_cast<unsigned long>(pa), size);
+        return true;
+    }
+
+    ptr = DataPtr(first, size);
+    ptr.invalidate();
+    stats.bytesWrapped += size;
+
+    return false;
+}
+
+void RpmsgZeroCopy::complete(RpmsgInferenceJob &job) {
+    // The only copies left are those of runJob() into and out of the tensor arena
+    stats.bytesCopied += job.job.bytesCopied;
+
+    for (auto &it : job.job.output) {
+        it.clean();
+    }
+
+    stats.requests++;
+
+    if (job.rxBuffer != nullptr) {
+        rpmsg_release_rx_buffer(ept, job.rxBuffer);
+        job.rxBuffer = nullptr;
+    }
+}
+
+const RpmsgZeroCopy::Stats &RpmsgZeroCopy::getStats() const {
+    return stats;
+}
+
+void RpmsgZeroCopy::resetStats() {
+    stats = Stats();
+}
+
+} // namespace InferenceProcess
@@ -0,0 +1,42 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2023 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+
+/*
+ * Fake of the libmetal IO region, mapping one contiguous physical range.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef uint64_t metal_phys_addr_t;
+
+struct metal_io_region {
+    void *virt;
+    metal_phys_addr_t phys;
+    size_t size;
+};
+
+static inline void *metal_io_phys_to_virt(struct metal_io_region *io, metal_phys_addr_t phys) {
+    if (phys < io->phys || phys - io->phys >= io->size) {
+        return nullptr;
+    }
+
+    return static_cast<uint8_t *>(io->virt) + (phys - io->phys);
+}
@@ -0,0 +1,35 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2023 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+
+/*
+ * Fake of the rpmsg endpoint, counting the rx buffers held by the endpoint.
+ */
+
+struct rpmsg_endpoint {
+    int held;
+};
+
+static inline void rpmsg_hold_rx_buffer(struct rpmsg_endpoint *ept, void *) {
+    ept->held++;
+}
+
+static inline void rpmsg_release_rx_buffer(struct rpmsg_endpoint *ept, void *) {
+    ept->held--;
+}
@@ -0,0 +1,111 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2023 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+/*
+ * Check that RpmsgZeroCopy only wraps ranges inside the received payload and cache line aligned ranges of the shared
+ * memory carve-out.
+ */
+
+#include "rpmsg_zero_copy.hpp"
+
+#include <stdio.h>
+
+using namespace InferenceProcess;
+
+namespace {
+
+constexpr size_t LineSize    = RPMSG_ZERO_COPY_CACHE_LINE_SIZE;
+constexpr size_t BufferSize  = 512;
+constexpr size_t PayloadSize = 100;
+constexpr size_t ShmSize     = 4096;
+
+alignas(LineSize) uint8_t rxBuffer[BufferSize];
+alignas(LineSize) uint8_t shmBuffer[ShmSize];
+
+bool check(bool condition, const char *message) {
+    if (!condition) {
+        fprintf(stderr, "FAIL: %s\n", message);
+    }
+
+    return !condition;
+}
+
+bool testWrapBuffer() {
+    rpmsg_endpoint ept = {};
+    RpmsgZeroCopy zeroCopy(&ept);
+    RpmsgInferenceJob job;
+    uint8_t *payload = rxBuffer + LineSize;
+    DataPtr ptr;
+    bool failed = false;
+
+    failed |= check(zeroCopy.wrapBuffer(job, payload, 1, ptr), "wrapped without held rx buffer");
+
+    zeroCopy.hold(job, payload, PayloadSize);
+    failed |= check(ept.held == 1, "rx buffer not held");
+
+    failed |= check(!zeroCopy.wrapBuffer(job, payload, PayloadSize, ptr), "whole payload rejected");
+    failed |= check(ptr.data == payload && ptr.size == PayloadSize, "wrong range wrapped");
+    failed |= check(!zeroCopy.wrapBuffer(job, payload + PayloadSize - 1, 1, ptr), "last byte rejected");
+
+    // The rx buffer is larger than the payload, but the bytes after the payload were not received
+    failed |= check(zeroCopy.wrapBuffer(job, payload, PayloadSize + 1, ptr), "range past payload wrapped");
+    failed |= check(zeroCopy.wrapBuffer(job, payload + PayloadSize, 1, ptr), "byte after payload wrapped");
+    failed |= check(zeroCopy.wrapBuffer(job, payload - 1, 1, ptr), "byte before payload wrapped");
+
+    // Sizes and offsets overflowing the address space
+    failed |= check(zeroCopy.wrapBuffer(job, payload + 1, SIZE_MAX, ptr), "overflowing size wrapped");
+    failed |= check(zeroCopy.wrapBuffer(job, payload + 1, SIZE_MAX - 1, ptr), "wrapping size wrapped");
+
+    zeroCopy.complete(job);
+    failed |= check(ept.held == 0 && job.rxBuffer == nullptr, "rx buffer not released");
+
+    return failed;
+}
+
+bool testWrapShared() {
+    const metal_phys_addr_t pa = 0x80000000;
+    rpmsg_endpoint ept         = {};
+    metal_io_region shm        = {shmBuffer, pa, ShmSize};
+    RpmsgZeroCopy zeroCopy(&ept, &shm);
+    DataPtr ptr;
+    bool failed = false;
+
+    failed |= check(!zeroCopy.wrapShared(pa, ShmSize, ptr), "whole carve-out rejected");
+    failed |= check(!zeroCopy.wrapShared(pa + LineSize, 2 * LineSize, ptr), "aligned range rejected");
+    failed |= check(ptr.data == shmBuffer + LineSize && ptr.size == 2 * LineSize, "wrong range wrapped");
+
+    failed |= check(zeroCopy.wrapShared(pa + 1, LineSize, ptr), "unaligned start wrapped");
+    failed |= check(zeroCopy.wrapShared(pa, LineSize + 1, ptr), "unaligned size wrapped");
+    failed |= check(zeroCopy.wrapShared(pa + ShmSize - LineSize, 2 * LineSize, ptr), "range past carve-out wrapped");
+    failed |= check(zeroCopy.wrapShared(pa - LineSize, LineSize, ptr), "range before carve-out wrapped");
+
+    return failed;
+}
+
+} // namespace
+
+int main() {
+    bool failed = false;
+
+    failed |= testWrapBuffer();
+    failed |= testWrapShared();
+
+    printf("%s\n", failed ? "FAILED" : "PASSED");
+
+    return failed ? 1 : 0;
+}
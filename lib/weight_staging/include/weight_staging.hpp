@@ -0,0 +1,137 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2023 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef WEIGHT_STAGING_H
+#define WEIGHT_STAGING_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifndef WEIGHT_STAGING_MAX_OPERATORS
+#define WEIGHT_STAGING_MAX_OPERATORS 16
+#endif
+
+namespace WeightStaging {
+
+/**
+ * Copy engine used to stage weights. start() may return before the copy has completed, for example when the copy is
+ * done by a DMA, and wait() blocks until the last started copy has completed. The staged data must be visible to the
+ * NPU when wait() returns.
+ */
+class Copier {
+public:
+    virtual ~Copier() = default;
+
+    virtual void start(void *dst, const void *src, size_t size) = 0;
+    virtual void wait()                                         = 0;
+};
+
+/**
+ * Copier using memcpy. The copy is done synchronously by start(), followed by a data cache clean. It runs in the
+ * driver hook before the NPU starts, so it stages the weights but does not overlap the copy with NPU execution. Use
+ * TaskCopier, see weight_staging_task_copier.hpp, or a DMA copier for that.
+ */
+class MemcpyCopier : public Copier {
+public:
+    void start(void *dst, const void *src, size_t size) override;
+    void wait() override;
+};
+
+/**
+ * Weight buffer of one Ethos-U operator.
+ */
+struct WeightBuffer {
+    const void *data;
+    size_t size;
+};
+
+/**
+ * Stage the weights of the Ethos-U operators of a network into a small SRAM ring.
+ *
+ * The schedule lists the weight buffer of every Ethos-U custom operator in execution order, see getSchedule() in
+ * weight_staging_model.hpp. When operator k is about to start, begin() waits for its weights to be staged and starts
+ * copying the weights of operator k + 1, so that the copy overlaps with the execution of operator k. After the last
+ * operator the weights of the first operator are prefetched for the next inference. remap() then redirects the weight
+ * base address of the command stream to the staged copy.
+ *
+ * Weights are staged per custom operator, which is the granularity of the Vela partitioning. A buffer that does not
+ * fit in the ring is read from its original location.
+ */
+class Stager {
+public:
+    struct Stats {
+        uint32_t operators;
+        uint32_t staged;
+        uint32_t skipped;
+        uint64_t bytes;
+    };
+
+    Stager(void *ring, size_t ringSize, Copier &copier);
+
+    /**
+     * Set the schedule. The weights of the first operator are prefetched immediately.
+     */
+    bool setSchedule(const WeightBuffer *buffers, size_t count);
+
+    /**
+     * Called when the next Ethos-U operator is about to start. Returns the address of its weights.
+     */
+    const void *begin();
+
+    /**
+     * Remap the command stream base address of the running operator. Region 0 holds the weights.
+     */
+    uint64_t remap(uint64_t address, int index) const;
+
+    /**
+     * Restart the schedule from the first operator, for example after an aborted inference.
+     */
+    void reset();
+
+    const Stats &getStats() const;
+
+    /**
+     * Stager used by the Ethos-U driver hooks of the weight_staging_hooks target.
+     */
+    static void setActive(Stager *stager);
+    static Stager *getActive();
+
+private:
+    struct Slot {
+        uint8_t *dst;
+        size_t size;
+    };
+
+    void prefetch(size_t index);
+
+    uint8_t *ring;
+    size_t ringSize;
+    Copier &copier;
+    WeightBuffer schedule[WEIGHT_STAGING_MAX_OPERATORS];
+    size_t count;
+    size_t current;
+    Slot running;
+    Slot staged;
+    size_t stagedIndex;
+    size_t runningIndex;
+    Stats stats;
+};
+
+} // namespace WeightStaging
+
+#endif
@@ -0,0 +1,81 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2023 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef WEIGHT_STAGING_MODEL_H
+#define WEIGHT_STAGING_MODEL_H
+
+#include "weight_staging.hpp"
+
+#include "inference_parser.hpp"
+
+#include <string.h>
+
+namespace WeightStaging {
+
+/**
+ * Build the schedule from the Ethos-U operators of the first subgraph, using the model descriptor built by
+ * InferenceParser::parseModelInfo(). Returns the number of Ethos-U operators, which may be larger than maxBuffers.
+ */
+template <size_t MaxSubGraphs, size_t MaxTensors, size_t MaxOperatorCodes>
+size_t getSchedule(const InferenceProcess::ModelInfo<MaxSubGraphs, MaxTensors, MaxOperatorCodes> &info,
+                   WeightBuffer *buffers,
+                   size_t maxBuffers) {
+    if (info.numSubGraphs == 0 || info.numEthosUOperators == 0) {
+        return 0;
+    }
+
+    const tflite::SubGraph *subgraph = info.model->subgraphs()->Get(0);
+    if (subgraph->operators() == nullptr) {
+        return 0;
+    }
+
+    size_t count = 0;
+
+    for (auto op : *subgraph->operators()) {
+        // The operator code indices have been range checked by parseModelInfo()
+        const InferenceProcess::OperatorInfo &opcode = info.operatorCodes[op->opcode_index()];
+
+        if (opcode.customCode == nullptr ||
+            strcmp(opcode.customCode, InferenceProcess::InferenceParser::EthosUCustomCode) != 0) {
+            continue;
+        }
+
+        // Input 0 is the command stream and input 1 the weights, addressed through region 0
+        WeightBuffer weights = {nullptr, 0};
+
+        if (op->inputs() != nullptr && op->inputs()->size() > 1 && op->inputs()->Get(1) >= 0) {
+            const InferenceProcess::TensorInfo *tensor = info.getTensor(0, op->inputs()->Get(1));
+
+            if (tensor != nullptr && tensor->data != nullptr) {
+                weights = {tensor->data, tensor->dataSize};
+            }
+        }
+
+        if (count < maxBuffers) {
+            buffers[count] = weights;
+        }
+
+        count++;
+    }
+
+    return count;
+}
+
+} // namespace WeightStaging
+
+#endif
@@ -0,0 +1,132 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2023 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "weight_staging.hpp"
+
+#include "FreeRTOS.h"
+#include "semphr.h"
+#include "task.h"
+
+#include <string.h>
+
+namespace WeightStaging {
+
+/**
+ * Asynchronous copier running the copies in a FreeRTOS task.
+ *
+ * start() hands the copy to the copy task and returns. The Ethos-U driver then starts the NPU and blocks the inference
+ * task until the operator has completed, and the copy task copies the weights of the next operator meanwhile. wait()
+ * blocks until the copy and the data cache clean have completed. The copy task must have a higher priority than the
+ * tasks that may run while the inference task waits for the NPU, or the copy is delayed by them.
+ *
+ * The copy is done by the CPU, and shares the memory bandwidth with the NPU. Platforms with a DMA implement a Copier
+ * starting the DMA in start() and waiting for its completion interrupt in wait() instead.
+ *
+ * The task stack, the task control block and the semaphore are members of the object when
+ * configSUPPORT_STATIC_ALLOCATION is enabled.
+ */
+template <size_t StackDepth = configMINIMAL_STACK_SIZE>
+class TaskCopier : public Copier {
+public:
+    TaskCopier() : task(nullptr), done(nullptr), dst(nullptr), src(nullptr), size(0), busy(false) {}
+
+    TaskCopier(const TaskCopier &)            = delete;
+    TaskCopier &operator=(const TaskCopier &) = delete;
+
+    /**
+     * Create the copy task. Nothing is left allocated on failure.
+     */
+    bool create(const char *name, UBaseType_t priority) {
+#if (configSUPPORT_STATIC_ALLOCATION == 1)
+        done = xSemaphoreCreateBinaryStatic(&doneBuffer);
+        task = xTaskCreateStatic(run, name, StackDepth, this, priority, stack, &taskBuffer);
+#else
+        done = xSemaphoreCreateBinary();
+        if (done != nullptr && xTaskCreate(run, name, StackDepth, this, priority, &task) != pdPASS) {
+            vSemaphoreDelete(done);
+            done = nullptr;
+            task = nullptr;
+        }
+#endif
+
+        return done == nullptr || task == nullptr;
+    }
+
+    /**
+     * Start a copy. Copies are run synchronously until the copy task has been created.
+     */
+    void start(void *_dst, const void *_src, size_t _size) override {
+        wait();
+
+        if (task == nullptr) {
+            copy(_dst, _src, _size);
+            return;
+        }
+
+        dst  = _dst;
+        src  = _src;
+        size = _size;
+        busy = true;
+
+        xTaskNotifyGive(task);
+    }
+
+    void wait() override {
+        if (busy) {
+            (void)xSemaphoreTake(done, portMAX_DELAY);
+            busy = false;
+        }
+    }
+
+private:
+    static void copy(void *dst, const void *src, size_t size) {
+        memcpy(dst, src, size);
+
+#if defined(__DCACHE_PRESENT) && (__DCACHE_PRESENT == 1U)
+        SCB_CleanDCache_by_Addr(dst, size);
+#endif
+    }
+
+    static void run(void *param) {
+        TaskCopier *self = static_cast<TaskCopier *>(param);
+
+        while (true) {
+            (void)ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+            copy(self->dst, self->src, self->size);
+            (void)xSemaphoreGive(self->done);
+        }
+    }
+
+    TaskHandle_t task;
+    SemaphoreHandle_t done;
+    void *dst;
+    const void *src;
+    size_t size;
+    bool busy;
+
+#if (configSUPPORT_STATIC_ALLOCATION == 1)
+    StackType_t stack[StackDepth];
+    StaticTask_t taskBuffer;
+    StaticSemaphore_t doneBuffer;
+#endif
+};
+
+} // namespace WeightStaging
@@ -0,0 +1,206 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2023 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Simulate weight staging for a network of Ethos-U operators.
+ *
+ * Without staging the NPU streams the weights of every operator from flash, and an operator takes the longest of its
+ * compute time and its weight read time. With staging the Stager copies the weights of the next operator into the
+ * SRAM ring while the current operator runs, and the NPU reads the weights from SRAM. Time the NPU waits for a copy
+ * to complete is counted as stall, and the overlap is the part of the copy time hidden behind NPU execution.
+ */
+
+#include "weight_staging.hpp"
+
+#include <algorithm>
+#include <random>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace WeightStaging;
+
+namespace {
+
+struct Config {
+    size_t operators  = 8;
+    size_t minWeights = 16 * 1024;
+    size_t maxWeights = 128 * 1024;
+    double minCompute = 20000;
+    double maxCompute = 200000;
+    double flashBw    = 1.0;
+    double sramBw     = 8.0;
+    size_t ringSize   = 256 * 1024;
+    size_t inferences = 4;
+    unsigned int seed = 1;
+};
+
+struct Operator {
+    vector<uint8_t> weights;
+    double compute;
+};
+
+// Copier advancing a simulated clock, modelling an asynchronous copier such as TaskCopier or a DMA. Copies are
+// serialized and limited by the flash bandwidth, and do not take bandwidth from the NPU. With the synchronous
+// MemcpyCopier every copy is a stall instead.
+class SimCopier : public Copier {
+public:
+    SimCopier(double &_now, double _bandwidth) :
+        now(_now), bandwidth(_bandwidth), busyUntil(0), copyTime(0), stall(0) {}
+
+    void start(void *dst, const void *src, size_t size) override {
+        memcpy(dst, src, size);
+
+        const double begin = max(now, busyUntil);
+        busyUntil          = begin + size / bandwidth;
+        copyTime += size / bandwidth;
+    }
+
+    void wait() override {
+        if (busyUntil > now) {
+            stall += busyUntil - now;
+            now = busyUntil;
+        }
+    }
+
+    double &now;
+    double bandwidth;
+    double busyUntil;
+    double copyTime;
+    double stall;
+};
+
+void usage(const char *name) {
+    printf("Usage: %s [options]\n"
+           "  --operators N     Number of Ethos-U operators\n"
+           "  --weights MIN MAX Weight bytes per operator\n"
+           "  --compute MIN MAX NPU compute cycles per operator\n"
+           "  --flash-bw B      Flash bandwidth in bytes per cycle\n"
+           "  --sram-bw B       SRAM bandwidth in bytes per cycle\n"
+           "  --ring BYTES      Size of the SRAM ring\n"
+           "  --inferences N    Number of inferences\n"
+           "  --seed N          Random seed\n",
+           name);
+}
+
+bool parse(int argc, char *argv[], Config &cfg) {
+    for (int i = 1; i < argc; i++) {
+        const string arg  = argv[i];
+        const int missing = arg == "--weights" || arg == "--compute" ? 2 : 1;
+
+        if (arg == "--help" || i + missing >= argc) {
+            return true;
+        }
+
+        if (arg == "--operators") {
+            cfg.operators = strtoul(argv[++i], nullptr, 0);
+        } else if (arg == "--weights") {
+            cfg.minWeights = strtoul(argv[++i], nullptr, 0);
+            cfg.maxWeights = strtoul(argv[++i], nullptr, 0);
+        } else if (arg == "--compute") {
+            cfg.minCompute = strtod(argv[++i], nullptr);
+            cfg.maxCompute = strtod(argv[++i], nullptr);
+        } else if (arg == "--flash-bw") {
+            cfg.flashBw = strtod(argv[++i], nullptr);
+        } else if (arg == "--sram-bw") {
+            cfg.sramBw = strtod(argv[++i], nullptr);
+        } else if (arg == "--ring") {
+            cfg.ringSize = strtoul(argv[++i], nullptr, 0);
+        } else if (arg == "--inferences") {
+            cfg.inferences = strtoul(argv[++i], nullptr, 0);
+        } else if (arg == "--seed") {
+            cfg.seed = strtoul(argv[++i], nullptr, 0);
+        } else {
+            return true;
+        }
+    }
+
+    return cfg.operators == 0 || cfg.operators > WEIGHT_STAGING_MAX_OPERATORS || cfg.minWeights > cfg.maxWeights ||
+           cfg.minCompute > cfg.maxCompute || cfg.flashBw <= 0 || cfg.sramBw <= 0;
+}
+} // namespace
+
+int main(int argc, char *argv[]) {
+    Config cfg;
+    if (parse(argc, argv, cfg)) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    mt19937 rng(cfg.seed);
+    uniform_int_distribution<size_t> weightDist(cfg.minWeights, cfg.maxWeights);
+    uniform_real_distribution<double> computeDist(cfg.minCompute, cfg.maxCompute);
+
+    vector<Operator> ops(cfg.operators);
+    vector<WeightBuffer> schedule;
+    for (auto &op : ops) {
+        op.weights.resize(weightDist(rng));
+        op.compute = computeDist(rng);
+        schedule.push_back({op.weights.data(), op.weights.size()});
+    }
+
+    // Baseline, the NPU streams the weights from flash
+    double baseline = 0;
+    for (auto &op : ops) {
+        baseline += max(op.compute, op.weights.size() / cfg.flashBw);
+    }
+    baseline *= cfg.inferences;
+
+    // Staged, the weights of the next operator are copied while the current operator runs
+    double now = 0;
+    vector<uint8_t> ring(cfg.ringSize);
+    SimCopier copier(now, cfg.flashBw);
+    Stager stager(ring.data(), ring.size(), copier);
+
+    stager.setSchedule(schedule.data(), schedule.size());
+
+    for (size_t i = 0; i < cfg.inferences; i++) {
+        for (auto &op : ops) {
+            const void *weights = stager.begin();
+
+            if (weights != op.weights.data()) {
+                if (memcmp(weights, op.weights.data(), op.weights.size()) != 0) {
+                    printf("Staged weights do not match\n");
+                    return 1;
+                }
+
+                now += max(op.compute, op.weights.size() / cfg.sramBw);
+            } else {
+                now += max(op.compute, op.weights.size() / cfg.flashBw);
+            }
+        }
+    }
+
+    const Stager::Stats &stats = stager.getStats();
+    const double overlap       = copier.copyTime > 0 ? 1.0 - copier.stall / copier.copyTime : 0;
+
+    printf("Operators:  %zu, inferences=%zu, ring=%zu bytes\n", cfg.operators, cfg.inferences, cfg.ringSize);
+    printf("Staging:    staged=%u, skipped=%u, bytes=%llu\n",
+           stats.staged,
+           stats.skipped,
+           static_cast<unsigned long long>(stats.bytes));
+    printf("Baseline:   %.0f cycles\n", baseline);
+    printf("Staged:     %.0f cycles, stall=%.0f cycles\n", now, copier.stall);
+    printf("Speedup:    %.2fx\n", baseline / now);
+    printf("Overlap:    %.1f%% of %.0f copy cycles hidden\n", overlap * 100, copier.copyTime);
+
+    return 0;
+}
@@ -0,0 +1,165 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2023 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "weight_staging.hpp"
+
+#include "ethosu_log.h"
+
+#include <string.h>
+
+namespace WeightStaging {
+
+namespace {
+Stager *active = nullptr;
+}
+
+/****************************************************************************
+ * MemcpyCopier
+ ****************************************************************************/
+
+void MemcpyCopier::start(void *dst, const void *src, size_t size) {
+    memcpy(dst, src, size);
+
+#if defined(__DCACHE_PRESENT) && (__DCACHE_PRESENT == 1U)
+    SCB_CleanDCache_by_Addr(dst, size);
+#endif
+}
+
+void MemcpyCopier::wait() {}
+
+/****************************************************************************
+ * Stager
+ ****************************************************************************/
+
+Stager::Stager(void *_ring, size_t _ringSize, Copier &_copier) :
+    ring(static_cast<uint8_t *>(_ring)), ringSize(_ringSize), copier(_copier), schedule(), count(0), current(0),
+    running{nullptr, 0}, staged{nullptr, 0}, stagedIndex(0), runningIndex(0), stats() {}
+
+bool Stager::setSchedule(const WeightBuffer *buffers, size_t _count) {
+    if (_count > WEIGHT_STAGING_MAX_OPERATORS) {
+        LOG_ERR("Too many operators in weight staging schedule: count=%zu, max=%d",
+                _count,
+                WEIGHT_STAGING_MAX_OPERATORS);
+        return true;
+    }
+
+    copier.wait();
+
+    for (size_t i = 0; i < _count; i++) {
+        schedule[i] = buffers[i];
+    }
+
+    count = _count;
+    reset();
+
+    return false;
+}
+
+const void *Stager::begin() {
+    if (count == 0) {
+        return nullptr;
+    }
+
+    // Wait for the weights of this operator to be staged
+    copier.wait();
+
+    runningIndex = current;
+
+    if (staged.dst != nullptr && stagedIndex == current) {
+        running = staged;
+        stats.staged++;
+        stats.bytes += running.size;
+    } else {
+        running = {nullptr, 0};
+        stats.skipped++;
+    }
+
+    stats.operators++;
+
+    // Overlap staging of the next operator with the execution of this one
+    current = (current + 1) % count;
+    prefetch(current);
+
+    return running.dst != nullptr ? running.dst : schedule[runningIndex].data;
+}
+
+uint64_t Stager::remap(uint64_t address, int index) const {
+    if (index != 0 || running.dst == nullptr || address != reinterpret_cast<uintptr_t>(schedule[runningIndex].data)) {
+        return address;
+    }
+
+    return reinterpret_cast<uintptr_t>(running.dst);
+}
+
+void Stager::reset() {
+    copier.wait();
+
+    current = 0;
+    running = {nullptr, 0};
+    staged  = {nullptr, 0};
+
+    if (count > 0) {
+        prefetch(0);
+    }
+}
+
+void Stager::prefetch(size_t index) {
+    const WeightBuffer &buffer = schedule[index];
+
+    staged      = {nullptr, 0};
+    stagedIndex = index;
+
+    if (buffer.data == nullptr || buffer.size == 0 || buffer.size > ringSize) {
+        return;
+    }
+
+    // The weights are already in the ring, for example when the network has a single operator
+    if (running.dst != nullptr && schedule[runningIndex].data == buffer.data) {
+        staged = running;
+        return;
+    }
+
+    // Place the buffer after the running operator, or at the start of the ring if there is room before it
+    uint8_t *dst;
+    if (running.dst == nullptr) {
+        dst = ring;
+    } else if (running.dst + running.size + buffer.size <= ring + ringSize) {
+        dst = running.dst + running.size;
+    } else if (ring + buffer.size <= running.dst) {
+        dst = ring;
+    } else {
+        return;
+    }
+
+    copier.start(dst, buffer.data, buffer.size);
+    staged = {dst, buffer.size};
+}
+
+const Stager::Stats &Stager::getStats() const {
+    return stats;
+}
+
+void Stager::setActive(Stager *stager) {
+    active = stager;
+}
+
+Stager *Stager::getActive() {
+    return active;
+}
+
+} // namespace WeightStaging
@@ -0,0 +1,50 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2023 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Ethos-U driver hooks redirecting the weights of the running custom operator to the active stager. The hooks are
+ * called for every Ethos-U custom operator, so only one NPU may run a staged network at a time. The hooks are built
+ * by the weight_staging_hooks target. Applications that implement these hooks for other purposes link weight_staging
+ * only and call the stager from their own hooks.
+ */
+
+#include "weight_staging.hpp"
+
+#include <ethosu_driver.h>
+
+extern "C" {
+
+void ethosu_inference_begin(struct ethosu_driver *drv, void *user_arg) {
+    (void)drv;
+    (void)user_arg;
+
+    WeightStaging::Stager *stager = WeightStaging::Stager::getActive();
+    if (stager != nullptr) {
+        stager->begin();
+    }
+}
+
+uint64_t ethosu_address_remap(uint64_t address, int index) {
+    const WeightStaging::Stager *stager = WeightStaging::Stager::getActive();
+    if (stager == nullptr) {
+        return address;
+    }
+
+    return stager->remap(address, index);
+}
+}
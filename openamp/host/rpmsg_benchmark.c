@@ -0,0 +1,233 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2023 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * @file	rpmsg_benchmark.c
+ * @brief	rpmsg throughput and latency between a host and a remote thread.
+ *
+ * The host keeps a window of messages in flight to the remote, which
+ * echoes every message from its endpoint callback. Latency is the round
+ * trip time of a message. With a window of one the round trips do not
+ * overlap. Messages are sent either by copy with rpmsg_send() or in
+ * place with rpmsg_send_nocopy().
+ *
+ * The window is at most half the vring size, so that the echo of the
+ * remote never waits for a buffer. Both callbacks run on the interrupt
+ * thread, which must not block.
+ */
+
+#include "virtio_loopback.h"
+
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+struct config {
+	unsigned int messages;
+	unsigned int size;
+	unsigned int window;
+	int nocopy;
+};
+
+static uint64_t *sent;
+static uint64_t *latency;
+static unsigned int received;
+
+static uint64_t now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+static int remote_cb(struct rpmsg_endpoint *ept, void *data, size_t len,
+		     uint32_t src, void *priv)
+{
+	(void)src;
+	(void)priv;
+
+	if (rpmsg_trysend(ept, data, (int)len) < 0)
+		printf("Remote failed to echo message\n");
+
+	return RPMSG_SUCCESS;
+}
+
+static int host_cb(struct rpmsg_endpoint *ept, void *data, size_t len,
+		   uint32_t src, void *priv)
+{
+	uint32_t seq;
+
+	(void)ept;
+	(void)src;
+	(void)priv;
+
+	if (len < sizeof(seq))
+		return RPMSG_SUCCESS;
+
+	memcpy(&seq, data, sizeof(seq));
+	latency[seq] = now_ns() - sent[seq];
+	__atomic_add_fetch(&received, 1, __ATOMIC_RELEASE);
+
+	return RPMSG_SUCCESS;
+}
+
+static int send_message(struct rpmsg_endpoint *ept, const struct config *cfg,
+			uint32_t seq)
+{
+	static uint8_t payload[RPMSG_BUFFER_SIZE];
+	uint32_t len;
+	void *buf;
+
+	memcpy(payload, &seq, sizeof(seq));
+	sent[seq] = now_ns();
+
+	if (!cfg->nocopy)
+		return rpmsg_send(ept, payload, (int)cfg->size);
+
+	buf = rpmsg_get_tx_payload_buffer(ept, &len, 1);
+	if (!buf)
+		return RPMSG_ERR_NO_BUFF;
+
+	memcpy(buf, &seq, sizeof(seq));
+	return rpmsg_send_nocopy(ept, buf, (int)cfg->size);
+}
+
+static int compare(const void *a, const void *b)
+{
+	const uint64_t x = *(const uint64_t *)a;
+	const uint64_t y = *(const uint64_t *)b;
+
+	return x < y ? -1 : x > y;
+}
+
+static void usage(const char *name)
+{
+	printf("Usage: %s [options]\n"
+	       "  --messages N   Number of messages\n"
+	       "  --size N       Payload size in bytes\n"
+	       "  --window N     Messages in flight, at most %u\n"
+	       "  --nocopy       Send with rpmsg_send_nocopy()\n",
+	       name, VIRTIO_LOOPBACK_VRING_NUM / 2);
+}
+
+static int parse(int argc, char *argv[], struct config *cfg)
+{
+	int i;
+
+	for (i = 1; i < argc; i++) {
+		if (!strcmp(argv[i], "--nocopy")) {
+			cfg->nocopy = 1;
+		} else if (i + 1 >= argc) {
+			return -1;
+		} else if (!strcmp(argv[i], "--messages")) {
+			cfg->messages = strtoul(argv[++i], NULL, 0);
+		} else if (!strcmp(argv[i], "--size")) {
+			cfg->size = strtoul(argv[++i], NULL, 0);
+		} else if (!strcmp(argv[i], "--window")) {
+			cfg->window = strtoul(argv[++i], NULL, 0);
+		} else {
+			return -1;
+		}
+	}
+
+	return cfg->messages == 0 || cfg->window == 0 ||
+	       cfg->window > VIRTIO_LOOPBACK_VRING_NUM / 2 ||
+	       cfg->size < sizeof(uint32_t) ? -1 : 0;
+}
+
+int main(int argc, char *argv[])
+{
+	struct config cfg = { 100000, 64, 1, 0 };
+	struct rpmsg_endpoint host_ept, remote_ept;
+	struct virtio_loopback lb;
+	uint64_t start, elapsed;
+	unsigned int i;
+	int ret;
+
+	if (parse(argc, argv, &cfg)) {
+		usage(argv[0]);
+		return 1;
+	}
+
+	sent = calloc(cfg.messages, sizeof(*sent));
+	latency = calloc(cfg.messages, sizeof(*latency));
+	if (!sent || !latency)
+		return 1;
+
+	ret = virtio_loopback_init(&lb, "/rpmsg_benchmark_shm",
+				   "/rpmsg_benchmark_irq");
+	if (ret) {
+		printf("Failed to initialize loopback: %d\n", ret);
+		return 1;
+	}
+
+	ret = rpmsg_create_ept(&remote_ept, virtio_loopback_remote(&lb),
+			       "rpmsg-benchmark", VIRTIO_LOOPBACK_REMOTE_ADDR,
+			       VIRTIO_LOOPBACK_HOST_ADDR, remote_cb, NULL);
+	if (!ret)
+		ret = rpmsg_create_ept(&host_ept, virtio_loopback_host(&lb),
+				       "rpmsg-benchmark",
+				       VIRTIO_LOOPBACK_HOST_ADDR,
+				       VIRTIO_LOOPBACK_REMOTE_ADDR, host_cb,
+				       NULL);
+	if (ret) {
+		printf("Failed to create endpoints: %d\n", ret);
+		virtio_loopback_deinit(&lb);
+		return 1;
+	}
+
+	if (cfg.size > (unsigned int)rpmsg_get_tx_payload_size(&host_ept)) {
+		printf("Payload larger than rpmsg buffer: size=%u, max=%d\n",
+		       cfg.size, rpmsg_get_tx_payload_size(&host_ept));
+		ret = -1;
+	}
+
+	start = now_ns();
+
+	for (i = 0; i < cfg.messages && ret >= 0; i++) {
+		/* Wait for room in the window */
+		while (i - __atomic_load_n(&received, __ATOMIC_ACQUIRE) >=
+		       cfg.window)
+			sched_yield();
+
+		ret = send_message(&host_ept, &cfg, i);
+	}
+
+	while (ret >= 0 &&
+	       __atomic_load_n(&received, __ATOMIC_ACQUIRE) < cfg.messages)
+		sched_yield();
+
+	elapsed = now_ns() - start;
+
+	rpmsg_destroy_ept(&host_ept);
+	rpmsg_destroy_ept(&remote_ept);
+	virtio_loopback_deinit(&lb);
+
+	if (ret < 0) {
+		printf("Failed to send message: %d\n", ret);
+		return 1;
+	}
+
+	qsort(latency, cfg.messages, sizeof(*latency), compare);
+
+	printf("messages=%u, size=%u, window=%u, send=%s\n", cfg.messages,
+	       cfg.size, cfg.window, cfg.nocopy ? "nocopy" : "copy");
+	printf("throughput: %.0f messages/s, %.2f MB/s\n",
+	       cfg.messages * 1e9 / elapsed,
+	       (double)cfg.messages * cfg.size * 1e3 / elapsed);
+	printf("round trip: p50=%.2f us, p99=%.2f us, max=%.2f us\n",
+	       latency[cfg.messages / 2] / 1e3,
+	       latency[(size_t)cfg.messages * 99 / 100] / 1e3,
+	       latency[cfg.messages - 1] / 1e3);
+
+	free(sent);
+	free(latency);
+
+	return 0;
+}
@@ -0,0 +1,103 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2023 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * @file	rpmsg_loopback.c
+ * @brief	rpmsg echo between a host and a remote thread.
+ *
+ * The host sends numbered messages to the remote, which echoes them back
+ * from its endpoint callback. The callbacks run on the interrupt thread,
+ * so the echo does not wait for a tx buffer.
+ */
+
+#include "virtio_loopback.h"
+
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static unsigned int received;
+
+static int remote_cb(struct rpmsg_endpoint *ept, void *data, size_t len,
+		     uint32_t src, void *priv)
+{
+	(void)src;
+	(void)priv;
+
+	if (rpmsg_trysend(ept, data, (int)len) < 0)
+		printf("Remote failed to echo message\n");
+
+	return RPMSG_SUCCESS;
+}
+
+static int host_cb(struct rpmsg_endpoint *ept, void *data, size_t len,
+		   uint32_t src, void *priv)
+{
+	(void)ept;
+	(void)src;
+	(void)priv;
+
+	printf("Host received: %.*s\n", (int)len, (const char *)data);
+	__atomic_add_fetch(&received, 1, __ATOMIC_RELEASE);
+
+	return RPMSG_SUCCESS;
+}
+
+int main(int argc, char *argv[])
+{
+	struct rpmsg_endpoint host_ept, remote_ept;
+	struct virtio_loopback lb;
+	unsigned int count = argc > 1 ? strtoul(argv[1], NULL, 0) : 10;
+	unsigned int i;
+	int ret;
+
+	ret = virtio_loopback_init(&lb, "/rpmsg_loopback_shm",
+				   "/rpmsg_loopback_irq");
+	if (ret) {
+		printf("Failed to initialize loopback: %d\n", ret);
+		return 1;
+	}
+
+	ret = rpmsg_create_ept(&remote_ept, virtio_loopback_remote(&lb),
+			       "rpmsg-loopback", VIRTIO_LOOPBACK_REMOTE_ADDR,
+			       VIRTIO_LOOPBACK_HOST_ADDR, remote_cb, NULL);
+	if (!ret)
+		ret = rpmsg_create_ept(&host_ept, virtio_loopback_host(&lb),
+				       "rpmsg-loopback",
+				       VIRTIO_LOOPBACK_HOST_ADDR,
+				       VIRTIO_LOOPBACK_REMOTE_ADDR, host_cb,
+				       NULL);
+	if (ret) {
+		printf("Failed to create endpoints: %d\n", ret);
+		virtio_loopback_deinit(&lb);
+		return 1;
+	}
+
+	for (i = 0; i < count && ret >= 0; i++) {
+		char msg[32];
+
+		snprintf(msg, sizeof(msg), "Hello %u", i);
+		ret = rpmsg_send(&host_ept, msg, (int)strlen(msg));
+
+		while (ret >= 0 &&
+		       __atomic_load_n(&received, __ATOMIC_ACQUIRE) <= i)
+			sched_yield();
+	}
+
+	rpmsg_destroy_ept(&host_ept);
+	rpmsg_destroy_ept(&remote_ept);
+	virtio_loopback_deinit(&lb);
+
+	if (ret < 0) {
+		printf("Failed to send message: %d\n", ret);
+		return 1;
+	}
+
+	printf("Echoed %u messages\n", count);
+
+	return 0;
+}
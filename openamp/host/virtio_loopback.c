@@ -0,0 +1,252 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2023 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * @file	virtio_loopback.c
+ * @brief	rpmsg over virtio between two threads on a Linux host.
+ */
+
+#include "virtio_loopback.h"
+
+#include <metal/sys.h>
+#include <metal/utilities.h>
+#include <openamp/virtio_ring.h>
+
+#include <errno.h>
+#include <string.h>
+#include <sys/mman.h>
+
+/* Vectors raised to notify each side */
+#define VIRTIO_LOOPBACK_HOST_VECTOR	0
+#define VIRTIO_LOOPBACK_REMOTE_VECTOR	1
+
+/* The interrupt thread of the linux machine delivers to one handler */
+static struct virtio_loopback *loopback;
+
+static struct virtio_loopback *virtio_loopback_get(struct virtio_device *vdev)
+{
+	return (struct virtio_loopback *)vdev->priv;
+}
+
+static uint8_t virtio_loopback_get_status(struct virtio_device *vdev)
+{
+	struct virtio_loopback *lb = virtio_loopback_get(vdev);
+
+	return __atomic_load_n(&lb->status, __ATOMIC_ACQUIRE);
+}
+
+static void virtio_loopback_set_status(struct virtio_device *vdev,
+				       uint8_t status)
+{
+	struct virtio_loopback *lb = virtio_loopback_get(vdev);
+
+	__atomic_store_n(&lb->status, status, __ATOMIC_RELEASE);
+}
+
+static uint32_t virtio_loopback_get_features(struct virtio_device *vdev)
+{
+	/* No name service, endpoints have fixed addresses */
+	metal_unused(vdev);
+	return 0;
+}
+
+static void virtio_loopback_set_features(struct virtio_device *vdev,
+					 uint32_t features)
+{
+	metal_unused(vdev);
+	metal_unused(features);
+}
+
+static void virtio_loopback_notify(struct virtqueue *vq)
+{
+	struct virtio_loopback *lb = virtio_loopback_get(vq->vq_dev);
+	const struct virtio_loopback_side *peer;
+
+	peer = vq->vq_dev == &lb->host.vdev ? &lb->remote : &lb->host;
+	sys_linux_irq_raise(lb->irq_name, peer->vector);
+}
+
+static const struct virtio_dispatch virtio_loopback_dispatch = {
+	.get_status = virtio_loopback_get_status,
+	.set_status = virtio_loopback_set_status,
+	.get_features = virtio_loopback_get_features,
+	.set_features = virtio_loopback_set_features,
+	.notify = virtio_loopback_notify,
+};
+
+static void virtio_loopback_isr(unsigned int vector)
+{
+	struct virtio_loopback_side *side;
+	unsigned int i;
+
+	if (!loopback)
+		return;
+
+	side = vector == loopback->host.vector ? &loopback->host :
+						 &loopback->remote;
+
+	for (i = 0; i < 2; i++)
+		virtqueue_notification(side->vrings[i].vq);
+}
+
+static size_t virtio_loopback_vring_area(void)
+{
+	size_t size = vring_size(VIRTIO_LOOPBACK_VRING_NUM,
+				 VIRTIO_LOOPBACK_VRING_ALIGN);
+
+	return metal_align_up(size, VIRTIO_LOOPBACK_VRING_ALIGN);
+}
+
+static void virtio_loopback_side_free(struct virtio_loopback_side *side)
+{
+	unsigned int i;
+
+	for (i = 0; i < 2; i++) {
+		if (side->vrings[i].vq)
+			virtqueue_free(side->vrings[i].vq);
+		side->vrings[i].vq = NULL;
+	}
+}
+
+static int virtio_loopback_side_init(struct virtio_loopback *lb,
+				     struct virtio_loopback_side *side,
+				     int role, unsigned int vector)
+{
+	const size_t area = virtio_loopback_vring_area();
+	unsigned int i;
+	int ret;
+
+	memset(side, 0, sizeof(*side));
+	side->vector = vector;
+	side->vdev.role = role;
+	side->vdev.func = &virtio_loopback_dispatch;
+	side->vdev.priv = lb;
+	side->vdev.vrings_num = 2;
+	side->vdev.vrings_info = side->vrings;
+
+	/* Both sides use the same vrings, each with its own virtqueues */
+	for (i = 0; i < 2; i++) {
+		side->vrings[i].vq = virtqueue_allocate(VIRTIO_LOOPBACK_VRING_NUM);
+		if (!side->vrings[i].vq) {
+			virtio_loopback_side_free(side);
+			return -ENOMEM;
+		}
+
+		side->vrings[i].io = &lb->shm_io;
+		side->vrings[i].notifyid = i;
+		side->vrings[i].info.vaddr = (uint8_t *)lb->shm + i * area;
+		side->vrings[i].info.align = VIRTIO_LOOPBACK_VRING_ALIGN;
+		side->vrings[i].info.num_descs = VIRTIO_LOOPBACK_VRING_NUM;
+	}
+
+	ret = rpmsg_init_vdev(&side->rvdev, &side->vdev, NULL, &lb->shm_io,
+			      role == RPMSG_HOST ? &lb->shpool : NULL);
+	if (ret)
+		virtio_loopback_side_free(side);
+
+	return ret;
+}
+
+static void virtio_loopback_side_deinit(struct virtio_loopback_side *side)
+{
+	rpmsg_deinit_vdev(&side->rvdev);
+	virtio_loopback_side_free(side);
+}
+
+int virtio_loopback_init(struct virtio_loopback *lb, const char *shm_name,
+			 const char *irq_name)
+{
+	struct metal_init_params params = METAL_INIT_DEFAULTS;
+	const size_t area = virtio_loopback_vring_area();
+	const size_t buffers = 2 * VIRTIO_LOOPBACK_VRING_NUM * RPMSG_BUFFER_SIZE;
+	int ret;
+
+	if (loopback)
+		return -EBUSY;
+
+	ret = metal_init(&params);
+	if (ret)
+		return ret;
+
+	memset(lb, 0, sizeof(*lb));
+	lb->shm_name = shm_name;
+	lb->irq_name = irq_name;
+	lb->shm_size = 2 * area + buffers;
+	lb->shm = sys_linux_shm_map(shm_name, lb->shm_size);
+	if (!lb->shm) {
+		ret = -errno;
+		goto err_metal;
+	}
+
+	/* Shared memory is mapped 1:1 */
+	lb->shm_pa = (metal_phys_addr_t)(uintptr_t)lb->shm;
+	metal_io_init(&lb->shm_io, lb->shm, &lb->shm_pa, lb->shm_size,
+		      (unsigned int)-1, 0, NULL);
+	rpmsg_virtio_init_shm_pool(&lb->shpool, (uint8_t *)lb->shm + 2 * area,
+				   buffers);
+
+	loopback = lb;
+	ret = sys_linux_irq_attach(irq_name, virtio_loopback_isr);
+	if (ret)
+		goto err_shm;
+
+	/*
+	 * The host clears the vrings and sets DRIVER_OK, which the remote
+	 * waits for. Kicks are only delivered once both sides exist.
+	 */
+	ret = virtio_loopback_side_init(lb, &lb->host, RPMSG_HOST,
+					VIRTIO_LOOPBACK_HOST_VECTOR);
+	if (ret)
+		goto err_irq;
+
+	ret = virtio_loopback_side_init(lb, &lb->remote, RPMSG_REMOTE,
+					VIRTIO_LOOPBACK_REMOTE_VECTOR);
+	if (ret)
+		goto err_host;
+
+	sys_irq_enable(VIRTIO_LOOPBACK_HOST_VECTOR);
+	sys_irq_enable(VIRTIO_LOOPBACK_REMOTE_VECTOR);
+
+	return 0;
+
+err_host:
+	virtio_loopback_side_deinit(&lb->host);
+err_irq:
+	sys_linux_irq_detach();
+err_shm:
+	loopback = NULL;
+	sys_linux_shm_unmap(lb->shm, lb->shm_size);
+	shm_unlink(shm_name);
+err_metal:
+	metal_finish();
+	return ret;
+}
+
+void virtio_loopback_deinit(struct virtio_loopback *lb)
+{
+	sys_irq_disable(VIRTIO_LOOPBACK_HOST_VECTOR);
+	sys_irq_disable(VIRTIO_LOOPBACK_REMOTE_VECTOR);
+	sys_linux_irq_detach();
+
+	virtio_loopback_side_deinit(&lb->remote);
+	virtio_loopback_side_deinit(&lb->host);
+
+	loopback = NULL;
+	sys_linux_shm_unmap(lb->shm, lb->shm_size);
+	shm_unlink(lb->shm_name);
+	shm_unlink(lb->irq_name);
+	metal_finish();
+}
+
+struct rpmsg_device *virtio_loopback_host(struct virtio_loopback *lb)
+{
+	return rpmsg_virtio_get_rpmsg_device(&lb->host.rvdev);
+}
+
+struct rpmsg_device *virtio_loopback_remote(struct virtio_loopback *lb)
+{
+	return rpmsg_virtio_get_rpmsg_device(&lb->remote.rvdev);
+}
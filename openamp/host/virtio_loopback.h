@@ -0,0 +1,84 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2023 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * @file	virtio_loopback.h
+ * @brief	rpmsg over virtio between two threads on a Linux host.
+ *
+ * Sets up a host (virtio driver) and a remote (virtio device) rpmsg
+ * device on the same vrings and buffers in POSIX shared memory. Kicks
+ * raise a vector on an interrupt line of the linux machine, which
+ * delivers it from the interrupt thread, like the mailbox interrupt of a
+ * heterogeneous SoC. The name service is not used, endpoints are bound
+ * to fixed addresses.
+ */
+
+#ifndef __VIRTIO_LOOPBACK__H__
+#define __VIRTIO_LOOPBACK__H__
+
+#include <metal/io.h>
+#include <openamp/rpmsg_virtio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Number of descriptors of each vring. */
+#define VIRTIO_LOOPBACK_VRING_NUM	32
+
+/** Alignment of the vrings. */
+#define VIRTIO_LOOPBACK_VRING_ALIGN	4096
+
+/** Endpoint addresses of the host and the remote. */
+#define VIRTIO_LOOPBACK_HOST_ADDR	0x400
+#define VIRTIO_LOOPBACK_REMOTE_ADDR	0x401
+
+struct virtio_loopback_side {
+	struct virtio_device vdev;
+	struct rpmsg_virtio_device rvdev;
+	struct virtio_vring_info vrings[2];
+	unsigned int vector;
+};
+
+struct virtio_loopback {
+	const char *shm_name;
+	const char *irq_name;
+	void *shm;
+	size_t shm_size;
+	metal_phys_addr_t shm_pa;
+	struct metal_io_region shm_io;
+	struct rpmsg_virtio_shm_pool shpool;
+	struct virtio_loopback_side host;
+	struct virtio_loopback_side remote;
+	uint8_t status;
+};
+
+/**
+ * @brief	Create the shared memory and both rpmsg devices.
+ * @param[in]	lb		Loopback to initialize.
+ * @param[in]	shm_name	Shared memory object name.
+ * @param[in]	irq_name	Interrupt line name.
+ * @return	0 on success, or negative error code.
+ */
+int virtio_loopback_init(struct virtio_loopback *lb, const char *shm_name,
+			 const char *irq_name);
+
+/**
+ * @brief	Tear down the rpmsg devices and the shared memory.
+ */
+void virtio_loopback_deinit(struct virtio_loopback *lb);
+
+/** @brief	rpmsg device of the host side. */
+struct rpmsg_device *virtio_loopback_host(struct virtio_loopback *lb);
+
+/** @brief	rpmsg device of the remote side. */
+struct rpmsg_device *virtio_loopback_remote(struct virtio_loopback *lb);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __VIRTIO_LOOPBACK__H__ */
@@ -0,0 +1,359 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2023 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * @file	cortexm/sys_cache.c
+ * @brief	cortex m batched cache maintenance implementation.
+ */
+
+#include <metal/sys.h>
+#include <metal/utilities.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "sys_cache.h"
+#include "sys_irq.h"
+
+#if (defined(__DCACHE_PRESENT) && (__DCACHE_PRESENT == 1U))
+
+#ifdef __DCACHE_LINE_SIZE
+#define CACHE_LINE_SIZE		__DCACHE_LINE_SIZE
+#else
+#define CACHE_LINE_SIZE		32U
+#endif
+
+struct range {
+	uintptr_t begin;
+	uintptr_t end;
+};
+
+/*
+ * The batch is only changed by the context that owns it and by interrupt
+ * handlers that preempt it, which issue it on an overlapping invalidate.
+ * Both access it with interrupts masked.
+ */
+static struct {
+	unsigned int threshold;
+	unsigned int depth;
+	uintptr_t owner;
+	unsigned int count;
+	struct range ranges[SYS_CACHE_BATCH_RANGES];
+	struct sys_cache_stats stats;
+} cache = { .threshold = SYS_CACHE_FULL_THRESHOLD };
+
+static void stats_add(const struct sys_cache_stats *delta)
+{
+	unsigned int flags = sys_irq_stats_lock();
+
+	cache.stats.ops += delta->ops;
+	cache.stats.full_ops += delta->full_ops;
+	cache.stats.requests += delta->requests;
+	cache.stats.bytes += delta->bytes;
+	cache.stats.cycles += delta->cycles;
+	sys_irq_stats_unlock(flags);
+}
+
+static void clean(uintptr_t begin, uintptr_t end,
+		  struct sys_cache_stats *delta)
+{
+	if (end - begin > cache.threshold) {
+		SCB_CleanDCache();
+		delta->full_ops++;
+	} else {
+		SCB_CleanDCache_by_Addr((void *)begin, (int32_t)(end - begin));
+		delta->ops++;
+		delta->bytes += end - begin;
+	}
+}
+
+/* Cleans are issued outside of the critical section */
+static void batch_issue(struct sys_cache_stats *delta)
+{
+	struct range ranges[SYS_CACHE_BATCH_RANGES];
+	uintptr_t total = 0;
+	unsigned int flags;
+	unsigned int count;
+	unsigned int i;
+
+	flags = sys_irq_save_disable();
+	count = cache.count;
+	memcpy(ranges, cache.ranges, count * sizeof(ranges[0]));
+	cache.count = 0;
+	sys_irq_restore_enable(flags);
+
+	for (i = 0; i < count; i++)
+		total += ranges[i].end - ranges[i].begin;
+
+	if (total > cache.threshold) {
+		SCB_CleanDCache();
+		delta->full_ops++;
+	} else {
+		for (i = 0; i < count; i++)
+			clean(ranges[i].begin, ranges[i].end, delta);
+	}
+}
+
+static int batch_overlaps(uintptr_t begin, uintptr_t end)
+{
+	unsigned int flags = sys_irq_save_disable();
+	int overlaps = 0;
+	unsigned int i;
+
+	for (i = 0; i < cache.count && !overlaps; i++)
+		overlaps = begin < cache.ranges[i].end &&
+			   cache.ranges[i].begin < end;
+
+	sys_irq_restore_enable(flags);
+
+	return overlaps;
+}
+
+/* Returns 1 if the batch is full and must be issued first */
+static int batch_merge(uintptr_t begin, uintptr_t end)
+{
+	unsigned int flags = sys_irq_save_disable();
+	unsigned int i = 0;
+	int full;
+
+	/* Merge with all overlapping or adjacent ranges */
+	while (i < cache.count) {
+		struct range *r = &cache.ranges[i];
+
+		if (begin <= r->end && r->begin <= end) {
+			begin = metal_min(begin, r->begin);
+			end = metal_max(end, r->end);
+			*r = cache.ranges[--cache.count];
+		} else {
+			i++;
+		}
+	}
+
+	full = cache.count == SYS_CACHE_BATCH_RANGES;
+	if (!full) {
+		cache.ranges[cache.count].begin = begin;
+		cache.ranges[cache.count].end = end;
+		cache.count++;
+	}
+
+	sys_irq_restore_enable(flags);
+
+	return full;
+}
+
+static void batch_add(uintptr_t begin, uintptr_t end,
+		      struct sys_cache_stats *delta)
+{
+	/* Only the owner adds, so the batch has room after it is issued */
+	while (batch_merge(begin, end))
+		batch_issue(delta);
+}
+
+static int batch_owned(void)
+{
+	return cache.depth > 0 && cache.owner == sys_context_id();
+}
+
+void sys_cache_set_threshold(unsigned int bytes)
+{
+	cache.threshold = bytes;
+}
+
+void sys_cache_batch_begin(void)
+{
+	unsigned int flags = sys_irq_save_disable();
+
+	/* Operations of a context other than the owner are not batched */
+	if (cache.depth == 0)
+		cache.owner = sys_context_id();
+
+	if (cache.owner == sys_context_id())
+		cache.depth++;
+
+	sys_irq_restore_enable(flags);
+}
+
+void sys_cache_batch_end(void)
+{
+	unsigned int flags;
+
+	if (!batch_owned())
+		return;
+
+	/* Only the owner adds to the batch, so it stays empty once issued */
+	if (cache.depth == 1)
+		sys_cache_batch_sync();
+
+	flags = sys_irq_save_disable();
+	cache.depth--;
+	sys_irq_restore_enable(flags);
+}
+
+void sys_cache_batch_sync(void)
+{
+	struct sys_cache_stats delta = { 0 };
+	uint32_t start = sys_cycle_count();
+
+	batch_issue(&delta);
+	delta.cycles = sys_cycle_count() - start;
+	stats_add(&delta);
+}
+
+static int rproc_notify(struct remoteproc *rproc, uint32_t id)
+{
+	struct sys_cache_rproc *ctx =
+		metal_container_of(rproc->ops, struct sys_cache_rproc, ops);
+
+	/* Also issues the batch of another context, which is harmless */
+	sys_cache_batch_sync();
+
+	return ctx->wrapped->notify(rproc, id);
+}
+
+void sys_cache_rproc_init(struct remoteproc *rproc,
+			  struct sys_cache_rproc *ctx)
+{
+	ctx->ops = *rproc->ops;
+	ctx->wrapped = rproc->ops;
+
+	if (ctx->ops.notify != NULL)
+		ctx->ops.notify = rproc_notify;
+
+	rproc->ops = &ctx->ops;
+}
+
+int sys_cache_rproc_notified(struct remoteproc *rproc, uint32_t notifyid)
+{
+	int batched = rproc->ops->notify == rproc_notify;
+	int ret;
+
+	/* Without the wrapped notify, messages would be sent before their cleans */
+	if (batched)
+		sys_cache_batch_begin();
+
+	ret = remoteproc_get_notification(rproc, notifyid);
+
+	if (batched)
+		sys_cache_batch_end();
+
+	return ret;
+}
+
+void sys_cache_get_stats(struct sys_cache_stats *stats)
+{
+	unsigned int flags = sys_irq_stats_lock();
+
+	*stats = cache.stats;
+	sys_irq_stats_unlock(flags);
+}
+
+void sys_cache_reset_stats(void)
+{
+	unsigned int flags = sys_irq_stats_lock();
+
+	memset(&cache.stats, 0, sizeof(cache.stats));
+	sys_irq_stats_unlock(flags);
+}
+
+void metal_machine_cache_flush(void *addr, unsigned int len)
+{
+	struct sys_cache_stats delta = { .requests = 1 };
+	uint32_t start = sys_cycle_count();
+	uintptr_t begin = (uintptr_t)addr & ~(uintptr_t)(CACHE_LINE_SIZE - 1);
+	uintptr_t end = metal_align_up((uintptr_t)addr + len, CACHE_LINE_SIZE);
+
+	if (batch_owned())
+		batch_add(begin, end, &delta);
+	else
+		clean(begin, end, &delta);
+
+	delta.cycles = sys_cycle_count() - start;
+	stats_add(&delta);
+}
+
+void metal_machine_cache_invalidate(void *addr, unsigned int len)
+{
+	struct sys_cache_stats delta = { .requests = 1 };
+	uint32_t start = sys_cycle_count();
+	uintptr_t begin = (uintptr_t)addr & ~(uintptr_t)(CACHE_LINE_SIZE - 1);
+	uintptr_t end = metal_align_up((uintptr_t)addr + len, CACHE_LINE_SIZE);
+
+	/*
+	 * Pending cleans must reach memory before the lines are discarded,
+	 * also when the batch belongs to a preempted context.
+	 */
+	if (batch_overlaps(begin, end))
+		batch_issue(&delta);
+
+	/*
+	 * Invalidation can not be deferred. Large ranges are cleaned and
+	 * invalidated as a whole, which never loses dirty data.
+	 */
+	if (end - begin > cache.threshold) {
+		SCB_CleanInvalidateDCache();
+		delta.full_ops++;
+	} else {
+		SCB_InvalidateDCache_by_Addr((void *)begin, (int32_t)(end - begin));
+		delta.ops++;
+		delta.bytes += end - begin;
+	}
+
+	delta.cycles = sys_cycle_count() - start;
+	stats_add(&delta);
+}
+
+#else
+
+void sys_cache_set_threshold(unsigned int bytes)
+{
+	metal_unused(bytes);
+}
+
+void sys_cache_batch_begin(void)
+{
+}
+
+void sys_cache_batch_end(void)
+{
+}
+
+void sys_cache_batch_sync(void)
+{
+}
+
+void sys_cache_rproc_init(struct remoteproc *rproc,
+			  struct sys_cache_rproc *ctx)
+{
+	metal_unused(rproc);
+	metal_unused(ctx);
+}
+
+int sys_cache_rproc_notified(struct remoteproc *rproc, uint32_t notifyid)
+{
+	return remoteproc_get_notification(rproc, notifyid);
+}
+
+void sys_cache_get_stats(struct sys_cache_stats *stats)
+{
+	memset(stats, 0, sizeof(*stats));
+}
+
+void sys_cache_reset_stats(void)
+{
+}
+
+void metal_machine_cache_flush(void *addr, unsigned int len)
+{
+	metal_unused(addr);
+	metal_unused(len);
+}
+
+void metal_machine_cache_invalidate(void *addr, unsigned int len)
+{
+	metal_unused(addr);
+	metal_unused(len);
+}
+
+#endif
@@ -0,0 +1,126 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2023 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * @file	cortexm/sys_cache.h
+ * @brief	cortex m batched cache maintenance for libmetal.
+ *
+ * Vring processing issues many small cache operations per message. Clean
+ * operations issued between sys_cache_batch_begin() and
+ * sys_cache_batch_end() are accumulated, merged on cache line
+ * granularity and issued in one pass when the batch ends. Operations
+ * larger than the threshold are replaced by a single operation on the
+ * full D-cache.
+ *
+ * sys_cache_rproc_notified() runs the kick handling of remoteproc in a
+ * batch. Messages sent from the endpoint callbacks notify the other side
+ * before the batch ends, so sys_cache_rproc_init() wraps the notify
+ * callback of the remoteproc ops to issue the batch before the doorbell
+ * is raised. Kicks of a remoteproc that has not been wrapped are handled
+ * without a batch.
+ *
+ * Only operations from the context that began the batch are deferred.
+ * Contexts are interrupt handlers and, with FreeRTOS, tasks. Operations
+ * from other contexts, including those preempting the owner, are issued
+ * immediately.
+ */
+
+#ifndef __METAL_CORTEXM_SYS_CACHE__H__
+#define __METAL_CORTEXM_SYS_CACHE__H__
+
+#include <stdint.h>
+
+#include <openamp/remoteproc.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Default size in bytes above which the full D-cache is maintained. */
+#ifndef SYS_CACHE_FULL_THRESHOLD
+#define SYS_CACHE_FULL_THRESHOLD	(16 * 1024)
+#endif
+
+/** Number of merged ranges a batch can hold before it is issued. */
+#ifndef SYS_CACHE_BATCH_RANGES
+#define SYS_CACHE_BATCH_RANGES		16
+#endif
+
+/** Remoteproc ops with a notify callback issuing the batch first. */
+struct sys_cache_rproc {
+	struct remoteproc_ops ops;
+	const struct remoteproc_ops *wrapped;
+};
+
+struct sys_cache_stats {
+	/** By address operations issued. */
+	uint32_t ops;
+	/** Full D-cache operations issued. */
+	uint32_t full_ops;
+	/** Calls to metal_machine_cache_flush and _invalidate. */
+	uint32_t requests;
+	/** Bytes maintained by address. */
+	uint64_t bytes;
+	/** CPU cycles spent in cache maintenance. */
+	uint64_t cycles;
+};
+
+/**
+ * @brief	Set the size above which the full D-cache is maintained.
+ */
+void sys_cache_set_threshold(unsigned int bytes);
+
+/**
+ * @brief	Start accumulating clean operations. Batches nest, the
+ *		operations are issued when the outermost batch ends.
+ */
+void sys_cache_batch_begin(void);
+
+/**
+ * @brief	Merge and issue all accumulated clean operations.
+ */
+void sys_cache_batch_end(void);
+
+/**
+ * @brief	Issue the accumulated clean operations without ending the
+ *		batch. Called by the notify callback of sys_cache_rproc_init().
+ */
+void sys_cache_batch_sync(void);
+
+/**
+ * @brief	Wrap the remoteproc ops, so that the accumulated clean
+ *		operations are issued before the other side is notified.
+ *		Call once after remoteproc_init().
+ * @param[in]	rproc		Remoteproc instance.
+ * @param[in]	ctx		Wrapped ops, must live as long as rproc.
+ */
+void sys_cache_rproc_init(struct remoteproc *rproc,
+			  struct sys_cache_rproc *ctx);
+
+/**
+ * @brief	Handle a kick with remoteproc_get_notification(), in a batch
+ *		if the remoteproc has been wrapped by sys_cache_rproc_init().
+ * @param[in]	rproc		Remoteproc instance.
+ * @param[in]	notifyid	Notification id of the kick.
+ * @return	Result of remoteproc_get_notification().
+ */
+int sys_cache_rproc_notified(struct remoteproc *rproc, uint32_t notifyid);
+
+/**
+ * @brief	Read the cache maintenance counters.
+ */
+void sys_cache_get_stats(struct sys_cache_stats *stats);
+
+/**
+ * @brief	Reset the cache maintenance counters.
+ */
+void sys_cache_reset_stats(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __METAL_CORTEXM_SYS_CACHE__H__ */
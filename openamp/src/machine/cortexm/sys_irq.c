@@ -0,0 +1,72 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2023 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * @file	cortexm/sys_irq.c
+ * @brief	cortex m critical section instrumentation implementation.
+ */
+
+#include <metal/sys.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "sys_irq.h"
+
+static struct {
+	unsigned int depth;
+	uint32_t start;
+	struct sys_irq_stats stats;
+} irq;
+
+/* libmetal has no machine init hook, so the cycle counter is started before main() */
+__attribute__((constructor)) static void sys_init(void)
+{
+#ifdef DWT
+#ifdef DCB
+	DCB->DEMCR |= DCB_DEMCR_TRCENA_Msk;
+#else
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+#endif
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#endif
+}
+
+void sys_irq_stats_enter(void)
+{
+	if (irq.depth++ == 0)
+		irq.start = sys_cycle_count();
+}
+
+void sys_irq_stats_exit(void)
+{
+	uint32_t cycles;
+
+	if (irq.depth == 0 || --irq.depth > 0)
+		return;
+
+	cycles = sys_cycle_count() - irq.start;
+
+	irq.stats.count++;
+	irq.stats.total_cycles += cycles;
+	if (cycles > irq.stats.max_cycles)
+		irq.stats.max_cycles = cycles;
+}
+
+void sys_irq_get_stats(struct sys_irq_stats *stats)
+{
+	unsigned int flags = sys_irq_stats_lock();
+
+	*stats = irq.stats;
+	sys_irq_stats_unlock(flags);
+}
+
+void sys_irq_reset_stats(void)
+{
+	unsigned int flags = sys_irq_stats_lock();
+
+	memset(&irq.stats, 0, sizeof(irq.stats));
+	sys_irq_stats_unlock(flags);
+}
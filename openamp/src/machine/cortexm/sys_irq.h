@@ -0,0 +1,124 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2023 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * @file	cortexm/sys_irq.h
+ * @brief	cortex m critical section instrumentation for libmetal.
+ */
+
+#ifndef __METAL_CORTEXM_SYS_IRQ__H__
+#define __METAL_CORTEXM_SYS_IRQ__H__
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct sys_irq_stats {
+	/** Outermost critical sections entered. */
+	uint32_t count;
+	/** Longest time spent inside a critical section, in CPU cycles. */
+	uint32_t max_cycles;
+	/** Total time spent inside critical sections, in CPU cycles. */
+	uint64_t total_cycles;
+};
+
+/**
+ * @brief	Read the critical section counters. Reading and resetting
+ *		the counters is not counted as a critical section.
+ */
+void sys_irq_get_stats(struct sys_irq_stats *stats);
+
+/**
+ * @brief	Reset the critical section counters.
+ */
+void sys_irq_reset_stats(void);
+
+#ifdef METAL_INTERNAL
+
+/*
+ * When SYS_IRQ_CEILING is defined, critical sections and the counter locks
+ * only mask interrupts with a priority value of SYS_IRQ_CEILING or higher
+ * using BASEPRI. Interrupts with a lower priority value, for example the
+ * NPU or a DMA, keep running and must not call into libmetal. Otherwise
+ * all interrupts are masked with PRIMASK. Architectures without BASEPRI
+ * always use PRIMASK.
+ */
+#if defined(SYS_IRQ_CEILING) &&                                            \
+	((defined(__ARM_ARCH_7M__) && (__ARM_ARCH_7M__ == 1)) ||            \
+	 (defined(__ARM_ARCH_7EM__) && (__ARM_ARCH_7EM__ == 1)) ||          \
+	 (defined(__ARM_ARCH_8M_MAIN__) && (__ARM_ARCH_8M_MAIN__ == 1)) ||  \
+	 (defined(__ARM_ARCH_8_1M_MAIN__) && (__ARM_ARCH_8_1M_MAIN__ == 1)))
+#define SYS_IRQ_USE_BASEPRI
+#define SYS_IRQ_BASEPRI	((SYS_IRQ_CEILING) << (8U - __NVIC_PRIO_BITS))
+#endif
+
+/* Raise the interrupt mask to the ceiling, returns the previous mask */
+static inline unsigned int sys_irq_mask(void)
+{
+	unsigned int flags;
+
+#ifdef SYS_IRQ_USE_BASEPRI
+	flags = __get_BASEPRI();
+	/* Only raises the mask, so nested sections keep the outer ceiling */
+	__set_BASEPRI_MAX(SYS_IRQ_BASEPRI);
+	__ISB();
+#else
+	flags = __get_PRIMASK();
+	__disable_irq();
+#endif
+
+	return flags;
+}
+
+static inline void sys_irq_unmask(unsigned int flags)
+{
+#ifdef SYS_IRQ_USE_BASEPRI
+	__set_BASEPRI(flags);
+#else
+	__set_PRIMASK(flags);
+#endif
+}
+
+/* CPU cycle counter, enabled at startup, or 0 if the DWT is not available */
+static inline uint32_t sys_cycle_count(void)
+{
+#ifdef DWT
+	return DWT->CYCCNT;
+#else
+	return 0;
+#endif
+}
+
+/*
+ * Identifies the running context: the exception number in handler mode,
+ * otherwise the running thread. Implemented by the system layer.
+ */
+uintptr_t sys_context_id(void);
+
+/* Must be called with interrupts masked, after entering and before leaving a critical section */
+void sys_irq_stats_enter(void);
+void sys_irq_stats_exit(void);
+
+/* Mask interrupts up to the ceiling without counting a critical section, for updating and reading counters */
+static inline unsigned int sys_irq_stats_lock(void)
+{
+	return sys_irq_mask();
+}
+
+static inline void sys_irq_stats_unlock(unsigned int flags)
+{
+	sys_irq_unmask(flags);
+}
+
+#endif /* METAL_INTERNAL */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __METAL_CORTEXM_SYS_IRQ__H__ */
@@ -14,18 +14,45 @@
 #include <metal/utilities.h>
 #include <stdint.h>
 
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "sys_irq.h"
+
+/*
+ * Critical sections follow taskENTER_CRITICAL_FROM_ISR semantics. They
+ * raise the interrupt mask to configMAX_SYSCALL_INTERRUPT_PRIORITY and
+ * return the previous mask, so they nest and can be used from both task
+ * and interrupt context. Interrupts above the syscall priority, for
+ * example the NPU or a DMA, are never masked.
+ */
 void sys_irq_restore_enable(unsigned int flags)
 {
-	metal_unused(flags);
-	/* we disable/enable all IRQs */
-	__enable_irq();
+	sys_irq_stats_exit();
+	taskEXIT_CRITICAL_FROM_ISR(flags);
 }
 
 unsigned int sys_irq_save_disable(void)
 {
-	/* we disable/enable all IRQs */
-	__disable_irq();
-	return 0;
+	unsigned int flags = taskENTER_CRITICAL_FROM_ISR();
+
+	sys_irq_stats_enter();
+
+	return flags;
+}
+
+/*
+ * Task handles are addresses, which never collide with the exception
+ * numbers of handler mode. Requires INCLUDE_xTaskGetCurrentTaskHandle.
+ */
+uintptr_t sys_context_id(void)
+{
+	uint32_t ipsr = __get_IPSR();
+
+	if (ipsr != 0)
+		return ipsr;
+
+	return (uintptr_t)xTaskGetCurrentTaskHandle();
 }
 
 void sys_irq_enable(unsigned int vector)
@@ -38,25 +65,10 @@ void sys_irq_disable(unsigned int vector)
 	NVIC_DisableIRQ(vector);
 }
 
-void metal_machine_cache_flush(void *addr, unsigned int len)
-{
-#if (defined(__DCACHE_PRESENT) && (__DCACHE_PRESENT == 1U))
-	SCB_CleanDCache_by_Addr(addr, len);
-#else
-	metal_unused(addr);
-	metal_unused(len);
-#endif
-}
-
-void metal_machine_cache_invalidate(void *addr, unsigned int len)
-{
-#if (defined(__DCACHE_PRESENT) && (__DCACHE_PRESENT == 1U))
-	SCB_InvalidateDCache_by_Addr(addr, len);
-#else
-	metal_unused(addr);
-	metal_unused(len);
-#endif
-}
+/*
+ * metal_machine_cache_flush() and metal_machine_cache_invalidate() are
+ * implemented in machine/cortexm/sys_cache.c.
+ */
 
 void *metal_machine_io_mem_map(void *va, metal_phys_addr_t pa,
 			       size_t size, unsigned int flags)
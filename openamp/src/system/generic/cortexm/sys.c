@@ -14,18 +14,28 @@
 #include <metal/utilities.h>
 #include <stdint.h>
 
+#include "sys_irq.h"
+
+/* The interrupt mask is set by SYS_IRQ_CEILING, see sys_irq.h */
 void sys_irq_restore_enable(unsigned int flags)
 {
-	metal_unused(flags);
-	/* we disable/enable all IRQs */
-	__enable_irq();
+	sys_irq_stats_exit();
+	sys_irq_unmask(flags);
 }
 
 unsigned int sys_irq_save_disable(void)
 {
-	/* we disable/enable all IRQs */
-	__disable_irq();
-	return 0;
+	unsigned int flags = sys_irq_mask();
+
+	sys_irq_stats_enter();
+
+	return flags;
+}
+
+/* Bare metal has a single thread, identified by exception number 0 */
+uintptr_t sys_context_id(void)
+{
+	return __get_IPSR();
 }
 
 void sys_irq_enable(unsigned int vector)
@@ -38,25 +48,10 @@ void sys_irq_disable(unsigned int vector)
 	NVIC_DisableIRQ(vector);
 }
 
-void metal_machine_cache_flush(void *addr, unsigned int len)
-{
-#if (defined(__DCACHE_PRESENT) && (__DCACHE_PRESENT == 1U))
-	SCB_CleanDCache_by_Addr(addr, len);
-#else
-	metal_unused(addr);
-	metal_unused(len);
-#endif
-}
-
-void metal_machine_cache_invalidate(void *addr, unsigned int len)
-{
-#if (defined(__DCACHE_PRESENT) && (__DCACHE_PRESENT == 1U))
-	SCB_InvalidateDCache_by_Addr(addr, len);
-#else
-	metal_unused(addr);
-	metal_unused(len);
-#endif
-}
+/*
+ * metal_machine_cache_flush() and metal_machine_cache_invalidate() are
+ * implemented in machine/cortexm/sys_cache.c.
+ */
 
 void *metal_machine_io_mem_map(void *va, metal_phys_addr_t pa,
 			       size_t size, unsigned int flags)
@@ -0,0 +1,364 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2023 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * @file	generic/linux/sys.c
+ * @brief	linux host system primitives implementation.
+ */
+
+#define _GNU_SOURCE
+
+#include <metal/io.h>
+#include <metal/sys.h>
+#include <metal/utilities.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+/*
+ * Interrupt line shared between threads or processes. The mutex and the
+ * condition are process shared, so the line can be placed in a POSIX
+ * shared memory object.
+ */
+struct sys_linux_irq_line {
+	pthread_mutex_t mutex;
+	pthread_cond_t cond;
+	uint32_t pending;
+	uint32_t state;
+};
+
+enum {
+	SYS_LINUX_IRQ_LINE_UNINITIALIZED = 0,
+	SYS_LINUX_IRQ_LINE_INITIALIZING,
+	SYS_LINUX_IRQ_LINE_READY,
+};
+
+/* Global interrupt mask, held while interrupts are disabled */
+static pthread_mutex_t irq_mask = PTHREAD_RECURSIVE_MUTEX_INITIALIZER_NP;
+static uint32_t irq_enabled;
+
+static struct {
+	struct sys_linux_irq_line *line;
+	void (*isr)(unsigned int vector);
+	pthread_t thread;
+	int running;
+} irq_ctx;
+
+/*
+ * Lines raised by this process, mapped on the first raise and kept
+ * mapped until sys_linux_irq_detach(). Entries are only appended while
+ * lines are in use, so raising looks them up without locking.
+ */
+static struct {
+	pthread_mutex_t lock;
+	unsigned int count;
+	struct {
+		char name[SYS_LINUX_IRQ_NAME_MAX];
+		struct sys_linux_irq_line *line;
+	} lines[SYS_LINUX_IRQ_LINES];
+} raise_ctx = {
+	.lock = PTHREAD_MUTEX_INITIALIZER,
+};
+
+void *sys_linux_shm_map(const char *name, size_t size)
+{
+	void *va;
+	int fd;
+
+	fd = shm_open(name, O_RDWR | O_CREAT, 0600);
+	if (fd < 0)
+		return NULL;
+
+	if (ftruncate(fd, (off_t)size) < 0) {
+		close(fd);
+		return NULL;
+	}
+
+	va = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	close(fd);
+
+	return va == MAP_FAILED ? NULL : va;
+}
+
+void sys_linux_shm_unmap(void *va, size_t size)
+{
+	munmap(va, size);
+}
+
+static struct sys_linux_irq_line *sys_linux_irq_line_map(const char *name)
+{
+	struct sys_linux_irq_line *line;
+	pthread_mutexattr_t mattr;
+	pthread_condattr_t cattr;
+	uint32_t expected;
+
+	line = sys_linux_shm_map(name, sizeof(*line));
+	if (!line)
+		return NULL;
+
+	/*
+	 * A new shared memory object is zero filled. The first user
+	 * initializes the line, everyone else waits until it is ready.
+	 */
+	expected = SYS_LINUX_IRQ_LINE_UNINITIALIZED;
+	if (!__atomic_compare_exchange_n(&line->state, &expected,
+					 SYS_LINUX_IRQ_LINE_INITIALIZING, 0,
+					 __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+		while (__atomic_load_n(&line->state, __ATOMIC_ACQUIRE) !=
+		       SYS_LINUX_IRQ_LINE_READY)
+			sched_yield();
+		return line;
+	}
+
+	pthread_mutexattr_init(&mattr);
+	pthread_mutexattr_setpshared(&mattr, PTHREAD_PROCESS_SHARED);
+	pthread_mutex_init(&line->mutex, &mattr);
+	pthread_mutexattr_destroy(&mattr);
+
+	pthread_condattr_init(&cattr);
+	pthread_condattr_setpshared(&cattr, PTHREAD_PROCESS_SHARED);
+	pthread_cond_init(&line->cond, &cattr);
+	pthread_condattr_destroy(&cattr);
+
+	__atomic_store_n(&line->state, SYS_LINUX_IRQ_LINE_READY,
+			 __ATOMIC_RELEASE);
+
+	return line;
+}
+
+static void *sys_linux_irq_thread(void *arg)
+{
+	struct sys_linux_irq_line *line = irq_ctx.line;
+	unsigned int vector;
+	uint32_t pending;
+
+	metal_unused(arg);
+
+	pthread_mutex_lock(&line->mutex);
+
+	while (irq_ctx.running) {
+		while (!line->pending && irq_ctx.running)
+			pthread_cond_wait(&line->cond, &line->mutex);
+
+		pending = line->pending;
+		line->pending = 0;
+		pthread_mutex_unlock(&line->mutex);
+
+		/* Deliver enabled vectors with interrupts disabled */
+		pthread_mutex_lock(&irq_mask);
+		for (vector = 0; vector < SYS_LINUX_IRQ_VECTORS; vector++) {
+			if ((pending & irq_enabled & (1u << vector)) &&
+			    irq_ctx.isr)
+				irq_ctx.isr(vector);
+		}
+		pthread_mutex_unlock(&irq_mask);
+
+		pthread_mutex_lock(&line->mutex);
+	}
+
+	pthread_mutex_unlock(&line->mutex);
+
+	return NULL;
+}
+
+int sys_linux_irq_attach(const char *name, void (*isr)(unsigned int vector))
+{
+	if (irq_ctx.running)
+		return -EBUSY;
+
+	irq_ctx.line = sys_linux_irq_line_map(name);
+	if (!irq_ctx.line)
+		return -errno;
+
+	irq_ctx.isr = isr;
+	irq_ctx.running = 1;
+
+	if (pthread_create(&irq_ctx.thread, NULL, sys_linux_irq_thread, NULL)) {
+		irq_ctx.running = 0;
+		sys_linux_shm_unmap(irq_ctx.line, sizeof(*irq_ctx.line));
+		return -EAGAIN;
+	}
+
+	return 0;
+}
+
+static void sys_linux_irq_unmap_raised(void)
+{
+	unsigned int i;
+
+	pthread_mutex_lock(&raise_ctx.lock);
+
+	for (i = 0; i < raise_ctx.count; i++) {
+		sys_linux_shm_unmap(raise_ctx.lines[i].line,
+				    sizeof(*raise_ctx.lines[i].line));
+		raise_ctx.lines[i].line = NULL;
+	}
+
+	__atomic_store_n(&raise_ctx.count, 0, __ATOMIC_RELEASE);
+
+	pthread_mutex_unlock(&raise_ctx.lock);
+}
+
+void sys_linux_irq_detach(void)
+{
+	sys_linux_irq_unmap_raised();
+
+	if (!irq_ctx.running)
+		return;
+
+	pthread_mutex_lock(&irq_ctx.line->mutex);
+	irq_ctx.running = 0;
+	pthread_cond_broadcast(&irq_ctx.line->cond);
+	pthread_mutex_unlock(&irq_ctx.line->mutex);
+
+	pthread_join(irq_ctx.thread, NULL);
+	sys_linux_shm_unmap(irq_ctx.line, sizeof(*irq_ctx.line));
+	irq_ctx.line = NULL;
+}
+
+static struct sys_linux_irq_line *sys_linux_irq_find(const char *name,
+						     unsigned int count)
+{
+	unsigned int i;
+
+	for (i = 0; i < count; i++) {
+		if (!strcmp(raise_ctx.lines[i].name, name))
+			return raise_ctx.lines[i].line;
+	}
+
+	return NULL;
+}
+
+/* Look up the mapping of a raised line, mapping it on the first raise */
+static struct sys_linux_irq_line *sys_linux_irq_get(const char *name)
+{
+	struct sys_linux_irq_line *line;
+	unsigned int count;
+
+	count = __atomic_load_n(&raise_ctx.count, __ATOMIC_ACQUIRE);
+	line = sys_linux_irq_find(name, count);
+	if (line)
+		return line;
+
+	if (strlen(name) >= SYS_LINUX_IRQ_NAME_MAX) {
+		errno = ENAMETOOLONG;
+		return NULL;
+	}
+
+	pthread_mutex_lock(&raise_ctx.lock);
+
+	/* Another thread may have mapped the line meanwhile */
+	line = sys_linux_irq_find(name, raise_ctx.count);
+	if (line)
+		goto out;
+
+	if (raise_ctx.count == SYS_LINUX_IRQ_LINES) {
+		errno = ENOSPC;
+		goto out;
+	}
+
+	line = sys_linux_irq_line_map(name);
+	if (!line)
+		goto out;
+
+	strcpy(raise_ctx.lines[raise_ctx.count].name, name);
+	raise_ctx.lines[raise_ctx.count].line = line;
+	__atomic_store_n(&raise_ctx.count, raise_ctx.count + 1,
+			 __ATOMIC_RELEASE);
+
+out:
+	pthread_mutex_unlock(&raise_ctx.lock);
+
+	return line;
+}
+
+int sys_linux_irq_raise(const char *name, unsigned int vector)
+{
+	struct sys_linux_irq_line *line;
+
+	if (vector >= SYS_LINUX_IRQ_VECTORS)
+		return -EINVAL;
+
+	line = sys_linux_irq_get(name);
+	if (!line)
+		return -errno;
+
+	pthread_mutex_lock(&line->mutex);
+	line->pending |= 1u << vector;
+	pthread_cond_signal(&line->cond);
+	pthread_mutex_unlock(&line->mutex);
+
+	return 0;
+}
+
+void sys_irq_restore_enable(unsigned int flags)
+{
+	metal_unused(flags);
+	pthread_mutex_unlock(&irq_mask);
+}
+
+unsigned int sys_irq_save_disable(void)
+{
+	/* The mask is recursive, so critical sections nest */
+	pthread_mutex_lock(&irq_mask);
+	return 0;
+}
+
+void sys_irq_enable(unsigned int vector)
+{
+	if (vector < SYS_LINUX_IRQ_VECTORS)
+		__atomic_fetch_or(&irq_enabled, 1u << vector, __ATOMIC_SEQ_CST);
+}
+
+void sys_irq_disable(unsigned int vector)
+{
+	if (vector < SYS_LINUX_IRQ_VECTORS)
+		__atomic_fetch_and(&irq_enabled, ~(1u << vector), __ATOMIC_SEQ_CST);
+}
+
+void metal_machine_cache_flush(void *addr, unsigned int len)
+{
+	/* Host memory is coherent between threads and processes */
+	metal_unused(addr);
+	metal_unused(len);
+}
+
+void metal_machine_cache_invalidate(void *addr, unsigned int len)
+{
+	metal_unused(addr);
+	metal_unused(len);
+}
+
+void *metal_machine_io_mem_map(void *va, metal_phys_addr_t pa,
+			       size_t size, unsigned int flags)
+{
+	metal_unused(pa);
+	metal_unused(size);
+	metal_unused(flags);
+
+	return va;
+}
+
+/*
+ * Replacements for libmetal generic/sys.c, which waits for interrupts
+ * with the Arm wfi instruction and is therefore not built for the host.
+ */
+void metal_sys_io_mem_map(struct metal_io_region *io)
+{
+	/* Shared memory is mapped 1:1 */
+	metal_unused(io);
+}
+
+void metal_generic_default_poll(void)
+{
+	sched_yield();
+}
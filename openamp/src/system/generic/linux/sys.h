@@ -0,0 +1,93 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2023 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * @file	generic/linux/sys.h
+ * @brief	linux host system primitives for libmetal.
+ *
+ * Emulates the interrupt controller and the shared memory of a
+ * heterogeneous SoC with pthreads and POSIX shared memory, so that two
+ * threads or two processes can exchange rpmsg messages on a Linux host.
+ */
+
+#ifndef __METAL_GENERIC_LINUX_SYS__H__
+#define __METAL_GENERIC_LINUX_SYS__H__
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Number of interrupt vectors per interrupt line. */
+#define SYS_LINUX_IRQ_VECTORS	32
+
+/** Number of interrupt lines a process may raise. */
+#ifndef SYS_LINUX_IRQ_LINES
+#define SYS_LINUX_IRQ_LINES	4
+#endif
+
+/** Size of an interrupt line name, including the terminator. */
+#define SYS_LINUX_IRQ_NAME_MAX	64
+
+/**
+ * @brief	Map a named POSIX shared memory object, creating it if needed.
+ * @param[in]	name	Shared memory object name, for example "/rpmsg_shm".
+ * @param[in]	size	Size in bytes.
+ * @return	Virtual address, or NULL on failure.
+ */
+void *sys_linux_shm_map(const char *name, size_t size);
+
+/**
+ * @brief	Unmap shared memory mapped with sys_linux_shm_map.
+ */
+void sys_linux_shm_unmap(void *va, size_t size);
+
+/**
+ * @brief	Attach to an interrupt line and start delivering interrupts.
+ *
+ * The line is a named shared memory object, so it can be raised from
+ * another thread or process. Raised vectors are delivered to the isr
+ * from a dedicated interrupt thread, with interrupts disabled, if the
+ * vector has been enabled with sys_irq_enable().
+ *
+ * @param[in]	name	Interrupt line name, for example "/rpmsg_irq0".
+ * @param[in]	isr	Interrupt service routine.
+ * @return	0 on success, or negative error code.
+ */
+int sys_linux_irq_attach(const char *name, void (*isr)(unsigned int vector));
+
+/**
+ * @brief	Stop the interrupt thread started by sys_linux_irq_attach,
+ *		and unmap the lines mapped by sys_linux_irq_raise.
+ *
+ * No thread of the process may raise a line meanwhile.
+ */
+void sys_linux_irq_detach(void);
+
+/**
+ * @brief	Raise a vector on a named interrupt line.
+ *
+ * The line is mapped on the first raise and stays mapped until
+ * sys_linux_irq_detach(), so a kick costs a lock and a signal.
+ *
+ * @return	0 on success, or negative error code.
+ */
+int sys_linux_irq_raise(const char *name, unsigned int vector);
+
+/*
+ * There is no interrupt controller driver on the host, so applications
+ * enable and disable the vectors of the line directly.
+ */
+void sys_irq_enable(unsigned int vector);
+
+void sys_irq_disable(unsigned int vector);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __METAL_GENERIC_LINUX_SYS__H__ */
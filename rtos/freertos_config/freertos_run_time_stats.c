@@ -0,0 +1,48 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2023 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Run time statistics counter based on the DWT cycle counter. The counter is 32 bits and wraps, so run time should be
+ * compared between samples taken less than one wrap period apart.
+ */
+
+#include "FreeRTOS.h"
+
+#if (configGENERATE_RUN_TIME_STATS == 1)
+
+void vConfigureTimerForRunTimeStats(void) {
+#ifdef DWT
+#ifdef DCB
+    DCB->DEMCR |= DCB_DEMCR_TRCENA_Msk;
+#else
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+#endif
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#endif
+}
+
+unsigned long ulGetRunTimeCounterValue(void) {
+#ifdef DWT
+    return DWT->CYCCNT;
+#else
+    return 0;
+#endif
+}
+
+#endif
@@ -0,0 +1,53 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2023 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Memory for the kernel owned tasks when configSUPPORT_STATIC_ALLOCATION is enabled. The definitions are weak so
+ * that applications may provide their own.
+ */
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#if (configSUPPORT_STATIC_ALLOCATION == 1)
+
+__attribute__((weak)) void vApplicationGetIdleTaskMemory(StaticTask_t **ppxIdleTaskTCBBuffer,
+                                                         StackType_t **ppxIdleTaskStackBuffer,
+                                                         uint32_t *pulIdleTaskStackSize) {
+    static StaticTask_t idleTaskTCB;
+    static StackType_t idleTaskStack[configMINIMAL_STACK_SIZE];
+
+    *ppxIdleTaskTCBBuffer   = &idleTaskTCB;
+    *ppxIdleTaskStackBuffer = idleTaskStack;
+    *pulIdleTaskStackSize   = configMINIMAL_STACK_SIZE;
+}
+
+#if (configUSE_TIMERS == 1)
+__attribute__((weak)) void vApplicationGetTimerTaskMemory(StaticTask_t **ppxTimerTaskTCBBuffer,
+                                                          StackType_t **ppxTimerTaskStackBuffer,
+                                                          uint32_t *pulTimerTaskStackSize) {
+    static StaticTask_t timerTaskTCB;
+    static StackType_t timerTaskStack[configTIMER_TASK_STACK_DEPTH];
+
+    *ppxTimerTaskTCBBuffer   = &timerTaskTCB;
+    *ppxTimerTaskStackBuffer = timerTaskStack;
+    *pulTimerTaskStackSize   = configTIMER_TASK_STACK_DEPTH;
+}
+#endif
+
+#endif